@@ -0,0 +1,81 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "adc_filter.h"
+
+void ADCFILTER_Init(struct ADCFilter *f, enum ADCFilterType type)
+{
+    memset(f, 0, sizeof(*f));
+    f->type = type;
+}
+
+static u16 median3(u16 a, u16 b, u16 c)
+{
+    if (a > b) {
+        u16 tmp = a;
+        a = b;
+        b = tmp;
+    }
+    // a <= b
+    if (c >= b)
+        return b;
+    return c > a ? c : a;
+}
+
+/* Called from the DMA interrupt when 'half' of the buffer has been written.
+ * samples points to the first sample of this channel in that half, and the
+ * channel is sampled every 'stride' entries */
+void ADCFILTER_Update(struct ADCFilter *f, unsigned half, const volatile u16 *samples,
+                      unsigned stride, unsigned count)
+{
+    u32 sum = 0;
+    for (unsigned i = 0; i < count; i++) {
+        sum += *samples;
+        samples += stride;
+    }
+    u16 mean = sum / count;
+    u8 first = f->count[0] + f->count[1] == 0;
+    f->sum[half] = sum;
+    f->count[half] = count;
+
+    switch (f->type) {
+    case ADC_FILTER_EXP:
+        if (first) {
+            f->exp = (u32)mean << ADC_FILTER_EXP_FRAC;
+        } else {
+            s32 delta = ((s32)mean << ADC_FILTER_EXP_FRAC) - (s32)f->exp;
+            f->exp += delta / (1 << ADC_FILTER_EXP_SHIFT);
+        }
+        f->value = (f->exp + (1 << (ADC_FILTER_EXP_FRAC - 1))) >> ADC_FILTER_EXP_FRAC;
+        break;
+    case ADC_FILTER_MEDIAN3:
+        if (first) {
+            f->hist[0] = f->hist[1] = f->hist[2] = mean;
+        } else {
+            f->hist[f->next] = mean;
+            f->next = f->next == 2 ? 0 : f->next + 1;
+        }
+        f->value = median3(f->hist[0], f->hist[1], f->hist[2]);
+        break;
+    default:
+        //Before the other half has been filled only this half is used
+        f->value = (f->sum[0] + f->sum[1]) / (f->count[0] + f->count[1]);
+        break;
+    }
+}
+
+#define TESTNAME adc_filter
+#include <tests.h>
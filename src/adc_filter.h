@@ -0,0 +1,37 @@
+#ifndef _ADC_FILTER_H_
+#define _ADC_FILTER_H_
+
+/* ADC input filtering
+ * The ADC DMA buffer is split in two halves.  Each time the DMA finishes a
+ * half, ADCFILTER_Update() reduces that half to a per-channel sum, so reading
+ * a filtered value costs the same regardless of the oversampling window.
+ */
+enum ADCFilterType {
+    ADC_FILTER_BOX,     // Average over the whole DMA buffer
+    ADC_FILTER_EXP,     // Exponential average of the half buffer means
+    ADC_FILTER_MEDIAN3, // Median of the last 3 half buffer means, rejects spikes
+};
+
+#define ADC_FILTER_EXP_SHIFT 2  //Weight of a new half buffer is 1/4
+#define ADC_FILTER_EXP_FRAC  4  //Fractional bits of the exponential average
+
+struct ADCFilter {
+    u32 sum[2];      // Sum of the samples in each half of the DMA buffer
+    u16 count[2];    // Number of samples in each half
+    u16 hist[3];     // Last 3 half buffer means for the median
+    u32 exp;         // Exponential average, ADC_FILTER_EXP_FRAC fractional bits
+    volatile u16 value;
+    u8 type;
+    u8 next;         // Next entry of hist to replace
+};
+
+void ADCFILTER_Init(struct ADCFilter *f, enum ADCFilterType type);
+void ADCFILTER_Update(struct ADCFilter *f, unsigned half, const volatile u16 *samples,
+                      unsigned stride, unsigned count);
+#define ADCFILTER_Value(f) ((f)->value)
+
+/* Selects the filter of an ADC input (1 based, as ADC_ReadRawInput).
+ * Implemented by ADC drivers that use ADCFILTER */
+void ADC_SetFilter(int channel, enum ADCFilterType type);
+
+#endif //_ADC_FILTER_H_
@@ -0,0 +1,75 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "config/model.h"
+
+/* Channel frame encoding shared by the serial and FrSky protocols
+ *   CHANFRAME_Scale:  Channels[] * num / den + center, using a multiplier
+ *                     from CHANFRAME_SCALE() in place of the divide.  The
+ *                     result is exact for |Channels[]| < 2^32 / den
+ *   CHANFRAME_PackLE: values of 'bits' width, LSB first (SBUS, CRSF, FrSky X)
+ *   CHANFRAME_PackBE: values of 'bits' width, MSB first (SUMD)
+ * The packers shift whole values into a 32bit accumulator and store bytes
+ * as they fill up, so any width up to 16 bits is handled */
+
+void CHANFRAME_Scale(u16 *out, unsigned count, u32 mult, s32 center)
+{
+    unsigned num_channels = Model.num_channels;
+    for (unsigned i = 0; i < count; i++) {
+        if (i < num_channels)
+            out[i] = CHANFRAME_ScaleValue(Channels[i], mult) + center;
+        else
+            out[i] = center;
+    }
+}
+
+void CHANFRAME_PackLE(u8 *out, const u16 *values, unsigned count, unsigned bits)
+{
+    u32 mask = (1 << bits) - 1;
+    u32 acc = 0;
+    unsigned used = 0;
+    for (unsigned i = 0; i < count; i++) {
+        acc |= (values[i] & mask) << used;
+        used += bits;
+        while (used >= 8) {
+            *out++ = acc;
+            acc >>= 8;
+            used -= 8;
+        }
+    }
+    if (used)
+        *out = acc;
+}
+
+void CHANFRAME_PackBE(u8 *out, const u16 *values, unsigned count, unsigned bits)
+{
+    u32 mask = (1 << bits) - 1;
+    u32 acc = 0;
+    unsigned used = 0;
+    for (unsigned i = 0; i < count; i++) {
+        acc = (acc << bits) | (values[i] & mask);
+        used += bits;
+        while (used >= 8) {
+            used -= 8;
+            *out++ = acc >> used;
+        }
+    }
+    if (used)
+        *out = acc << (8 - used);
+}
+
+#define TESTNAME chanframe
+#include <tests.h>
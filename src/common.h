@@ -12,6 +12,9 @@
 int ltassert();  // This function does not exist, and if called will throw an error during linking
 #define _UNUSED   __attribute__ ((unused))
 #define NO_INLINE __attribute__ ((noinline))
+// Keep the compiler from moving memory accesses across this point (e.g. to
+// finish writing data before publishing it to an interrupt)
+#define COMPILER_BARRIER() __asm__ volatile("" ::: "memory")
 
 #define TEMPSTRINGLENGTH 400 //This is the max dialog size (80 characters * 5 lines)
                              //We could reduce this to ~240 on the 128x64 screens
@@ -24,11 +27,28 @@ extern char tempstring[TEMPSTRINGLENGTH];
 typedef int8_t s8;
 typedef int16_t s16;
 typedef int32_t s32;
+typedef int64_t s64;
 typedef uint8_t u8;
 typedef uint16_t u16;
 typedef uint32_t u32;
 typedef uint64_t u64;
 
+/* Counts events from an interrupt for the main loop.  The interrupt only
+ * increments count and the main loop only writes seen, so no increment is
+ * lost if the interrupt fires while the main loop takes the new events */
+struct IsrCounter {
+    volatile u16 count;
+    u16 seen;
+};
+// Returns the number of events since the last call (main loop only)
+static inline u16 ISR_CounterTake(struct IsrCounter *c)
+{
+    u16 count = c->count;
+    u16 events = count - c->seen;
+    c->seen = count;
+    return events;
+}
+
 #include "target.h"
 #include "std.h"
 
@@ -48,7 +68,10 @@ extern const char DeviationVersion[33];
 #if !SUPPORT_MULTI_LANGUAGE
 #define _tr(x) x
 #else
-const char *_tr(const char *str);
+const char *_tr_str(const char *str);
+const char *_tr_const(const char *str);
+/* String literals never change, so their lookup is remembered by address */
+#define _tr(x) (__builtin_constant_p(x) ? _tr_const(x) : _tr_str(x))
 #endif
 
 void CONFIG_ReadLang(u8 idx);
@@ -57,6 +80,7 @@ int CONFIG_IniParse(const char* filename,
          int (*handler)(void*, const char*, const char*, const char*),
          void* user);
 u8 CONFIG_IsModelChanged();
+u8 CONFIG_ScanModelChanges();
 u8 CONFIG_SaveModelIfNeeded();
 void CONFIG_SaveTxIfNeeded();
 extern const char * const MODULE_NAME[TX_MODULE_LAST];
@@ -74,6 +98,7 @@ void LCD_GetCharDimensions(u32 c, u16 *width, u16 *height);
 u8 LCD_SetFont(unsigned int idx);
 u8  LCD_GetFont();
 void LCD_SetFontColor(u16 color);
+void FONT_Flush();
     /* Graphics */
 void LCD_DrawCircle(u16 x0, u16 y0, u16 r, u16 color);
 void LCD_FillCircle(u16 x0, u16 y0, u16 r, u16 color);
@@ -90,6 +115,7 @@ void LCD_DrawTriangle(u16 x0, u16 y0, u16 x1, u16 y1, u16 x2, u16 y2, u16 color)
 void LCD_FillTriangle(u16 x0, u16 y0, u16 x1, u16 y1, u16 x2, u16 y2, u16 color);
 void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h, u16 x_off, u16 y_off);
 void LCD_DrawImageFromFile(u16 x, u16 y, const char *file);
+u8 LCD_ReadWindowedImageFromFile(const char *file, u16 *buf, u16 w, u16 h, u16 x_off, u16 y_off);
 u8 LCD_ImageIsTransparent(const char *file);
 u8 LCD_ImageDimensions(const char *file, u16 *w, u16 *h);
 void LCD_DrawUSBLogo(int lcd_width, int lcd_height);
@@ -97,7 +123,8 @@ void LCD_DrawUSBLogo(int lcd_width, int lcd_height);
 /* Music */
 
 /* Mixer functions */
-void MIXER_CalcChannels();
+void MIXER_CalcChannels();      // From the mixer interrupt or a protocol callback
+void MIXER_RecalcChannels();    // From the main loop (e.g. after loading a model)
 
 /* GUI Pages */
 void PAGE_Init();
@@ -201,9 +228,31 @@ const char *INPUT_MapSourceName(unsigned idx, unsigned *val);
 const char *INPUT_ButtonName(unsigned src);
 void INPUT_CheckChanges(void);
 
+/* Input events, queued by the mixer and handled by INPUT_CheckChanges */
+enum InputEventType {
+    INPUT_EVENT_INCREASE,  // stick or knob moved up by more than the threshold
+    INPUT_EVENT_DECREASE,  // stick or knob moved down by more than the threshold
+    INPUT_EVENT_ON,        // switch position became active
+    INPUT_EVENT_OFF,       // switch position became inactive
+};
+struct InputEvent {
+    u8 input;    // mixer input (sticks are after the stick-mode mapping)
+    u8 type;
+    s16 value;
+};
+struct InputHandler {
+    u8 types;    // (1 << enum InputEventType) for each wanted event type
+    void (*callback)(const struct InputEvent *event, void *data);
+    void *data;
+    struct InputHandler *next;
+};
+void INPUT_QueueChanges(volatile s32 *raw);
+void INPUT_RegisterHandler(struct InputHandler *handler, unsigned types,
+                           void (*callback)(const struct InputEvent *event, void *data), void *data);
+void INPUT_UnregisterHandler(struct InputHandler *handler);
+
 /* Misc */
 void Delay(u32 count);
-u32 Crc(const void *buffer, u32 size);
 const char *utf8_to_u32(const char *str, u32 *ch);
 int exact_atoi(const char *str); //Like atoi but will not decode a number followed by non-number
 size_t strlcpy(char* dst, const char* src, size_t bufsize);
@@ -214,6 +263,30 @@ u32 rand32();  // LFSR based PRNG
 extern volatile u8 priority_ready;
 void debug_timing(u32 type, int startend); //This is only defined if TIMING_DEBUG is defined
 void DEBUGLOG_Putc(char c);
+
+/* CRC */
+void CRC_Init();
+u16 CRC16_Update(u16 crc, const u8 *data, unsigned len);
+u16 CRC16_UpdateBits(u16 crc, u8 data, unsigned bits);
+u16 CRC16_UpdateReflected(u16 crc, const u8 *data, unsigned len);
+u16 CRC16_UpdateFrSkyX(u16 crc, const u8 *data, unsigned len);
+u8 CRC8_Update(u8 crc, const u8 *data, unsigned len);
+u32 CRC32_Update(u32 crc, const u8 *data, unsigned len);
+u32 Crc(const void *buffer, u32 size);
+
+/* Channel frames */
+// Multiplier to compute value * num / den (num < den) with CHANFRAME_ScaleValue
+#define CHANFRAME_SCALE(num, den) ((u32)(((1ULL << 32) * (num) + (den) - 1) / (den)))
+// Same result as value * num / den (rounded toward 0) without a divide
+static inline s32 CHANFRAME_ScaleValue(s32 value, u32 mult)
+{
+    u32 mag = ((u64)(u32)(value < 0 ? -value : value) * mult) >> 32;
+    return value < 0 ? -(s32)mag : (s32)mag;
+}
+void CHANFRAME_Scale(u16 *out, unsigned count, u32 mult, s32 center);
+void CHANFRAME_PackLE(u8 *out, const u16 *values, unsigned count, unsigned bits);
+void CHANFRAME_PackBE(u8 *out, const u16 *values, unsigned count, unsigned bits);
+
 /* Battery */
 #define BATTERY_CRITICAL 0x01
 #define BATTERY_LOW      0x02
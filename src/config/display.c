@@ -16,6 +16,7 @@
 #include "common.h"
 #include "gui/gui.h"
 #include "display.h"
+#include "ini.h"
 #include <stdlib.h>
 #include <string.h>
 #define font_index(x) (&(x) - Display.font)
@@ -147,6 +148,7 @@ static int handle_label(struct LabelDesc *label, const char *name, const char *v
     return 0;
 }
 
+//The maps must be sorted for ini_find_key()
 struct struct_map {const char *str;  u16 offset;};
 #define MAPSIZE(x)  (sizeof(x) / sizeof(struct struct_map))
 #define OFFSET(s,v) (((long)(&s.v) - (long)(&s)) | ((sizeof(s.v)-1) << 13))
@@ -162,27 +164,27 @@ static const struct struct_map _secgeneral[] =
 };
 static const struct struct_map _secselect[] =
 {
-    {"width",                OFFSET(Display, select_width)},
     {COLOR,                  OFFSET_COL(Display, select_color)},
+    {"width",                OFFSET(Display, select_width)},
 };
 static const struct struct_map _seckeybd[] =
 {
-    {FONT,                   OFFSET_FON(Display.keyboard, font)},
+    {BG_COLOR,               OFFSET_COL(Display.keyboard, fill_color)},
     {"bg_key1",              OFFSET_COL(Display.keyboard, bg_key1)},
-    {"fg_key1",              OFFSET_COL(Display.keyboard, fg_key1)},
     {"bg_key2",              OFFSET_COL(Display.keyboard, bg_key2)},
-    {"fg_key2",              OFFSET_COL(Display.keyboard, fg_key2)},
     {"bg_key3",              OFFSET_COL(Display.keyboard, bg_key3)},
+    {"fg_key1",              OFFSET_COL(Display.keyboard, fg_key1)},
+    {"fg_key2",              OFFSET_COL(Display.keyboard, fg_key2)},
     {"fg_key3",              OFFSET_COL(Display.keyboard, fg_key3)},
-    {BG_COLOR,               OFFSET_COL(Display.keyboard, fill_color)},
+    {FONT,                   OFFSET_FON(Display.keyboard, font)},
 };
 static const struct struct_map _seclistbox[] =
 {
-    {FONT,                   OFFSET_FON(Display.listbox, font)},
     {BG_COLOR,               OFFSET_COL(Display.listbox, bg_color)},
-    {FG_COLOR,               OFFSET_COL(Display.listbox, fg_color)},
     {"bg_select",            OFFSET_COL(Display.listbox, bg_select)},
+    {FG_COLOR,               OFFSET_COL(Display.listbox, fg_color)},
     {"fg_select",            OFFSET_COL(Display.listbox, fg_select)},
+    {FONT,                   OFFSET_FON(Display.listbox, font)},
 };
 static const struct struct_map _secscroll[] =
 {
@@ -191,26 +193,26 @@ static const struct struct_map _secscroll[] =
 };
 static const struct struct_map _secxygraph[] =
 {
+    {XY_AXIS_COLOR,          OFFSET_COL(Display.xygraph, axis_color)},
     {BG_COLOR,               OFFSET_COL(Display.xygraph, bg_color)},
     {FG_COLOR,               OFFSET_COL(Display.xygraph, fg_color)},
-    {XY_AXIS_COLOR,          OFFSET_COL(Display.xygraph, axis_color)},
     {XY_GRID_COLOR,          OFFSET_COL(Display.xygraph, grid_color)},
-    {XY_POINT_COLOR,         OFFSET_COL(Display.xygraph, point_color)},
     {OUTLINE_COLOR,          OFFSET_COL(Display.xygraph, outline_color)},
+    {XY_POINT_COLOR,         OFFSET_COL(Display.xygraph, point_color)},
 };
 static const struct struct_map _secbargraph[] =
 {
     {BG_COLOR,               OFFSET_COL(Display.bargraph, bg_color)},
-    {FG_COLOR_POS,           OFFSET_COL(Display.bargraph, fg_color_pos)},
     {FG_COLOR_NEG,           OFFSET_COL(Display.bargraph, fg_color_neg)},
+    {FG_COLOR_POS,           OFFSET_COL(Display.bargraph, fg_color_pos)},
     {FG_COLOR_ZERO,          OFFSET_COL(Display.bargraph, fg_color_zero)},
     {OUTLINE_COLOR,          OFFSET_COL(Display.bargraph, outline_color)},
 };
 #if (LCD_WIDTH == 480) || (LCD_WIDTH == 320)
 static const struct struct_map _secbackground[] =
 {
-    {"drawn_background",     OFFSET(Display.background, drawn_background)},
     {"bg_color",             OFFSET_COL(Display.background, bg_color)},
+    {"drawn_background",     OFFSET(Display.background, drawn_background)},
     {"hd_color",             OFFSET_COL(Display.background, hd_color)},
 };
 #endif
@@ -223,24 +225,23 @@ static int ini_handler(void* user, const char* section, const char* name, const
 
     int assign_int(void* ptr, const struct struct_map *map, int map_size)
     {
-        for(int i = 0; i < map_size; i++) {
-            if(MATCH_KEY(map[i].str)) {
-                int size = map[i].offset >> 13;
-                int offset = map[i].offset & 0x1FFF;
-                switch(size) {
-                    case 0:
-                        *((u8 *)((long)ptr + offset)) = value_int; break;
-                    case 1:
-                        *((u16 *)((long)ptr + offset)) = value_int; break;
-                    case 2:
-                        *((u16 *)((long)ptr + offset)) = get_color(value); break;
-                    case 3:
-                        *((u32 *)((long)ptr + offset)) = value_int; break;
-                    case 6:
-                        *((u8 *)((long)ptr + offset)) = FONT_GetFromString(value);
-                }
-                return 1;
+        const struct struct_map *entry = ini_find_key(name, map, map_size, sizeof(struct struct_map));
+        if(entry) {
+            int size = entry->offset >> 13;
+            int offset = entry->offset & 0x1FFF;
+            switch(size) {
+                case 0:
+                    *((u8 *)((long)ptr + offset)) = value_int; break;
+                case 1:
+                    *((u16 *)((long)ptr + offset)) = value_int; break;
+                case 2:
+                    *((u16 *)((long)ptr + offset)) = get_color(value); break;
+                case 3:
+                    *((u32 *)((long)ptr + offset)) = value_int; break;
+                case 6:
+                    *((u8 *)((long)ptr + offset)) = FONT_GetFromString(value);
             }
+            return 1;
         }
         return 0;
     }
@@ -19,6 +19,8 @@ http://code.google.com/p/inih/
 
 extern int isspace(int c);
 
+static int section_changed;
+
 /* Strip whitespace chars off end of given string, in place. Return s. */
 static char* rstrip(char* s)
 {
@@ -68,6 +70,7 @@ int ini_parse_file(FILE* file,
     int error = 0;
     int done = 0;
 
+    section_changed = 1;
     /* Scan through file line by line */
     while (done != -1 && fgets(line, sizeof(line), file) != NULL) {
         lineno++;
@@ -100,6 +103,7 @@ int ini_parse_file(FILE* file,
                 *end = '\0';
                 strlcpy(section, start + 1, sizeof(section));
                 *prev_name = '\0';
+                section_changed = 1;
             }
             else if (!error) {
                 /* No ']' found on section line */
@@ -138,6 +142,34 @@ int ini_parse_file(FILE* file,
     return error;
 }
 
+/* See documentation in header file. */
+int ini_section_changed(void)
+{
+    int changed = section_changed;
+    section_changed = 0;
+    return changed;
+}
+
+/* See documentation in header file. */
+const void* ini_find_key(const char* key, const void* table, unsigned count,
+                         unsigned size)
+{
+    unsigned lo = 0;
+    unsigned hi = count;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        const char* entry = (const char*)table + mid * size;
+        int cmp = strcasecmp(key, *(const char* const*)entry);
+        if (cmp == 0)
+            return entry;
+        if (cmp < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return NULL;
+}
+
 /* See documentation in header file. */
 int ini_parse(const char* filename,
               int (*handler)(void*, const char*, const char*, const char*),
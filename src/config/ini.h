@@ -42,6 +42,17 @@ int ini_parse_file(FILE* file,
                                   const char* name, const char* value),
                    void* user);
 
+/* Returns nonzero on the first call after the parser has entered a new
+   section (or started a new file), so a handler can resolve the section name
+   once instead of on every name=value pair. */
+int ini_section_changed(void);
+
+/* Binary search for key in a table of count entries of the given size, each
+   starting with a 'const char *' name.  The table must be sorted by
+   strcasecmp() order.  Returns the matching entry or NULL. */
+const void* ini_find_key(const char* key, const void* table, unsigned count,
+                         unsigned size);
+
 /* Nonzero to allow multi-line value parsing, in the style of Python's
    ConfigParser. If allowed, ini_parse() will call the handler with the same
    name for each subsequent line parsed. */
@@ -46,6 +46,17 @@ static unsigned fix_crlf(char *str);
 
 #define MAX_LINE 300
 #define MAX_STRINGS 576
+#define NO_STRING 0xffff
+
+/* Version 3 language files are packed by utils/extract_strings.py -packed:
+ *   <language name>\n
+ *   u8 0, u8 3, u16 count
+ *   count * {u16 hash, u16 file offset}, sorted by hash
+ *   NUL terminated strings with '\n' and '\t' already decoded
+ * so the table is read as-is and a string is a single read */
+#define LANG_V3 3
+
+ctassert(((TR_CALLSITE_CACHE & (TR_CALLSITE_CACHE - 1)) == 0), tr_callsite_cache_not_power_of_2);
 
 #if !SUPPORT_DYNAMIC_LOCSTR
     static char strings[8192];
@@ -56,8 +67,24 @@ static unsigned fix_crlf(char *str);
     static u16 str_ptr = 0;
     static FATFS LangFAT;
     static FILE * fh;
+    static u8 lang_version;
+
+    /* Least recently used translations, so a label redrawn every frame is
+       only read from the file once.  Longer ones go through strcache */
+    static struct tr_string {
+        u16 idx;
+        u16 stamp;
+        char str[TR_STRING_LEN];
+    } lru[TR_STRING_CACHE];
+    static u16 lru_stamp;
 #endif
 
+/* Call sites passing a string literal are identified by its address */
+static struct tr_callsite {
+    const char *str;
+    u16 idx;
+} callsites[TR_CALLSITE_CACHE];
+
 /* tempstring[] must be at least long as line[], otherwise they are too small/big to fit in each other */
 #if MAX_LINE > TEMPSTRINGLENGTH
     #error "MAX_LINE > TEMPSTRINGLENGTH in language.c - CRITICAL - check length of tmpstring[] here and in common.h"
@@ -69,20 +96,67 @@ static struct str_map {
     u16 pos;
 } lookupmap[MAX_STRINGS];
 
-static const char* LoadString(u16 pos, const char *str)
+static void ResetCache()
+{
+    memset(callsites, 0, sizeof(callsites));
+#if SUPPORT_DYNAMIC_LOCSTR
+    for (int i = 0; i < TR_STRING_CACHE; i++) {
+        lru[i].idx = NO_STRING;
+        lru[i].stamp = 0;
+    }
+    lru_stamp = 0;
+#endif
+}
+
+#if SUPPORT_DYNAMIC_LOCSTR
+// Returns the slot holding idx, or the least recently used one
+static struct tr_string *CacheSlot(u16 idx)
+{
+    struct tr_string *slot = &lru[0];
+    if (++lru_stamp == 0) {
+        //Restart the ages instead of wrapping around
+        for (int i = 0; i < TR_STRING_CACHE; i++)
+            lru[i].stamp = 0;
+        lru_stamp = 1;
+    }
+    for (int i = 0; i < TR_STRING_CACHE; i++) {
+        if (lru[i].idx == idx)
+            return &lru[i];
+        if (lru[i].stamp < slot->stamp)
+            slot = &lru[i];
+    }
+    return slot;
+}
+#endif
+
+static const char* LoadString(u16 idx, const char *str)
 {
 #if !SUPPORT_DYNAMIC_LOCSTR
     (void)str;
-    return strings + pos;
+    return strings + lookupmap[idx].pos;
 #else
+    struct tr_string *slot = CacheSlot(idx);
+    slot->stamp = lru_stamp;
+    if (slot->idx == idx)
+        return slot->str;
+
     char *ret = &strcache[str_ptr];
     char buf[MAX_LINE];
-    fseek(fh, pos, SEEK_SET);
-    if (fgets(buf, MAX_LINE, fh) == NULL)
-        return str;
-
-    fix_crlf(buf);
+    fseek(fh, lookupmap[idx].pos, SEEK_SET);
+    if (lang_version == LANG_V3) {
+        unsigned len = fread(buf, 1, MAX_LINE - 1, fh);
+        buf[len] = '\0';
+    } else {
+        if (fgets(buf, MAX_LINE, fh) == NULL)
+            return str;
+        fix_crlf(buf);
+    }
     unsigned len = strlen(buf);
+    if (len < TR_STRING_LEN) {
+        slot->idx = idx;
+        memcpy(slot->str, buf, len + 1);
+        return slot->str;
+    }
     if (len + str_ptr >= MAX_STRING_BUFFER - 1)
     {
         str_ptr = 0;
@@ -96,29 +170,47 @@ static const char* LoadString(u16 pos, const char *str)
 #endif
 }
 
-const char *_tr(const char *str)
+static u16 FindString(u16 hash)
 {
-    u16 min, max, i;
+    unsigned min = 0;
+    unsigned max = table_size;
+    while (min < max)
+    {
+        unsigned i = (min + max) / 2;
+        if (hash == lookupmap[i].hash)
+            return i;
+        else if (hash > lookupmap[i].hash)
+            min = i + 1;
+        else
+            max = i;
+    }
+    return NO_STRING;
+}
 
+const char *_tr_str(const char *str)
+{
     if (table_size == 0) {
         return str;
     }
     u16 hash = fnv_16_str(str);
     dbg_printf("%d: %s\n", hash, str);
 
-    min = 0;
-    max = table_size;
-    while (min <= max)
-    {
-        i = (min + max) / 2;
-        if (hash == lookupmap[i].hash)
-            return LoadString(lookupmap[i].pos, str);
-        else if (hash > lookupmap[i].hash)
-            min = i + 1;
-        else
-            max = i - 1;
+    u16 idx = FindString(hash);
+    return idx == NO_STRING ? str : LoadString(idx, str);
+}
+
+const char *_tr_const(const char *str)
+{
+    if (table_size == 0) {
+        return str;
     }
-    return str;
+    uintptr_t addr = (uintptr_t)str;
+    struct tr_callsite *site = &callsites[(addr ^ (addr >> 7)) & (TR_CALLSITE_CACHE - 1)];
+    if (site->str != str) {
+        site->str = str;
+        site->idx = FindString(fnv_16_str(str));
+    }
+    return site->idx == NO_STRING ? str : LoadString(site->idx, str);
 }
 
 static unsigned fix_crlf(char *str)
@@ -245,13 +337,48 @@ static void ReadLangV2(FILE* fh)
     table_size = lookup - lookupmap;
 }
 
+static void ReadLangV3(FILE* fh)
+{
+    u8 hdr[4];
+    if (fread(hdr, 4, 1, fh) != 1)
+        return;
+    unsigned count = hdr[2] | (hdr[3] << 8);
+    if (count > MAX_STRINGS) {
+        //The table is sorted, so the entries which fit can still be found
+        printf("Only %d strings are supported\n", MAX_STRINGS);
+        if (fread(lookupmap, sizeof(struct str_map), MAX_STRINGS, fh) != MAX_STRINGS)
+            return;
+        fseek(fh, (count - MAX_STRINGS) * sizeof(struct str_map), SEEK_CUR);
+        count = MAX_STRINGS;
+    } else if (fread(lookupmap, sizeof(struct str_map), count, fh) != count) {
+        return;
+    }
+#if !SUPPORT_DYNAMIC_LOCSTR
+    unsigned start = ftell(fh);
+    unsigned len = fread(strings, 1, sizeof(strings), fh);
+    if (len == sizeof(strings) && fgetc(fh) != EOF) {
+        printf("Out of space reading strings\n");
+        return;
+    }
+    for (unsigned i = 0; i < count; i++) {
+        lookupmap[i].pos -= start;
+        if (lookupmap[i].pos >= len)
+            return;
+    }
+#endif
+    table_size = count;
+}
+
 static int ReadLang(const char *file)
 {
+    table_size = 0;
+    ResetCache();
 #if !SUPPORT_DYNAMIC_LOCSTR
     FILE *fh = fopen(file, "r");
 #else
     finit(&LangFAT, "language");
     fh = fopen2(&LangFAT, file, "r");
+    lang_version = 0;
 #endif
 
     if (! fh) {
@@ -262,20 +389,22 @@ static int ReadLang(const char *file)
     // first line of langauge name, ignore it
     fgets(tempstring, sizeof(tempstring), fh);
 
-    if (SUPPORT_LANG_V2) {
-        // Try to detect the version
-        if (fread(tempstring, 1, 1, fh) == 1)
-        {
-            // move file cursor 1 byte back
-            fseek(fh, -1, SEEK_CUR);
-            // check the value of the next character to detect version
-            if (tempstring[0] == ':')
-                ReadLangV1(fh);
-            else
-                ReadLangV2(fh);
+    // Try to detect the version
+    if (fread(tempstring, 1, 1, fh) == 1)
+    {
+        // move file cursor 1 byte back
+        fseek(fh, -1, SEEK_CUR);
+        // check the value of the next character to detect version
+        if (tempstring[0] == '\0') {
+#if SUPPORT_DYNAMIC_LOCSTR
+            lang_version = LANG_V3;
+#endif
+            ReadLangV3(fh);
+        } else if (SUPPORT_LANG_V2 && tempstring[0] != ':') {
+            ReadLangV2(fh);
+        } else {
+            ReadLangV1(fh);
         }
-    } else {
-        ReadLangV1(fh);
     }
 
     if (!SUPPORT_DYNAMIC_LOCSTR)
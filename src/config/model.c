@@ -19,14 +19,25 @@
 #include "tx.h"
 #include "music.h"
 #include "extended_audio.h"
+#include "ini.h"
 
 #include <stdlib.h>
 #include <string.h>
 extern const u8 EATRG0[PROTO_MAP_LEN];
 
 struct Model Model;
-/*set this to write all model data even if it is the same as the default */
-static u32 crc32;
+
+/* Change detection
+ * The model is split in MODEL_PAGE_SIZE byte pages, each with the crc it had
+ * when the model was last loaded or saved.  Pages found to be different are
+ * marked dirty, so a change is reported as soon as one changed page is seen
+ * and CONFIG_ScanModelChanges() can spread the check over several calls */
+#define MODEL_PAGE_SIZE  128
+#define MODEL_PAGES      ((sizeof(struct Model) + MODEL_PAGE_SIZE - 1) / MODEL_PAGE_SIZE)
+#define MODEL_SCAN_PAGES 4
+static u32 page_crc[MODEL_PAGES];
+static u32 dirty_pages[(MODEL_PAGES + 31) / 32];
+static u8 scan_page;
 
 const char * const MODEL_TYPE_VAL[MODELTYPE_LAST] = { "heli", "plane", "multi" };
 
@@ -246,6 +257,70 @@ static const char * const VOICE_TIMER[NUM_TIMERS] =
 
 #endif
 
+/* Sections are resolved to an id once when the parser enters them */
+enum {
+    SEC_NONE,
+    SEC_RADIO,
+    SEC_PROTO_OPTS,
+    SEC_MIXER,
+    SEC_CHANNEL,
+    SEC_VIRTCHAN,
+    SEC_TRIM,
+    SEC_SWASH,
+    SEC_TIMER,
+    SEC_TELEMALARM,
+    SEC_DATALOG,
+    SEC_SAFETY,
+    SEC_GUI,
+    SEC_PPMIN,
+    SEC_VOICE,
+    SEC_UNKNOWN,
+};
+struct section_map {const char *str; u8 id; u8 numbered;};
+//Must be sorted for ini_find_key()
+static const struct section_map _sections[] = {
+    {SECTION_CHANNEL,    SEC_CHANNEL, 1},
+#if HAS_DATALOG
+    {SECTION_DATALOG,    SEC_DATALOG, 0},
+#endif
+    {SECTION_MIXER,      SEC_MIXER, 1},
+    {SECTION_PPMIN,      SEC_PPMIN, 0},
+    {SECTION_PROTO_OPTS, SEC_PROTO_OPTS, 0},
+    {SECTION_RADIO,      SEC_RADIO, 0},
+    {SECTION_SAFETY,     SEC_SAFETY, 1},
+    {SECTION_SWASH,      SEC_SWASH, 0},
+    {SECTION_TELEMALARM, SEC_TELEMALARM, 1},
+    {SECTION_TIMER,      SEC_TIMER, 1},
+    {SECTION_TRIM,       SEC_TRIM, 1},
+    {SECTION_VIRTCHAN,   SEC_VIRTCHAN, 1},
+#if HAS_EXTENDED_AUDIO
+    {SECTION_VOICE,      SEC_VOICE, 0},
+#endif
+};
+
+static u8 find_section(const char *section)
+{
+    char base[16];
+    if (section[0] == '\0')
+        return SEC_NONE;
+    if (MATCH_START(section, "gui-"))
+        return SEC_GUI;
+    //Numbered sections are looked up without their index
+    unsigned len = strlen(section);
+    unsigned base_len = len;
+    while (base_len && section[base_len-1] >= '0' && section[base_len-1] <= '9')
+        base_len--;
+    if (base_len >= sizeof(base))
+        return SEC_UNKNOWN;
+    memcpy(base, section, base_len);
+    base[base_len] = '\0';
+    const struct section_map *sec = ini_find_key(base, _sections,
+        sizeof(_sections) / sizeof(struct section_map), sizeof(struct section_map));
+    if (! sec || (base_len != len && ! sec->numbered))
+        return SEC_UNKNOWN;
+    return sec->id;
+}
+
 
 s8 mapstrcasecmp(const char *s1, const char *s2)
 {
@@ -265,29 +340,93 @@ s8 mapstrcasecmp(const char *s1, const char *s2)
         return(s1[i] < s2[i] ? -1 : 1);
     }
 }
+
+/* Source names are found through a table of name hashes sorted by hash.
+ * The table is built on the stack by parse_ini() on the first lookup, while
+ * the language is disabled so it holds the untranslated names */
+struct SourceHash {u16 hash; u8 src;};
+#define SOURCE_INDEX_SIZE (NUM_SOURCES + 1)
+static struct SourceHash *source_index;
+static u8 source_index_built;
+
+// Hash that matches the case and '_' == ' ' folding of mapstrcasecmp()
+static u16 hash_name(const char *str)
+{
+    u16 hash = 0x811c;
+    for (; *str; str++) {
+        u8 c = *str;
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        else if (c == '_')
+            c = ' ';
+        hash = (hash ^ c) * 0x0193;
+    }
+    return hash;
+}
+
+static void build_source_index()
+{
+    char cmp[10];
+    for (unsigned i = 0; i < SOURCE_INDEX_SIZE; i++) {
+        struct SourceHash entry = {hash_name(INPUT_SourceNameReal(cmp, i)), i};
+        unsigned j = i;
+        for (; j > 0 && source_index[j-1].hash > entry.hash; j--)
+            source_index[j] = source_index[j-1];
+        source_index[j] = entry;
+    }
+    source_index_built = 1;
+}
+
+// Returns the source named 'name' or -1 if there is none
+static int find_source(const char *name)
+{
+    char cmp[10];
+    if (! source_index) {
+        for (unsigned i = 0; i <= NUM_SOURCES; i++) {
+            if(mapstrcasecmp(INPUT_SourceNameReal(cmp, i), name) == 0)
+                return i;
+        }
+        return -1;
+    }
+    if (! source_index_built)
+        build_source_index();
+    u16 hash = hash_name(name);
+    unsigned lo = 0, hi = SOURCE_INDEX_SIZE;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        if (source_index[mid].hash < hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (; lo < SOURCE_INDEX_SIZE && source_index[lo].hash == hash; lo++) {
+        unsigned src = source_index[lo].src;
+        if(mapstrcasecmp(INPUT_SourceNameReal(cmp, src), name) == 0)
+            return src;
+    }
+    return -1;
+}
+
 static u8 get_source(const char *section, const char *value)
 {
     unsigned i;
     unsigned val;
     const char *ptr = (value[0] == '!') ? value + 1 : value;
     const char *tmp;
-    char cmp[10];
-    for (i = 0; i <= NUM_SOURCES; i++) {
-        if(mapstrcasecmp(INPUT_SourceNameReal(cmp, i), ptr) == 0) {
-            #if defined(HAS_SWITCHES_NOSTOCK) && HAS_SWITCHES_NOSTOCK
-            #define SWITCH_NOSTOCK ((1 << INP_HOLD0) | (1 << INP_HOLD1) | \
-                                    (1 << INP_FMOD0) | (1 << INP_FMOD1))
-            if ((Transmitter.ignore_src & SWITCH_NOSTOCK) == SWITCH_NOSTOCK) {
-                if(mapstrcasecmp("FMODE0", ptr) == 0 ||
-                   mapstrcasecmp("FMODE1", ptr) == 0 ||
-                   mapstrcasecmp("HOLD0", ptr) == 0 ||
-                   mapstrcasecmp("HOLD1", ptr) == 0)
-                    break;
-            }
-            #endif //HAS_SWITCHES_NOSTOCK
-            return ((ptr == value) ? 0 : 0x80) | i;
-        }
-    }
+    int src = find_source(ptr);
+    #if defined(HAS_SWITCHES_NOSTOCK) && HAS_SWITCHES_NOSTOCK
+    #define SWITCH_NOSTOCK ((1 << INP_HOLD0) | (1 << INP_HOLD1) | \
+                            (1 << INP_FMOD0) | (1 << INP_FMOD1))
+    if (src >= 0 && (Transmitter.ignore_src & SWITCH_NOSTOCK) == SWITCH_NOSTOCK) {
+        if(mapstrcasecmp("FMODE0", ptr) == 0 ||
+           mapstrcasecmp("FMODE1", ptr) == 0 ||
+           mapstrcasecmp("HOLD0", ptr) == 0 ||
+           mapstrcasecmp("HOLD1", ptr) == 0)
+            src = -1;
+    }
+    #endif //HAS_SWITCHES_NOSTOCK
+    if (src >= 0)
+        return ((ptr == value) ? 0 : 0x80) | src;
     for (i = 0; i < 4; i++) {
         if(mapstrcasecmp(tx_stick_names[i], ptr) == 0) {
             return ((ptr == value) ? 0 : 0x80) | (i + 1);
@@ -566,6 +705,7 @@ static int layout_ini_handler(void* user, const char* section, const char* name,
     return 1;
 }
 
+//The maps must be sorted for ini_find_key()
 struct struct_map {const char *str;  u16 offset; u16 defval;};
 #define MAPSIZE(x)  (sizeof(x) / sizeof(struct struct_map))
 #define OFFSET(s,v) (((long)(&s.v) - (long)(&s)) | ((sizeof(s.v)-1) << 13))
@@ -579,49 +719,49 @@ static const struct struct_map _secnone[] =
 };
 #endif
 static const struct struct_map _secradio[] = {
-    {RADIO_NUM_CHANNELS, OFFSET(Model, num_channels), 0},
     {RADIO_FIXED_ID,     OFFSET(Model, fixed_id), 0},
+#if HAS_EXTENDED_TELEMETRY
+    {RADIO_GROUND_LEVEL,     OFFSET(Model, ground_level), 0},
+#endif
+    {RADIO_NUM_CHANNELS, OFFSET(Model, num_channels), 0},
 #if HAS_VIDEO
-    {RADIO_VIDEOSRC,     OFFSET_SRC(Model, videosrc), 0},
+    {RADIO_VIDEOBRIGHTNESS,OFFSET(Model, video_brightness), 0},
     {RADIO_VIDEOCH,      OFFSET(Model, videoch), 0},
     {RADIO_VIDEOCONTRAST,OFFSET(Model, video_contrast), 0},
-    {RADIO_VIDEOBRIGHTNESS,OFFSET(Model, video_brightness), 0},
-#endif
-#if HAS_EXTENDED_TELEMETRY
-    {RADIO_GROUND_LEVEL,     OFFSET(Model, ground_level), 0},
+    {RADIO_VIDEOSRC,     OFFSET_SRC(Model, videosrc), 0},
 #endif
 };
 static const struct struct_map _secmixer[] = {
-    {MIXER_SWITCH, OFFSET_SRC(Model.mixers[0], sw), 0},
-    {MIXER_SCALAR, OFFSETS(Model.mixers[0], scalar), 100},
     {MIXER_OFFSET, OFFSETS(Model.mixers[0], offset), 0},
+    {MIXER_SCALAR, OFFSETS(Model.mixers[0], scalar), 100},
+    {MIXER_SWITCH, OFFSET_SRC(Model.mixers[0], sw), 0},
 };
 static const struct struct_map _seclimit[] = {
+    {CHAN_DISPLAY_SCALE,   OFFSETS(Model.limits[0], displayscale), DEFAULT_DISPLAY_SCALE},
+    {CHAN_LIMIT_MAX,       OFFSET(Model.limits[0], max), DEFAULT_SERVO_LIMIT},
     {CHAN_LIMIT_SAFETYSW,  OFFSET_SRC(Model.limits[0], safetysw), 0},
     {CHAN_LIMIT_SAFETYVAL, OFFSETS(Model.limits[0], safetyval), 0},
-    {CHAN_LIMIT_MAX,       OFFSET(Model.limits[0], max), DEFAULT_SERVO_LIMIT},
-    {CHAN_LIMIT_SPEED,     OFFSET(Model.limits[0], speed), 0},
     {CHAN_SCALAR,          OFFSET(Model.limits[0], servoscale), 100},
     {CHAN_SCALAR_NEG,      OFFSET(Model.limits[0], servoscale_neg), 0},
+    {CHAN_LIMIT_SPEED,     OFFSET(Model.limits[0], speed), 0},
     {CHAN_SUBTRIM,         OFFSETS(Model.limits[0], subtrim), 0},
-    {CHAN_DISPLAY_SCALE,   OFFSETS(Model.limits[0], displayscale), DEFAULT_DISPLAY_SCALE},
 };
 static const struct struct_map _sectrim[] = {
-    {TRIM_SOURCE, OFFSET_SRC(Model.trims[0], src), 0xFFFF},
-    {TRIM_POS,    OFFSET_BUT(Model.trims[0], pos), 0},
     {TRIM_NEG,    OFFSET_BUT(Model.trims[0], neg), 0},
+    {TRIM_POS,    OFFSET_BUT(Model.trims[0], pos), 0},
+    {TRIM_SOURCE, OFFSET_SRC(Model.trims[0], src), 0xFFFF},
     {TRIM_STEP,   OFFSET(Model.trims[0], step), 1},
 };
 static const struct struct_map _secswash[] = {
     {SWASH_AILMIX, OFFSET(Model, swashmix[0]), 60},
-    {SWASH_ELEMIX, OFFSET(Model, swashmix[1]), 60},
     {SWASH_COLMIX, OFFSET(Model, swashmix[2]), 60},
+    {SWASH_ELEMIX, OFFSET(Model, swashmix[1]), 60},
 };
 static const struct struct_map _sectimer[] = {
+    {TIMER_RESETSRC, OFFSET_SRC(Model.timer[0], resetsrc), 0},
+    {TIMER_SOURCE,   OFFSET_SRC(Model.timer[0], src), 0},
     {TIMER_TIME,     OFFSET(Model.timer[0], timer), 0xFFFF},
     {TIMER_VAL,      OFFSET(Model.timer[0], val), 0xFFFF},
-    {TIMER_SOURCE,   OFFSET_SRC(Model.timer[0], src), 0},
-    {TIMER_RESETSRC, OFFSET_SRC(Model.timer[0], resetsrc), 0},
 };
 static const struct struct_map _secppm[] = {
     {PPMIN_CENTERPW, OFFSET(Model, ppmin_centerpw), 0},
@@ -634,36 +774,46 @@ static int ini_handler(void* user, const char* section, const char* name, const
     struct Model *m = (struct Model *)user;
 int assign_int(void* ptr, const struct struct_map *map, int map_size)
 {
-    for(int i = 0; i < map_size; i++) {
-        if(MATCH_KEY(map[i].str)) {
-            int size = map[i].offset >> 13;
-            int offset = map[i].offset & 0x1FFF;
-            switch(size) {
-                case 0:
-                    *((u8 *)((long)ptr + offset)) = value_int; break;
-                case 1:
-                    *((u16 *)((long)ptr + offset)) = value_int; break;
-                case 2:
-                    *((u8 *)((long)ptr + offset)) = get_source(section, value); break;
-                case 3:
-                    *((u32 *)((long)ptr + offset)) = value_int; break;
-                case 4:
-                    *((s8 *)((long)ptr + offset)) = value_int; break;
-                case 5:
-                    *((s16 *)((long)ptr + offset)) = value_int; break;
-                case 6:
-                    *((u8 *)((long)ptr + offset)) = get_button(section, value); break;
-                case 7:
-                    *((s32 *)((long)ptr + offset)) = value_int; break;
-            }
-            return 1;
+    const struct struct_map *entry = ini_find_key(name, map, map_size, sizeof(struct struct_map));
+    if(entry) {
+        int size = entry->offset >> 13;
+        int offset = entry->offset & 0x1FFF;
+        switch(size) {
+            case 0:
+                *((u8 *)((long)ptr + offset)) = value_int; break;
+            case 1:
+                *((u16 *)((long)ptr + offset)) = value_int; break;
+            case 2:
+                *((u8 *)((long)ptr + offset)) = get_source(section, value); break;
+            case 3:
+                *((u32 *)((long)ptr + offset)) = value_int; break;
+            case 4:
+                *((s8 *)((long)ptr + offset)) = value_int; break;
+            case 5:
+                *((s16 *)((long)ptr + offset)) = value_int; break;
+            case 6:
+                *((u8 *)((long)ptr + offset)) = get_button(section, value); break;
+            case 7:
+                *((s32 *)((long)ptr + offset)) = value_int; break;
         }
+        return 1;
     }
     return 0;
 }
     CLOCK_ResetWatchdog();
     unsigned i;
-    if (MATCH_SECTION("")) {
+    static u8 sec;
+    static int mixer_idx;
+    if (ini_section_changed()) {
+        sec = find_section(section);
+        if (sec == SEC_MIXER) {
+            for (mixer_idx = 0; mixer_idx < NUM_MIXERS; mixer_idx++) {
+                if(m->mixers[mixer_idx].src == 0)
+                    break;
+            }
+        }
+    }
+    if (sec == SEC_NONE) {
         if(MATCH_KEY(MODEL_NAME)) {
             strlcpy(m->name, value, sizeof(m->name)-1);
             return 1;
@@ -701,7 +851,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
             return 1;
         }
     }
-    if (MATCH_SECTION(SECTION_RADIO)) {
+    if (sec == SEC_RADIO) {
         if (MATCH_KEY(RADIO_PROTOCOL)) {
             for (i = 0; i < PROTOCOL_COUNT; i++) {
                 if (MATCH_VALUE(PROTOCOL_GetName(i))) {
@@ -730,24 +880,23 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         printf("Unknown Radio Key: %s\n", name);
         return 0;
     }
-    if (MATCH_SECTION(SECTION_PROTO_OPTS)) {
+    if (sec == SEC_PROTO_OPTS) {
         const char **opts = PROTOCOL_GetOptions();
         if (!opts || ! *opts)
             return 1;
         return handle_proto_opts(m, name, value, opts);
     }
-    if (MATCH_START(section, SECTION_MIXER)) {
-        int idx;
-        for (idx = 0; idx < NUM_MIXERS; idx++) {
-            if(m->mixers[idx].src == 0)
-                break;
-        }
+    if (sec == SEC_MIXER) {
+        //mixer_idx is the first unused mixer
+        int idx = mixer_idx;
         if (MATCH_KEY(MIXER_SOURCE)) {
             if (idx == NUM_MIXERS) {
                 printf("%s: Only %d mixers are supported\n", section, NUM_MIXERS);
                 return 1;
             }
             m->mixers[idx].src = get_source(section, value);
+            if (m->mixers[idx].src)
+                mixer_idx++;
             return 1;
         }
         idx--;
@@ -796,7 +945,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         printf("%s: Couldn't parse key: %s\n", section, name);
         return 0;
     }
-    if (MATCH_START(section, SECTION_CHANNEL)) {
+    if (sec == SEC_CHANNEL) {
         u8 idx = atoi(section + sizeof(SECTION_CHANNEL)-1);
         if (idx == 0) {
             printf("Unknown Channel: %s\n", section);
@@ -847,7 +996,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         printf("%s: Unknown key: %s\n", section, name);
         return 0;
     }
-    if (MATCH_START(section, SECTION_VIRTCHAN)) {
+    if (sec == SEC_VIRTCHAN) {
         u8 idx = atoi(section + sizeof(SECTION_VIRTCHAN)-1);
         if (idx == 0) {
             printf("Unknown Virtual Channel: %s\n", section);
@@ -875,7 +1024,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         printf("%s: Unknown key: %s\n", section, name);
         return 0;
     }
-    if (MATCH_START(section, SECTION_TRIM)) {
+    if (sec == SEC_TRIM) {
         u8 idx = atoi(section + sizeof(SECTION_TRIM)-1);
         if (idx == 0) {
             printf("Unknown Trim: %s\n", section);
@@ -905,7 +1054,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         printf("%s: Unknown trim setting: %s\n", section, name);
         return 0;
     }
-    if (MATCH_SECTION(SECTION_SWASH)) {
+    if (sec == SEC_SWASH) {
         if (MATCH_KEY(SWASH_TYPE)) {
             for (i = SWASH_TYPE_NONE; i <= SWASH_TYPE_90; i++) {
                 if(strcasecmp(MIXER_SwashType(i), value) == 0) {
@@ -934,7 +1083,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         if(assign_int(m, _secswash, MAPSIZE(_secswash)))
             return 1;
     }
-    if (MATCH_START(section, SECTION_TIMER)) {
+    if (sec == SEC_TIMER) {
         u8 idx = atoi(section + sizeof(SECTION_TIMER)-1);
         if (idx == 0) {
             printf("Unknown Timer: %s\n", section);
@@ -958,7 +1107,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         if(assign_int(&m->timer[idx], _sectimer, MAPSIZE(_sectimer)))
             return 1;
     }
-    if (MATCH_START(section, SECTION_TELEMALARM)) {
+    if (sec == SEC_TELEMALARM) {
         u8 idx = atoi(section + sizeof(SECTION_TELEMALARM)-1);
         if (idx == 0) {
             printf("Unknown Telem-alarm: %s\n", section);
@@ -998,7 +1147,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         }
     }
 #if HAS_DATALOG
-    if (MATCH_SECTION(SECTION_DATALOG)) {
+    if (sec == SEC_DATALOG) {
         if (MATCH_KEY(DATALOG_SWITCH)) {
             m->datalog.enable = get_source(section, value);
         } else if (MATCH_KEY(DATALOG_RATE)) {
@@ -1020,7 +1169,7 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         return 1;
     }
 #endif //HAS_DATALOG
-    if (MATCH_START(section, SECTION_SAFETY)) {
+    if (sec == SEC_SAFETY) {
         int found = 0;
         u8 src;
         if (MATCH_KEY("auto")) {
@@ -1039,10 +1188,10 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
             }
         }
     }
-    if (MATCH_START(section, "gui-")) {
+    if (sec == SEC_GUI) {
         return layout_ini_handler(user, section, name, value);
     }
-    if (MATCH_SECTION(SECTION_PPMIN)) {
+    if (sec == SEC_PPMIN) {
         if (MATCH_KEY(PPMIN_NUM_CHANNELS)) {
             m->num_ppmin_channels = atoi(value);
             return 1;
@@ -1072,22 +1221,23 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         }
     }
 #if HAS_EXTENDED_AUDIO
-    char src_name[20];
-
-    if (MATCH_SECTION(SECTION_VOICE)) {
+    if (sec == SEC_VOICE) {
         u16 val = atoi(value);
         if(val>MAX_VOICEMAP_ENTRIES-1 || voice_map[val].duration == 0 || val < CUSTOM_ALARM_ID) {
             printf("%s: Music %s not found in voice.ini or below ID %d\n", section, value, CUSTOM_ALARM_ID);
             return 0;
         }
-        for (int i = INP_HAS_CALIBRATION+1; i <= NUM_INPUTS; i++) {
-            INPUT_SourceName(src_name, i);
-            if (MATCH_KEY(src_name)) {
-                m->voice.switches[i - INP_HAS_CALIBRATION - 1].music = val;
-                return 1;
-            }
+        int src = find_source(name);
+        if (src > INP_HAS_CALIBRATION && src <= NUM_INPUTS) {
+            m->voice.switches[src - INP_HAS_CALIBRATION - 1].music = val;
+            return 1;
+        }
+        if (src > NUM_INPUTS && src <= NUM_INPUTS + NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS) {
+            m->voice.mixer[src - NUM_INPUTS - 1].music = val;
+            return 1;
         }
 #if NUM_AUX_KNOBS
+        char src_name[20];
         for (int i = 0; i < NUM_AUX_KNOBS; i++) {
             INPUT_SourceName(src_name, i + NUM_STICKS + 1);
             strcat(src_name, "_UP");
@@ -1115,13 +1265,6 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
                 return 1;
             }
         }
-        for (int i = 0; i < (NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS); i++) {
-            INPUT_SourceNameReal(src_name, i + NUM_INPUTS + 1);
-            if (MATCH_KEY(src_name)) {
-                m->voice.mixer[i].music = val;
-                return 1;
-            }
-        }
         printf("%s: unknown source name '%s'\n", section, name);
         return 0;
     }
@@ -1130,6 +1273,17 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
     return 0;
 }
 
+// Parses a model or layout file with a source name index for the handler
+static int parse_ini(const char *file, int (*handler)(void*, const char*, const char*, const char*))
+{
+    struct SourceHash index[SOURCE_INDEX_SIZE];
+    source_index = index;
+    source_index_built = 0;
+    int result = CONFIG_IniParse(file, handler, &Model);
+    source_index = NULL;
+    return result;
+}
+
 static void get_model_file(char *file, u8 model_num)
 {
     if (model_num == 0)
@@ -1496,27 +1650,67 @@ static void clear_model(u8 full)
     Model.ppmin_deltapw = 400;
 }
 
+#define PAGE_DIRTY(page) (dirty_pages[(page) / 32] & (1u << ((page) % 32)))
+
+static u32 calc_page_crc(unsigned page)
+{
+    unsigned offset = page * MODEL_PAGE_SIZE;
+    unsigned size = sizeof(Model) - offset < MODEL_PAGE_SIZE ? sizeof(Model) - offset : MODEL_PAGE_SIZE;
+    return Crc((u8 *)&Model + offset, size);
+}
+
+// Returns 1 if the page differs from the last snapshot and updates its dirty flag
+static int check_page(unsigned page)
+{
+    if (calc_page_crc(page) == page_crc[page]) {
+        dirty_pages[page / 32] &= ~(1u << (page % 32));
+        return 0;
+    }
+    dirty_pages[page / 32] |= 1u << (page % 32);
+    return 1;
+}
+
+static void snapshot_model()
+{
+    for (unsigned page = 0; page < MODEL_PAGES; page++)
+        page_crc[page] = calc_page_crc(page);
+    memset(dirty_pages, 0, sizeof(dirty_pages));
+}
+
 u8 CONFIG_ReadModel(u8 model_num) {
-    crc32 = 0;
     Transmitter.current_model = model_num;
-    clear_model(1);
 
     char file[30];
-    auto_map = 0;
     get_model_file(file, model_num);
-    if (CONFIG_IniParse(file, ini_handler, &Model)) {
-        printf("Failed to parse Model file: %s\n", file);
+#if SUPPORT_MODEL_CACHE
+    if (CONFIG_ReadModelCache(model_num, file, &auto_map)) {
+        PROTOCOL_Load(1);  //Normally done by ini_handler
+    } else
+#endif
+    {
+        clear_model(1);
+        auto_map = 0;
+        if (parse_ini(file, ini_handler)) {
+            printf("Failed to parse Model file: %s\n", file);
+        }
+        u8 default_layout = ! ELEM_USED(Model.pagecfg2.elem[0]);
+        if (default_layout)
+            CONFIG_ReadLayout("layout/default.ini");
+#if SUPPORT_MODEL_CACHE
+        //The steps below depend on the tx configuration, so they are not cached
+        CONFIG_WriteModelCache(model_num, file, auto_map, default_layout);
+#else
+        (void)default_layout;
+#endif
     }
-    if (! ELEM_USED(Model.pagecfg2.elem[0]))
-        CONFIG_ReadLayout("layout/default.ini");
     if(! PROTOCOL_HasPowerAmp(Model.protocol))
         Model.tx_power = TXPOWER_150mW;
     MIXER_SetMixers(NULL, 0);
     if(auto_map)
-        RemapChannelsForProtocol(EATRG0);
+        RemapChannelsForProtocol(EATRG0);  //Recompiles the mixers after remapping them
     TIMER_Init();
     MIXER_RegisterTrimButtons();
-    crc32 = Crc(&Model, sizeof(Model));
+    snapshot_model();
     if(! Model.name[0])
         sprintf(Model.name, "Model%d", model_num);
     if (PPMin_Mode())
@@ -1531,15 +1725,40 @@ u8 CONFIG_ReadModel(u8 model_num) {
 }
 
 u8 CONFIG_IsModelChanged() {
-    u32 newCrc = Crc(&Model, sizeof(Model));
-    return (crc32 != newCrc);
+    //Pages already known to be dirty are the most likely to still be changed
+    for (unsigned page = 0; page < MODEL_PAGES; page++) {
+        if (PAGE_DIRTY(page) && check_page(page))
+            return 1;
+    }
+    for (unsigned page = 0; page < MODEL_PAGES; page++) {
+        if (check_page(page))
+            return 1;
+    }
+    return 0;
+}
+
+/* Checks the next MODEL_SCAN_PAGES pages.  Returns 1 if any page is dirty.
+ * A dirty page may have been changed back, so CONFIG_IsModelChanged() gives
+ * the final answer */
+u8 CONFIG_ScanModelChanges() {
+    for (unsigned i = 0; i < sizeof(dirty_pages) / sizeof(dirty_pages[0]); i++) {
+        if (dirty_pages[i])
+            return 1;
+    }
+    for (int i = 0; i < MODEL_SCAN_PAGES; i++) {
+        int dirty = check_page(scan_page);
+        scan_page = (scan_page + 1) % MODEL_PAGES;
+        if (dirty)
+            return 1;
+    }
+    return 0;
 }
 
 u8 CONFIG_SaveModelIfNeeded() {
     if (CONFIG_IsModelChanged()) {
-        crc32 = Crc(&Model, sizeof(Model));
         //printf("Saving model, page %d\n", PAGE_GetID());
         CONFIG_WriteModel(Transmitter.current_model);
+        snapshot_model();
     }
     return 1;
 }
@@ -1620,13 +1839,14 @@ u8 CONFIG_ReadTemplate(const char *filename) {
     sprintf(file, "template/%s", filename);
     clear_model(0);
     auto_map = 0;
-    if (CONFIG_IniParse(file, ini_handler, &Model)) {
+    if (parse_ini(file, ini_handler)) {
         printf("Failed to parse Model file: %s\n", file);
         return 0;
     }
     if(auto_map)
         RemapChannelsForProtocol(EATRG0);
     MIXER_RegisterTrimButtons();
+    MIXER_CompileMixers();
     STDMIXER_Preset(); // bug fix: this must be invoked in all modes
     if (Model.mixer_mode == MIXER_STANDARD)
         STDMIXER_SetChannelOrderByProtocol();
@@ -1635,7 +1855,7 @@ u8 CONFIG_ReadTemplate(const char *filename) {
 
 u8 CONFIG_ReadLayout(const char *filename) {
     memset(&Model.pagecfg2, 0, sizeof(Model.pagecfg2));
-    if (CONFIG_IniParse(filename, layout_ini_handler, &Model)) {
+    if (parse_ini(filename, layout_ini_handler)) {
         printf("Failed to parse Layout file: %s\n", filename);
         return 0;
     }
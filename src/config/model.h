@@ -91,5 +91,7 @@ void CONFIG_ResetModel();
 u8 CONFIG_ReadTemplateByIndex(u8 template_num);
 u8 CONFIG_ReadTemplate(const char *filename);
 u8 CONFIG_ReadLayout(const char *filename);
+int CONFIG_ReadModelCache(u8 model_num, const char *file, u8 *auto_map);
+void CONFIG_WriteModelCache(u8 model_num, const char *file, u8 auto_map, u8 default_layout);
 
 #endif /*_MODEL_H_*/
@@ -0,0 +1,130 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "model.h"
+
+/* Binary model cache
+ * models/cache.bin holds a copy of the parsed Model for a few models so that
+ * loading a model only needs a single read instead of parsing its ini file.
+ * The slot for a model is only used if the firmware version, sizeof(Model)
+ * and the crc of the model ini file all match.  hardware.ini is included in
+ * the crc because it changes how source names are parsed, and so is
+ * layout/default.ini for models without a layout of their own.
+ * The file is not created here since not all filesystems can create or grow
+ * files.  The filesystem build creates it, and the cache is disabled if it
+ * is missing */
+#if SUPPORT_MODEL_CACHE
+#define CACHE_FILE  "models/cache.bin"
+#define CACHE_MAGIC 0x434d4456  //"VDMC"
+
+struct CacheHeader {
+    u32 magic;
+    u32 version_crc;
+    u32 ini_crc;
+    u32 data_crc;
+    u16 size;
+    u8 model_num;
+    u8 auto_map;
+    u8 default_layout;  //layout/default.ini was merged into the model
+};
+
+//Slots are sector aligned
+#define SLOT_SIZE ((sizeof(struct CacheHeader) + sizeof(struct Model) + 511) & ~511)
+
+static u32 file_crc(u32 crc, const char *file)
+{
+    u8 buf[64];
+    FILE *fh = fopen(file, "r");
+    if (! fh)
+        return crc;
+    unsigned len;
+    while ((len = fread(buf, 1, sizeof(buf), fh)) > 0)
+        crc = CRC32_Update(crc, buf, len);
+    fclose(fh);
+    return crc;
+}
+
+static u32 ini_crc(const char *file, u8 default_layout)
+{
+    u32 crc = file_crc(file_crc(0, file), "hardware.ini");
+    return default_layout ? file_crc(crc, "layout/default.ini") : crc;
+}
+
+static u32 version_crc()
+{
+    return Crc(DeviationVersion, strlen(DeviationVersion));
+}
+
+// Returns the file offset of the slot for model_num or -1 if there is no cache
+static long seek_slot(FILE *fh, u8 model_num)
+{
+    fseek(fh, 0, SEEK_END);
+    long slots = ftell(fh) / SLOT_SIZE;
+    if (slots <= 0)
+        return -1;
+    long pos = (model_num % slots) * SLOT_SIZE;
+    fseek(fh, pos, SEEK_SET);
+    return pos;
+}
+
+/* Loads Model and the auto-map flag from the cache.  Returns 0 if the cached
+ * copy is missing or stale, in which case Model is undefined */
+int CONFIG_ReadModelCache(u8 model_num, const char *file, u8 *auto_map)
+{
+    struct CacheHeader hdr;
+    FILE *fh = fopen(CACHE_FILE, "r");
+    if (! fh)
+        return 0;
+    int ok = seek_slot(fh, model_num) >= 0
+             && fread(&hdr, sizeof(hdr), 1, fh) == 1
+             && hdr.magic == CACHE_MAGIC
+             && hdr.size == sizeof(Model)
+             && hdr.model_num == model_num
+             && hdr.version_crc == version_crc()
+             && fread(&Model, sizeof(Model), 1, fh) == 1
+             && Crc(&Model, sizeof(Model)) == hdr.data_crc;
+    fclose(fh);
+    //Only one file can be open at a time, so the ini files are read last
+    ok = ok && hdr.ini_crc == ini_crc(file, hdr.default_layout);
+    if (ok)
+        *auto_map = hdr.auto_map;
+    return ok;
+}
+
+// Stores Model, which must have just been parsed from 'file', in the cache
+void CONFIG_WriteModelCache(u8 model_num, const char *file, u8 auto_map, u8 default_layout)
+{
+    struct CacheHeader hdr;
+    //Only one file can be open at a time, so the ini files are read first
+    u32 crc = ini_crc(file, default_layout);
+    FILE *fh = fopen(CACHE_FILE, "r+");
+    if (! fh)
+        return;
+    if (seek_slot(fh, model_num) >= 0) {
+        hdr.magic = CACHE_MAGIC;
+        hdr.version_crc = version_crc();
+        hdr.ini_crc = crc;
+        hdr.data_crc = Crc(&Model, sizeof(Model));
+        hdr.size = sizeof(Model);
+        hdr.model_num = model_num;
+        hdr.auto_map = auto_map;
+        hdr.default_layout = default_layout;
+        fwrite(&hdr, sizeof(hdr), 1, fh);
+        fwrite(&Model, sizeof(Model), 1, fh);
+    }
+    fclose(fh);
+}
+#endif //SUPPORT_MODEL_CACHE
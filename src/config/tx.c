@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "autodimmer.h"
+#include "ini.h"
 
 struct Transmitter Transmitter;
 static u32 crc32;
@@ -87,80 +88,52 @@ static const char TELEM_ALERT_INTERVAL[] ="alertinterval";
 #define MATCH_VALUE(s)   strcasecmp(value,   s) == 0
 #define NUM_STR_ELEMS(s) (sizeof(s) / sizeof(char *))
 
+struct struct_map {const char *str;  u16 offset;};
+#define MAPSIZE(x)  (sizeof(x) / sizeof(struct struct_map))
+#define OFFSET(s,v) (((long)(&s.v) - (long)(&s)) | ((sizeof(s.v)-1) << 13))
+//Must be sorted for ini_find_key()
+static const struct struct_map _secnone[] =
+{
+#if HAS_EXTENDED_AUDIO
+    {AUDIO_VOL,             OFFSET(Transmitter, audio_vol)},
+#endif
+    {BATT_ALARM,            OFFSET(Transmitter, batt_alarm)},
+    {BATT_CRITICAL,         OFFSET(Transmitter, batt_critical)},
+    {BATT_WARNING_INTERVAL, OFFSET(Transmitter, batt_warning_interval)},
+    {BRIGHTNESS,            OFFSET(Transmitter, backlight)},
+    {CONTRAST,              OFFSET(Transmitter, contrast)},
+    {CURRENT_MODEL,         OFFSET(Transmitter, current_model)},
+#if HAS_RTC
+    {DATE_FORMAT,           OFFSET(Transmitter, rtc_dateformat)},
+#endif
+    {LANGUAGE,              OFFSET(Transmitter, language)},
+    {MODE,                  OFFSET(Transmitter, mode)},
+    {MUSIC_SHUTD,           OFFSET(Transmitter, music_shutdown)},
+    {POWER_ALARM,           OFFSET(Transmitter, power_alarm)},
+    {SPLASH_DELAY,          OFFSET(Transmitter, splash_delay)},
+#if HAS_RTC
+    {TIME_FORMAT,           OFFSET(Transmitter, rtc_timeformat)},
+#endif
+    {VIBRATION,             OFFSET(Transmitter, vibration_state)},
+    {VOLUME,                OFFSET(Transmitter, volume)},
+};
+
 static int ini_handler(void* user, const char* section, const char* name, const char* value)
 {
     struct Transmitter *t = (struct Transmitter *)user;
 
     s32 value_int = atoi(value);
     if (section[0] == '\0') {
-        if (MATCH_KEY(CURRENT_MODEL)) {
-            t->current_model = value_int;
-            return 1;
-        }
-        if (MATCH_KEY(LANGUAGE)) {
-            t->language = value_int;
-            return 1;
-        }
-	if (MATCH_KEY(MUSIC_SHUTD)) {
-            t->music_shutdown = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(MODE)) {
-            t->mode = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(BRIGHTNESS)) {
-            t->backlight = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(CONTRAST)) {
-            t->contrast = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(VOLUME)) {
-            t->volume = atoi(value);
-            return 1;
-        }
-#if HAS_EXTENDED_AUDIO
-        if (MATCH_KEY(AUDIO_VOL)) {
-            t->audio_vol = atoi(value);
-            return 1;
-        }
-#endif
-        if (MATCH_KEY(VIBRATION)) {
-            t->vibration_state = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(POWER_ALARM)) {
-            t->power_alarm = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(BATT_ALARM)) {
-            t->batt_alarm = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(BATT_CRITICAL)) {
-            t->batt_critical = atoi(value);
-            return 1;
-        }
-	if (MATCH_KEY(BATT_WARNING_INTERVAL)) {
-            t->batt_warning_interval = atoi(value);
-            return 1;
-        }
-	if (MATCH_KEY(SPLASH_DELAY)) {
-            t->splash_delay = atoi(value);
-            return 1;
-        }
-    #if HAS_RTC
-        if (MATCH_KEY(TIME_FORMAT)) {
-            t->rtc_timeformat = atoi(value);
-            return 1;
-        }
-        if (MATCH_KEY(DATE_FORMAT)) {
-            t->rtc_dateformat = atoi(value);
+        const struct struct_map *entry = ini_find_key(name, _secnone, MAPSIZE(_secnone), sizeof(struct struct_map));
+        if (entry) {
+            void *ptr = (u8 *)t + (entry->offset & 0x1FFF);
+            switch(entry->offset >> 13) {
+                case 0: *((u8 *)ptr) = value_int; break;
+                case 1: *((u16 *)ptr) = value_int; break;
+                case 3: *((u32 *)ptr) = value_int; break;
+            }
             return 1;
         }
-    #endif
     }
     if(MATCH_START(section, SECTION_CALIBRATE) && strlen(section) >= sizeof(SECTION_CALIBRATE)) {
         u8 idx = atoi(section + sizeof(SECTION_CALIBRATE)-1);
@@ -348,6 +321,7 @@ void CONFIG_LoadTx()
     MCU_InitModules();
     CONFIG_LoadHardware();
     CONFIG_IniParse("tx.ini", ini_handler, (void *)&Transmitter);
+    ADC_UpdateCalibration();
     crc32 = Crc(&Transmitter, sizeof(Transmitter));
 #if HAS_EXTENDED_AUDIO
     CONFIG_VoiceParse(MAX_VOICEMAP_ENTRIES);
@@ -355,6 +329,21 @@ void CONFIG_LoadTx()
     return;
 }
 
+void CALIB_Build(struct CalibCoef *coef, const struct StickCalibration *cal, int sign)
+{
+    s32 zero = cal->zero;
+    if (!zero) {
+        // If this input doesn't have a zero, calculate from max/min
+        zero = ((u32)cal->max + cal->min) / 2;
+    }
+    // Derate min and max by 1% to ensure we can get all the way to 100%
+    s32 max = (cal->max - zero) * 99 / 100;
+    s32 min = (cal->min - zero) * 99 / 100;
+    coef->zero = zero;
+    coef->mul[0] = min ? sign * ((s64)CHAN_MIN_VALUE * (1 << CALIB_SHIFT) / min) : 0;
+    coef->mul[1] = max ? sign * ((s64)CHAN_MAX_VALUE * (1 << CALIB_SHIFT) / max) : 0;
+}
+
 void CONFIG_SaveTxIfNeeded()
 {
     u32 newCrc = Crc(&Transmitter, sizeof(Transmitter));
@@ -364,3 +353,6 @@ void CONFIG_SaveTxIfNeeded()
     //printf("Saving TX\n");
     CONFIG_WriteTx();
 }
+
+#define TESTNAME tx
+#include <tests.h>
@@ -25,6 +25,14 @@ struct StickCalibration {
     u16 zero;
 };
 
+/* Fixed-point form of a StickCalibration so that normalizing an input only
+ * needs one multiply.  Built by CALIB_Build whenever the calibration changes */
+#define CALIB_SHIFT 16
+struct CalibCoef {
+    s32 zero;
+    s32 mul[2];  // Scale below and above zero, including the inversion sign
+};
+
 struct TouchCalibration {
     s32 xscale;
     s32 yscale;
@@ -101,6 +109,18 @@ extern struct Transmitter Transmitter;
 
 void CONFIG_LoadTx();
 void CONFIG_LoadHardware();
+void CALIB_Build(struct CalibCoef *coef, const struct StickCalibration *cal, int sign);
+
+static inline s32 CALIB_Apply(const struct CalibCoef *coef, s32 value)
+{
+    s32 delta = value - coef->zero;
+    value = ((s64)delta * coef->mul[delta >= 0] + (1 << (CALIB_SHIFT - 1))) >> CALIB_SHIFT;
+    if (value > CHAN_MAX_VALUE)
+        return CHAN_MAX_VALUE;
+    if (value < CHAN_MIN_VALUE)
+        return CHAN_MIN_VALUE;
+    return value;
+}
 
 #define TX_HAS_SRC(x) ((~Transmitter.ignore_src & (((srcsize_t)1) << x)) == (((srcsize_t)1) << x))
 
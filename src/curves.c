@@ -47,12 +47,40 @@ s32 compute_tangent(struct Curve *curve, int num_points, int i)
     return m;
 }
 
+/* Tangent tables
+   compute_tangent() needs several divides per point, so the tangents of smoothed curves
+   are pre-computed via CURVE_CreateTable() whenever the mixers are compiled.
+   The number of tables is limited by CURVE_TABLES, other curves are evaluated directly.
+*/
+#ifndef CURVE_TABLES
+#define CURVE_TABLES 8
+#endif
+static s32 curve_tables[CURVE_TABLES][MAX_POINTS];
+static unsigned num_curve_tables;
+
+void CURVE_ResetTables()
+{
+    num_curve_tables = 0;
+}
+
+int CURVE_CreateTable(struct Curve *curve)
+{
+    if (CURVE_TYPE(curve) < CURVE_3POINT || ! CURVE_SMOOTHING(curve) || num_curve_tables >= CURVE_TABLES)
+        return -1;
+    int num_points = (CURVE_TYPE(curve) - CURVE_3POINT) * 2 + 3;
+    s32 *tangent = curve_tables[num_curve_tables];
+    for (int i = 0; i < num_points; i++)
+        tangent[i] = compute_tangent(curve, num_points, i);
+    return num_curve_tables++;
+}
+
 /* The following is a hermite cubic spline.
    The basis functions can be found here:
    http://en.wikipedia.org/wiki/Cubic_Hermite_spline
    The tangents are computed via the 'cubic monotone' rules (allowing for local-maxima)
+   If 'tangent' is NULL, the tangents are calculated on the fly
 */
-s32 hermite_spline(struct Curve *curve, s32 value)
+s32 hermite_spline(struct Curve *curve, s32 value, const s32 *tangent)
 {
     int num_points = (CURVE_TYPE(curve) - CURVE_3POINT) * 2 + 3;
     s32 step = PCT_TO_RANGE(2 * 100) / (num_points - 1) ;
@@ -61,53 +89,48 @@ s32 hermite_spline(struct Curve *curve, s32 value)
     } else if(value > PCT_TO_RANGE(100)) {
         value = PCT_TO_RANGE(100);
     }
-    for (int i = 0; i < num_points -1; i++) {
-        s32 x = PCT_TO_RANGE(-100) + i * step;
-        s32 p0x = x;
-        s32 p3x;
-        //If there are rounding errors, we need to deal with them here
-        if (i == num_points - 2) {
-            p3x = PCT_TO_RANGE(100);
-        } else {
-            p3x = x + step;
-        }
-        if(value >= p0x && value <= p3x) {
-            s32 p0y = PCT_TO_RANGE(curve->points[i]);
-            s32 p3y = PCT_TO_RANGE(curve->points[i+1]);
-            s32 m0 = compute_tangent(curve, num_points, i);
-            s32 m3 = compute_tangent(curve, num_points, i+1);
-            s32 y;
-            s32 h = p3x - p0x;
-            s32 t = (MMULT * (value - p0x)) / h;
-            s32 t2 = t * t / MMULT;
-            s32 t3 = t2 * t / MMULT;
-            s32 h00 = 2*t3 - 3*t2 + MMULT;
-            s32 h10 = t3 - 2*t2 + t;
-            s32 h01 = -2*t3 + 3*t2;
-            s32 h11 = t3 - t2;
-            y = p0y * h00 + h * (m0 * h10 / MMULT) + p3y * h01 + h * (m3 * h11 / MMULT);
-            y /= MMULT;
-            return y;
-        }
-    }
-    return 0;
+    //The points are evenly spaced, so the segment can be found directly
+    //If there are rounding errors, the last segment absorbs them
+    int i = (value - PCT_TO_RANGE(-100)) / step;
+    if (i > num_points - 2)
+        i = num_points - 2;
+    s32 p0x = PCT_TO_RANGE(-100) + i * step;
+    s32 p3x = (i == num_points - 2) ? PCT_TO_RANGE(100) : p0x + step;
+    s32 p0y = PCT_TO_RANGE(curve->points[i]);
+    s32 p3y = PCT_TO_RANGE(curve->points[i+1]);
+    s32 m0 = tangent ? tangent[i] : compute_tangent(curve, num_points, i);
+    s32 m3 = tangent ? tangent[i+1] : compute_tangent(curve, num_points, i+1);
+    s32 y;
+    s32 h = p3x - p0x;
+    s32 t = (MMULT * (value - p0x)) / h;
+    s32 t2 = t * t / MMULT;
+    s32 t3 = t2 * t / MMULT;
+    s32 h00 = 2*t3 - 3*t2 + MMULT;
+    s32 h10 = t3 - 2*t2 + t;
+    s32 h01 = -2*t3 + 3*t2;
+    s32 h11 = t3 - t2;
+    y = p0y * h00 + h * (m0 * h10 / MMULT) + p3y * h01 + h * (m3 * h11 / MMULT);
+    y /= MMULT;
+    return y;
 }
 
+#define INTERPOLATE_POS(i, step) PCT_TO_RANGE((-10000 + (i) * (step)) / 100)
 s32 interpolate(struct Curve *curve, s32 value)
 {
-    int i;
     int num_points = (CURVE_TYPE(curve) - CURVE_3POINT) * 2 + 3;
     s32 step = 2 * 10000 / (num_points - 1) ;
-    for (i = 0; i < num_points - 1; i++) {
-        s32 x = -10000 + i * step;
-        s32 pos1 = PCT_TO_RANGE(x / 100);
-        s32 pos2 = PCT_TO_RANGE((x + step) / 100);
-        if(value >= pos1 && value <= pos2) {
-            s32 tmp = (value - pos1) * (curve->points[i + 1] - curve->points[i]) / (pos2 - pos1) + curve->points[i];
-            return PCT_TO_RANGE(tmp);
-        }
-    }
-    return PCT_TO_RANGE(curve->points[num_points - 1]);
+    //Start from the estimated segment and correct for the rounding of the point positions
+    int i = (value + 10000) / step;
+    if (i > num_points - 2)
+        i = num_points - 2;
+    while (i > 0 && value <= INTERPOLATE_POS(i, step))
+        i--;
+    if (value > INTERPOLATE_POS(i + 1, step) && ++i == num_points - 1)
+        return PCT_TO_RANGE(curve->points[num_points - 1]);
+    s32 pos1 = INTERPOLATE_POS(i, step);
+    s32 pos2 = INTERPOLATE_POS(i + 1, step);
+    s32 tmp = (value - pos1) * (curve->points[i + 1] - curve->points[i]) / (pos2 - pos1) + curve->points[i];
+    return PCT_TO_RANGE(tmp);
 }
 
 /* This camefrom er9x/th9x
@@ -165,7 +188,7 @@ s32 deadband(struct Curve *curve, s32 value)
     return max * ((1000 * (value - max) + (1000 - k) * max) / (1000 - k)) / value;
 }
 
-s32 CURVE_Evaluate(s32 xval, struct Curve *curve)
+s32 CURVE_EvaluateTable(s32 xval, struct Curve *curve, int table)
 {
     s32 divisor;
     if (CURVE_TYPE(curve) != CURVE_NONE) {
@@ -210,11 +233,16 @@ s32 CURVE_Evaluate(s32 xval, struct Curve *curve)
         case CURVE_EXPO:     return expo(curve, xval);
         case CURVE_DEADBAND: return deadband(curve, xval);
         default:             return CURVE_SMOOTHING(curve)
-                                    ? hermite_spline(curve, xval)
+                                    ? hermite_spline(curve, xval, table >= 0 ? curve_tables[table] : NULL)
                                     : interpolate(curve, xval);
     }
 }
 
+s32 CURVE_Evaluate(s32 xval, struct Curve *curve)
+{
+    return CURVE_EvaluateTable(xval, curve, -1);
+}
+
 const char *CURVE_GetName(char *str, struct Curve *curve)
 {
     switch (CURVE_TYPE(curve)) {
@@ -257,3 +285,5 @@ unsigned CURVE_NumPoints(struct Curve *curve)
     }
 }
 
+#define TESTNAME curves
+#include <tests.h>
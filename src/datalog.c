@@ -18,6 +18,7 @@
 #include "config/model.h"
 
 #include <stdio.h>
+#include <stddef.h>
 
 #if HAS_DATALOG
 
@@ -25,9 +26,10 @@
 #define ENABLE_RAW_WRITE 0
 
 // version check by utils/datalog2csv.py
-#define DATALOG_VERSION 0x05
+#define DATALOG_VERSION 0x06
 // version 4: add dsm rssi telemetry
 // version 5: add dsm Smart Bat cell voltages
+// version 6: add index at the end of the file
 
 //This is pretty crude.  need a more robust check
 #if TXID == 10
@@ -35,17 +37,25 @@
 //ctassert((DLOG_LAST == 116), dlog_api_changed); // DATALOG_VERSION = 0x02
 //ctassert((DLOG_LAST == 120), dlog_api_changed); // DATALOG_VERSION = 0x03
 //ctassert((DLOG_LAST == 121), dlog_api_changed); // DATALOG_VERSION = 0x04
-ctassert((DLOG_LAST == 131), dlog_api_changed); // DATALOG_VERSION = 0x05
+ctassert((DLOG_LAST == 131), dlog_api_changed); // DATALOG_VERSION = 0x05, 0x06
 #endif
 
 #define UPDATE_DELAY 4000 //wiat 4 seconds after changing enable before sample start
+#define FLUSH_DELAY 10000 //write buffered samples at least this often
 #define DATALOG_HEADER_SIZE (3 + ((7 + NUM_DATALOG) / 8))
+//Largest sample, with every source enabled
+#define DATALOG_MAX_SIZE (TIMER_SIZE * NUM_TIMERS + 2 * NUM_TELEM + (DLOG_GPSLOC - DLOG_INPUTS) \
+                          + GPSLOC_SIZE + 3 * GPSTIME_SIZE + HAS_RTC * CLOCK_SIZE)
+ctassert((DATALOG_HEADER_SIZE + 1 + DATALOG_MAX_SIZE <= DATALOG_BUFFER_SIZE), datalog_buffer_too_small);
 const u32 sample_rate[DLOG_RATE_LAST] = {
     [DLOG_RATE_1SEC]  =  1000,
     [DLOG_RATE_5SEC]  =  5000,
     [DLOG_RATE_10SEC] = 10000,
     [DLOG_RATE_30SEC] = 30000,
     [DLOG_RATE_1MIN]  = 60000,
+    [DLOG_RATE_100MSEC] = 100,
+    [DLOG_RATE_250MSEC] = 250,
+    [DLOG_RATE_500MSEC] = 500,
 };
 
 static FSHANDLE DatalogFAT;
@@ -53,9 +63,41 @@ static FILE *fh;
 static u32 next_update;
 static u32 dlog_pos;
 static u32 dlog_size;
+static u32 next_flush;
+static u8 logging;
 u8 need_header_update;
 u16 data_size;
 
+/* Samples are encoded into buffer and written out in one go when it is full,
+ * when logging is switched off, at power-off, or at least every FLUSH_DELAY.
+ * dlog_pos is the end of the data in the file, which is always followed by
+ * 0x00 */
+static u8 buffer[DATALOG_BUFFER_SIZE];
+static u16 used;
+
+/* The last INDEX_SIZE bytes of the file hold two copies of the index, which
+ * records the end of the data and where the latest sessions (headers) start.
+ * The copies are written alternately after each flush, so an interrupted
+ * write leaves the other one intact.  The newest copy with a valid crc is
+ * used.  If the data was flushed but the index was not updated, the end is
+ * found by scanning from the start of the last session.  Files without an
+ * index are scanned from the start */
+#define INDEX_MAGIC    0x49474c44  //"DLGI"
+#define INDEX_SESSIONS 11
+struct DatalogIndex {
+    u32 magic;
+    u32 seq;
+    u32 end;
+    u16 num_sessions;   // Total number of sessions, only the last INDEX_SESSIONS are kept
+    u8 version;
+    u8 reserved;
+    u32 session[INDEX_SESSIONS];
+    u32 crc;
+};
+ctassert((sizeof(struct DatalogIndex) == 64), datalog_index_size_changed);
+#define INDEX_SIZE (2 * sizeof(struct DatalogIndex))
+static struct DatalogIndex dindex;
+
 const char *DATALOG_RateString(int idx)
 {
     switch(idx) {
@@ -64,6 +106,9 @@ const char *DATALOG_RateString(int idx)
         case 2: return _tr_noop("10 sec");
         case 3: return _tr_noop("30 sec");
         case 4: return _tr_noop("60 sec");
+        case 5: return _tr_noop("100 msec");
+        case 6: return _tr_noop("250 msec");
+        case 7: return _tr_noop("500 msec");
     }
     return "";
 }
@@ -125,59 +170,130 @@ int DATALOG_GetSize(u8 *src)
     return size;
 }
 
-long _find_fpos() {
-    dlog_pos = 0;
+static void add_session(u32 pos)
+{
+    unsigned count = dindex.num_sessions < INDEX_SESSIONS ? dindex.num_sessions : INDEX_SESSIONS;
+    if (count && dindex.session[count - 1] == pos)
+        return;
+    if (count == INDEX_SESSIONS) {
+        memmove(dindex.session, dindex.session + 1, (INDEX_SESSIONS - 1) * sizeof(u32));
+        count--;
+    }
+    dindex.session[count] = pos;
+    dindex.num_sessions++;
+}
+
+static void write_index()
+{
+    dindex.magic = INDEX_MAGIC;
+    dindex.version = DATALOG_VERSION;
+    dindex.seq++;
+    dindex.end = dlog_pos;
+    dindex.crc = CRC32_Update(0, (const u8 *)&dindex, offsetof(struct DatalogIndex, crc));
+    fseek(fh, dlog_size + (dindex.seq & 1) * sizeof(dindex), SEEK_SET);
+    fwrite(&dindex, sizeof(dindex), 1, fh);
+}
+
+static int read_index()
+{
+    struct DatalogIndex idx[2];
+    int found = 0;
+    fseek(fh, dlog_size, SEEK_SET);
+    if (fread(idx, sizeof(idx), 1, fh) != 1)
+        return 0;
+    for (int i = 0; i < 2; i++) {
+        if (idx[i].magic != INDEX_MAGIC || idx[i].end > dlog_size
+            || idx[i].crc != CRC32_Update(0, (const u8 *)&idx[i], offsetof(struct DatalogIndex, crc)))
+            continue;
+        if (! found || (s32)(idx[i].seq - dindex.seq) > 0)
+            dindex = idx[i];
+        found = 1;
+    }
+    return found;
+}
+
+//Returns the position of the first 0x00 record at or after pos, which must be the start of a record
+static u32 find_end(u32 pos)
+{
     int size = 1;
     u8 data[DATALOG_HEADER_SIZE];
-    while(1) {
-        fread((char *)data, DATALOG_HEADER_SIZE, 1, fh);
-        if (data[0] == 0x00) {
-            fseek(fh, dlog_pos, SEEK_SET);
-            return dlog_pos;
-        }
+    while (pos < dlog_size) {
+        fseek(fh, pos, SEEK_SET);
+        memset(data, 0, sizeof(data));
+        fread((char *)data, 1, sizeof(data), fh);
+        if (data[0] == 0x00)
+            return pos;
         if (data[0] == 0xff) {
-            dlog_pos += size;
-            fseek(fh, dlog_pos, SEEK_SET);
+            pos += size;
             continue;
         }
-        dlog_pos += DATALOG_HEADER_SIZE;
-        size = DATALOG_GetSize(data+2) + 1;
+        add_session(pos);
+        pos += DATALOG_HEADER_SIZE;
+        size = DATALOG_GetSize(data+3) + 1;
     }
+    return dlog_size;
+}
+
+static u32 _find_fpos()
+{
+    if (read_index()) {
+        u8 data = 0xff;
+        fseek(fh, dindex.end, SEEK_SET);
+        fread(&data, 1, 1, fh);
+        if (data == 0x00 || dindex.end == dlog_size)
+            return dindex.end;
+        //The last flush did not update the index
+        unsigned count = dindex.num_sessions < INDEX_SESSIONS ? dindex.num_sessions : INDEX_SESSIONS;
+        return find_end(count ? dindex.session[count - 1] : 0);
+    }
+    memset(&dindex, 0, sizeof(dindex));
+    return find_end(0);
 }
 
 void _write_8(s32 data)
 {
-    u8 x[1] = {(data & 0xff)};
-    fwrite(x, 1, 1, fh);
-    dlog_pos++;
+    buffer[used++] = data & 0xff;
 }
 void _write_16(s32 data)
 {
-    u8 x[2] = {(data & 0xff),
-               (data >> 8) & 0xff,
-              };
-    fwrite(x, 2, 1, fh);
-    dlog_pos+=2;
+    buffer[used++] = data & 0xff;
+    buffer[used++] = (data >> 8) & 0xff;
 }
 
 void _write_32(s32 data)
 {
-    u8 x[4] = {(data & 0xff),
-               (data >> 8) & 0xff,
-               (data >> 16) & 0xff,
-               (data >> 24) & 0xff,
-              };
-    fwrite(x, 4, 1, fh);
-    dlog_pos+=4;
+    buffer[used++] = data & 0xff;
+    buffer[used++] = (data >> 8) & 0xff;
+    buffer[used++] = (data >> 16) & 0xff;
+    buffer[used++] = (data >> 24) & 0xff;
 }
 
 void _write_header() {
     need_header_update = 0;
+    add_session(dlog_pos + used);
     _write_8(DATALOG_VERSION);
     _write_8(TXID);
     _write_8(Model.datalog.rate);
-    fwrite(Model.datalog.source, sizeof(Model.datalog.source), 1, fh);
-    dlog_pos += 3 + sizeof(Model.datalog.source);
+    memcpy(buffer + used, Model.datalog.source, sizeof(Model.datalog.source));
+    used += sizeof(Model.datalog.source);
+}
+
+void DATALOG_Flush()
+{
+    if (! fh || ! used)
+        return;
+    /* The first byte is written last.  Until then the file still ends with
+     * 0x00 at dlog_pos, so an interrupted write only loses this buffer */
+    if (used > 1) {
+        fseek(fh, dlog_pos + 1, SEEK_SET);
+        fwrite(buffer + 1, used - 1, 1, fh);
+    }
+    fseek(fh, dlog_pos, SEEK_SET);
+    fwrite(buffer, 1, 1, fh);
+    dlog_pos += used;
+    used = 0;
+    next_flush = CLOCK_getms() + FLUSH_DELAY;
+    write_index();
 }
 
 void DATALOG_Write()
@@ -223,15 +339,24 @@ void DATALOG_Update()
 #endif
     if (! fh)
         return;
-    if(MIXER_SourceAsBoolean(Model.datalog.enable) && ((int)dlog_size - ftell(fh) >= data_size)) {
-        u32 time = CLOCK_getms();
+    u32 time = CLOCK_getms();
+    int enabled = MIXER_SourceAsBoolean(Model.datalog.enable);
+    if (enabled && DATALOG_Remaining() >= data_size + 1 + (need_header_update ? DATALOG_HEADER_SIZE : 0)) {
         if(time >= next_update) {
+            if (used + data_size + 1 + DATALOG_HEADER_SIZE > DATALOG_BUFFER_SIZE)
+                DATALOG_Flush();
             if (need_header_update)
                 _write_header();
-            next_update = time + sample_rate[Model.datalog.rate];
+            //Keep to the sample rate unless we fell behind by more than a sample
+            next_update += sample_rate[Model.datalog.rate];
+            if (time >= next_update)
+                next_update = time + sample_rate[Model.datalog.rate];
             DATALOG_Write();
         }
     }
+    if ((logging && ! enabled) || (used && time >= next_flush))
+        DATALOG_Flush();
+    logging = enabled;
 }
 
 void DATALOG_UpdateState()
@@ -246,6 +371,9 @@ void DATALOG_Reset()
     if (fh) {
         fempty(fh);
         dlog_pos = 0;
+        used = 0;
+        memset(&dindex, 0, sizeof(dindex));
+        write_index();
         DATALOG_UpdateState();
     }
 }
@@ -253,7 +381,7 @@ void DATALOG_Reset()
 int DATALOG_Remaining()
 {
     if(fh)
-       return dlog_size - ftell(fh);
+       return dlog_size - dlog_pos - used;
     return 0;
 }
 
@@ -261,23 +389,34 @@ void DATALOG_Init()
 {
     next_update = 0;
     need_header_update = 1;
+    used = 0;
+    logging = 0;
     finit(&DatalogFAT, "");
     fh = fopen2(&DatalogFAT, "datalog.bin", "r+");
     if (fh) {
         setbuf(fh, 0);
+        fseek(fh, 0, SEEK_END);
+        dlog_size = ftell(fh);
+        if (dlog_size < INDEX_SIZE + DATALOG_BUFFER_SIZE) {
+            fclose(fh);
+            fh = NULL;
+            return;
+        }
+        dlog_size -= INDEX_SIZE;
 #if ENABLE_RAW_WRITE
-        long pos = 0L;
+        dlog_pos = 0;
+        memset(&dindex, 0, sizeof(dindex));
 #else
-        long pos = _find_fpos();
+        dlog_pos = _find_fpos();
+        if (! dindex.magic || dindex.end != dlog_pos)
+            write_index();
 #endif
-        fseek(fh, 0, SEEK_END);
-        dlog_size = ftell(fh);
-        fseek(fh, pos, SEEK_SET);
         data_size = DATALOG_GetSize(Model.datalog.source);
         printf("num data: %d data size: %d\n", DLOG_LAST, DATALOG_GetSize(NULL));
         next_update = CLOCK_getms();
+        next_flush = next_update + FLUSH_DELAY;
     }
-} 
+}
 
 #if ENABLE_RAW_WRITE
 void DATALOG_RawWrite(u8 *data, int length) {
@@ -285,8 +424,14 @@ void DATALOG_RawWrite(u8 *data, int length) {
         return;
 
     if (DATALOG_Remaining() >= length)
-        for (int i=0; i < length; i++)
+        for (int i=0; i < length; i++) {
+            if (used == DATALOG_BUFFER_SIZE)
+                DATALOG_Flush();
             _write_8(*data++);
+        }
 }
 #endif
+
+#define TESTNAME datalog
+#include <tests.h>
 #endif //HAS_DATALOG
@@ -17,14 +17,19 @@ enum {
     DLOG_LAST,
 };
 
+//Sub-second rates were added last to keep the existing indices
 enum {
     DLOG_RATE_1SEC,
     DLOG_RATE_5SEC,
     DLOG_RATE_10SEC,
     DLOG_RATE_30SEC,
     DLOG_RATE_1MIN,
+    DLOG_RATE_100MSEC,
+    DLOG_RATE_250MSEC,
+    DLOG_RATE_500MSEC,
     DLOG_RATE_LAST,
 };
+#define DLOG_RATE_NUM_FAST (DLOG_RATE_LAST - DLOG_RATE_100MSEC)
 
 #define GPSLOC_SIZE 8
 #define GPSTIME_SIZE 4
@@ -43,6 +48,7 @@ struct datalog {
 
 extern void DATALOG_Init();
 extern void DATALOG_Update();
+extern void DATALOG_Flush();
 extern const char *DATALOG_Source(char *str, int idx);
 extern int DATALOG_Remaining();
 extern void DATALOG_Reset();
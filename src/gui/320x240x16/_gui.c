@@ -40,6 +40,111 @@ void _gui_hilite_selected(struct guiObject *obj)
         LCD_DrawRect(obj->box.x+i, obj->box.y+i, obj->box.width-2*i, obj->box.height-2*i, Display.select_color);
 }
 
+#if BACKGROUND_CACHE_SIZE
+/* Background regions cleared by dynamic objects (labels, bargraphs...) are
+ * kept in RAM so that updating them does not need to read and parse the
+ * background image.  A request is served from any cached region containing
+ * it.  Regions are packed at the start of bg_pool in the order they were
+ * allocated, so evicting one moves the following ones down */
+#define BG_REGIONS 12
+#define BG_POOL_SIZE (BACKGROUND_CACHE_SIZE / 2)
+struct bg_region {
+    u16 x, y, w, h;
+    u16 last_used;
+    u16 *data;          // NULL if unused
+};
+static struct bg_region bg_regions[BG_REGIONS];
+static u16 bg_pool[BG_POOL_SIZE];
+static unsigned bg_used;
+static u16 bg_tick;
+
+static void bg_evict(struct bg_region *r)
+{
+    unsigned size = r->w * r->h;
+    u16 *end = r->data + size;
+    memmove(r->data, end, (bg_pool + bg_used - end) * sizeof(u16));
+    for (int i = 0; i < BG_REGIONS; i++) {
+        if (bg_regions[i].data > r->data)
+            bg_regions[i].data -= size;
+    }
+    bg_used -= size;
+    r->data = NULL;
+}
+
+static struct bg_region *bg_find(int x, int y, int w, int h)
+{
+    for (int i = 0; i < BG_REGIONS; i++) {
+        struct bg_region *r = &bg_regions[i];
+        if (r->data && x >= r->x && y >= r->y
+            && x + w <= r->x + r->w && y + h <= r->y + r->h)
+            return r;
+    }
+    return NULL;
+}
+
+static struct bg_region *bg_load(int x, int y, int w, int h)
+{
+    unsigned size = w * h;
+    //Large regions are rarely redrawn and would flush everything else
+    if (size > BG_POOL_SIZE / 2)
+        return NULL;
+    struct bg_region *r;
+    while (1) {
+        struct bg_region *lru = NULL;
+        r = NULL;
+        for (int i = 0; i < BG_REGIONS; i++) {
+            if (! bg_regions[i].data)
+                r = &bg_regions[i];
+            else if (! lru || bg_regions[i].last_used < lru->last_used)
+                lru = &bg_regions[i];
+        }
+        if (r && bg_used + size <= BG_POOL_SIZE)
+            break;
+        bg_evict(lru);
+    }
+    r->x = x;
+    r->y = y;
+    r->w = w;
+    r->h = h;
+    r->data = bg_pool + bg_used;
+    bg_used += size;
+    if (! LCD_ReadWindowedImageFromFile("media/backgrnd" IMG_EXT, r->data, w, h, x, y)) {
+        bg_evict(r);
+        return NULL;
+    }
+    return r;
+}
+
+static void bg_flush()
+{
+    for (int i = 0; i < BG_REGIONS; i++)
+        bg_regions[i].data = NULL;
+    bg_used = 0;
+}
+
+static int bg_draw_cached(int x, int y, int w, int h)
+{
+    struct bg_region *r = bg_find(x, y, w, h);
+    if (! r && ! (r = bg_load(x, y, w, h)))
+        return 0;
+    if (++bg_tick == 0) {
+        //Restart the LRU ordering rather than handle the wrap
+        for (int i = 0; i < BG_REGIONS; i++)
+            bg_regions[i].last_used = 0;
+        bg_tick = 1;
+    }
+    r->last_used = bg_tick;
+    const u16 *row = r->data + (y - r->y) * r->w + (x - r->x);
+    LCD_DrawStart(x, y, x + w - 1, y + h - 1, DRAW_NWSE);
+    for (int j = 0; j < h; j++) {
+        LCD_DrawPixels(row, w);
+        row += r->w;
+    }
+    LCD_DrawStop();
+    return 1;
+}
+#endif
+
 void _gui_draw_background(int x, int y, int w, int h)
 {
     if(Display.background.drawn_background) {
@@ -52,6 +157,10 @@ void _gui_draw_background(int x, int y, int w, int h)
             LCD_FillRect(x, 32, w, h - 32 + y, Display.background.bg_color);
         }
     } else {
+#if BACKGROUND_CACHE_SIZE
+        if (bg_draw_cached(x, y, w, h))
+            return;
+#endif
         LCD_DrawWindowedImageFromFile(x, y, "media/backgrnd" IMG_EXT, w, h, x, y);
     }
 }
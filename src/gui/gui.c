@@ -225,6 +225,14 @@ void GUI_DrawBackground(u16 x, u16 y, u16 w, u16 h)
         _gui_draw_background(x, y, w, h);
 }
 
+// Drops cached copies of the background image (i.e. after it was changed over USB)
+void GUI_FlushBackground()
+{
+#if BACKGROUND_CACHE_SIZE
+    bg_flush();
+#endif
+}
+
 struct guiObject *GUI_IsModal(void)
 {
     struct guiObject *obj = objHEAD;
@@ -285,6 +293,57 @@ void _GUI_RedrawUnderlyingObjects(u16 x, u16 y, u16 w, u16 h)
     }
 }
 
+/* Background redraws needed by a refresh are collected first so that
+ * overlapping or adjacent boxes are drawn once.  Boxes are only merged when
+ * their union is exactly a rectangle, so nothing outside them is cleared */
+#define MAX_DIRTY_RECTS 8
+static struct guiBox dirty_rects[MAX_DIRTY_RECTS];
+static u8 dirty_rect_count;
+
+static void flush_background()
+{
+    for (int i = 0; i < dirty_rect_count; i++)
+        GUI_DrawBackground(dirty_rects[i].x, dirty_rects[i].y, dirty_rects[i].width, dirty_rects[i].height);
+    dirty_rect_count = 0;
+}
+
+static int box_contains(const struct guiBox *a, int x, int y, int w, int h)
+{
+    return x >= a->x && y >= a->y && x + w <= a->x + a->width && y + h <= a->y + a->height;
+}
+
+static void queue_background(int x, int y, int w, int h)
+{
+    if (w == 0 || h == 0)
+        return;
+    int i = 0;
+    while (i < dirty_rect_count) {
+        struct guiBox *r = &dirty_rects[i];
+        if (box_contains(r, x, y, w, h))
+            return;
+        if (box_contains(&(struct guiBox){x, y, w, h}, r->x, r->y, r->width, r->height)
+            || (r->x == x && r->width == w && y <= r->y + r->height && r->y <= y + h)
+            || (r->y == y && r->height == h && x <= r->x + r->width && r->x <= x + w))
+        {
+            //Grow the new box to the union, drop r, and check the others again
+            int x1 = x + w > r->x + r->width ? x + w : r->x + r->width;
+            int y1 = y + h > r->y + r->height ? y + h : r->y + r->height;
+            x = x < r->x ? x : r->x;
+            y = y < r->y ? y : r->y;
+            w = x1 - x;
+            h = y1 - y;
+            *r = dirty_rects[--dirty_rect_count];
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+    if (dirty_rect_count == MAX_DIRTY_RECTS)
+        flush_background();
+    dirty_rects[dirty_rect_count++] = (struct guiBox){x, y, w, h};
+}
+
+// Clears the background of hidden objects and of dirty transparent ones
 void GUI_HideObjects(struct guiObject *headObj, struct guiObject *modalObj)
 {
     struct guiObject *obj;
@@ -292,11 +351,14 @@ void GUI_HideObjects(struct guiObject *headObj, struct guiObject *modalObj)
     obj = headObj ? headObj : modalObj ? modalObj : objHEAD;
     while(obj) {
         if(OBJ_IS_HIDDEN(obj) && OBJ_IS_DIRTY(obj)) {
-            GUI_DrawBackground(obj->box.x, obj->box.y, obj->box.width, obj->box.height);
+            queue_background(obj->box.x, obj->box.y, obj->box.width, obj->box.height);
             OBJ_SET_DIRTY(obj, 0);
+        } else if (OBJ_IS_DIRTY(obj) && OBJ_IS_TRANSPARENT(obj)) {
+            queue_background(obj->box.x, obj->box.y, obj->box.width, obj->box.height);
         }
         obj = obj->next;
     }
+    flush_background();
 }
 
 void _GUI_RefreshScreen(struct guiObject *headObj)
@@ -368,9 +430,8 @@ void _GUI_RefreshScreen(struct guiObject *headObj)
                 //Redraw scrollable contents
                 _GUI_RefreshScreen(((guiScrollable_t *)obj)->head);
             } else if(OBJ_IS_DIRTY(obj)) {
-                if(OBJ_IS_TRANSPARENT(obj) || OBJ_IS_HIDDEN(obj)) {
-                    GUI_DrawBackground(obj->box.x, obj->box.y, obj->box.width, obj->box.height);
-                } else if(obj->Type == Dialog) {
+                //Transparent objects had their background drawn by GUI_HideObjects
+                if(obj->Type == Dialog) {
                     dlg_active = 1;
                     x = obj->box.x;
                     y = obj->box.y;
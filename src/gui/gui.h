@@ -325,6 +325,7 @@ void GUI_DrawRect(struct guiObject *obj);
 
 void GUI_DrawObject(struct guiObject *obj);
 void GUI_DrawBackground(u16 x, u16 y, u16 w, u16 h);
+void GUI_FlushBackground();
 void GUI_DrawImageHelper(u16 x, u16 y, const struct ImageMap *map, u8 idx);
 u8 coords_in_box(struct guiBox *box, struct touch *coords);
 void connect_object(struct guiObject *obj);
@@ -291,63 +291,125 @@ int INPUT_SelectAbbrevSource(int src, int dir)
 }
 
 
-void INPUT_CheckChanges(void) {
-    static s8 last_analogs[INP_HAS_CALIBRATION+1];
+/* The mixer reads every input on each run anyway, so it compares them with
+ * the last reported state and queues the changes.  Like the trace rings, the
+ * queue has a single producer (the mixer interrupt; MIXER_RecalcChannels does
+ * not queue) and a single consumer (the main loop), so head is only written by
+ * the mixer and tail by the main loop.  INPUT_CheckChanges handles the GUI and
+ * voice itself and passes the events on to any registered handlers */
+#define EVENT_MASK (INPUT_EVENT_QUEUE - 1)
+#define ANALOG_THRESHOLD 35  // In units of 128
+ctassert(((INPUT_EVENT_QUEUE & EVENT_MASK) == 0 && INPUT_EVENT_QUEUE <= 256), input_event_queue_size);
+
+static struct InputEvent events[INPUT_EVENT_QUEUE];
+static volatile u8 event_head;
+static volatile u8 event_tail;
+static struct InputHandler *handlers;
+static s8 last_analogs[INP_HAS_CALIBRATION+1];
 #ifdef HAS_MORE_THAN_32_INPUTS
-    static u64 last_switches;
-    u64 switch_mask = 1;
+static u64 last_switches;
 #else
-    static u32 last_switches;
-    u32 switch_mask = 1;
+static u32 last_switches;
 #endif
 
-    s32 changed_analog_value;
-    s8 changed_input = INP_NONE;
-    s8 value;
-    for (int i=1; i <= NUM_INPUTS; i++) {
-      if(i <= INP_HAS_CALIBRATION) {
-          changed_analog_value = CHAN_ReadInput(i);
-          value = changed_analog_value >> 7;
-          if (changed_input == INP_NONE && abs(value - last_analogs[i]) > 35) {
-             changed_input = MIXER_MapChannel(i);
-#if HAS_EXTENDED_AUDIO && NUM_AUX_KNOBS
-             if (value - last_analogs[i] > 0)
-                 aux_up = 1;
-             else
-                 aux_up = 0;
+static int queue_event(unsigned input, u8 type, s32 value)
+{
+    u8 head = event_head;
+    if (((head + 1) & EVENT_MASK) == event_tail)
+        return 0;  // Full, retried on the next mixer run
+    events[head].input = input;
+    events[head].type = type;
+    events[head].value = value;
+    COMPILER_BARRIER();  // The event must be complete before it is published
+    event_head = (head + 1) & EVENT_MASK;
+    return 1;
+}
+
+void INPUT_QueueChanges(volatile s32 *raw)
+{
+#ifdef HAS_MORE_THAN_32_INPUTS
+    u64 switch_mask = 1;
+#else
+    u32 switch_mask = 1;
 #endif
-             last_analogs[i] = value;
-          }
-      } else {
-          value = CHAN_ReadInput(i);
-          if (changed_input == INP_NONE && value > 0 && !(last_switches & switch_mask)) {
-             changed_input = i;
-          }
-          if (value > 0)
-              last_switches |= switch_mask;
-          else
-              last_switches &= ~switch_mask;
-          switch_mask <<= 1;
-      }
+    for (int i = 1; i <= INP_HAS_CALIBRATION; i++) {
+        s8 value = raw[i] >> 7;
+        int diff = value - last_analogs[i];
+        if (abs(diff) > ANALOG_THRESHOLD
+            && queue_event(i, diff > 0 ? INPUT_EVENT_INCREASE : INPUT_EVENT_DECREASE, raw[i]))
+        {
+            last_analogs[i] = value;
+        }
     }
-    if (changed_input != INP_NONE) {
-        GUI_HandleInput(changed_input, changed_input <= INP_HAS_CALIBRATION ? changed_analog_value : CHAN_MAX_VALUE);
+    for (int i = INP_HAS_CALIBRATION + 1; i <= NUM_INPUTS; i++, switch_mask <<= 1) {
+        int on = raw[i] > 0;
+        if (on != !!(last_switches & switch_mask)
+            && queue_event(i, on ? INPUT_EVENT_ON : INPUT_EVENT_OFF, raw[i]))
+        {
+            last_switches ^= switch_mask;
+        }
+    }
+}
+
+static void handle_event(const struct InputEvent *event)
+{
+    if (event->type == INPUT_EVENT_OFF)
+        return;
+    GUI_HandleInput(event->input, event->input <= INP_HAS_CALIBRATION ? event->value : CHAN_MAX_VALUE);
 #if HAS_EXTENDED_AUDIO
-        s8 music_idx;
 #if NUM_AUX_KNOBS
-        if ((changed_input > NUM_STICKS) && (changed_input <= NUM_STICKS + NUM_AUX_KNOBS)) {
-            music_idx = changed_input - (NUM_STICKS+1);
-            aux_time[music_idx] = CLOCK_getms();
-            aux_changed = music_idx + 1;
-            return;
-	    }
+    if ((event->input > NUM_STICKS) && (event->input <= NUM_STICKS + NUM_AUX_KNOBS)) {
+        s8 music_idx = event->input - (NUM_STICKS+1);
+        aux_up = event->type == INPUT_EVENT_INCREASE;
+        aux_time[music_idx] = CLOCK_getms();
+        aux_changed = music_idx + 1;
+        return;
+    }
 #endif
-	    music_idx = changed_input - INP_HAS_CALIBRATION - 1;
-	    /* Skip pots & Play music file if the switch has a voice file number defined */
-	    if (changed_input >= INP_HAS_CALIBRATION && Model.voice.switches[music_idx].music) {
+    /* Skip pots & Play music file if the switch has a voice file number defined */
+    if (event->input > INP_HAS_CALIBRATION) {
+        s8 music_idx = event->input - INP_HAS_CALIBRATION - 1;
+        if (Model.voice.switches[music_idx].music)
             MUSIC_Play(Model.voice.switches[music_idx].music);
-        }
+    }
 #endif //HAS_EXTENDED_AUDIO
+}
+
+void INPUT_RegisterHandler(struct InputHandler *handler, unsigned types,
+                           void (*callback)(const struct InputEvent *event, void *data), void *data)
+{
+    INPUT_UnregisterHandler(handler);
+    handler->types = types;
+    handler->callback = callback;
+    handler->data = data;
+    handler->next = handlers;
+    handlers = handler;
+}
+
+void INPUT_UnregisterHandler(struct InputHandler *handler)
+{
+    struct InputHandler **ptr;
+    for (ptr = &handlers; *ptr; ptr = &(*ptr)->next) {
+        if (*ptr == handler) {
+            *ptr = handler->next;
+            return;
+        }
+    }
+}
+
+void INPUT_CheckChanges(void) {
+    u8 tail = event_tail;
+    while (tail != event_head) {
+        COMPILER_BARRIER();  // Read the event only after head
+        struct InputEvent event = events[tail];
+        COMPILER_BARRIER();  // and release its slot only after reading it
+        tail = (tail + 1) & EVENT_MASK;
+        event_tail = tail;
+        handle_event(&event);
+        for (struct InputHandler *ptr = handlers; ptr; ptr = ptr->next) {
+            if (ptr->types & (1 << event.type))
+                ptr->callback(&event, ptr->data);
+        }
     }
 #if HAS_EXTENDED_AUDIO && NUM_AUX_KNOBS
     // Play AUX music if value was changed and left for 1000 ms at the same value
@@ -365,3 +427,6 @@ void INPUT_CheckChanges(void) {
     }
 #endif // HAS_EXTENDED_AUDIO && NUM_AUX_KNOBS
 }
+
+#define TESTNAME inputs
+#include <tests.h>
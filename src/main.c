@@ -26,6 +26,8 @@
 #include "config/display.h"
 #include "rtc.h"
 #include "extended_audio.h"
+#include "profile.h"
+#include "trace.h"
 
 void Init();
 void Banner();
@@ -80,6 +82,9 @@ int main() {
 #if HAS_DATALOG
     DATALOG_Init();
 #endif
+#if SUPPORT_TRACE
+    TRACE_Init();
+#endif
 
     priority_ready = 0;
     CLOCK_SetMsecCallback(LOW_PRIORITY, LOW_PRIORITY_MSEC);
@@ -153,6 +158,7 @@ void Init() {
     CLOCK_Init();
     UART_Initialize();
     printf("Start\n");
+    CRC_Init();
     Initialize_ButtonMatrix();
     STORAGE_Init();  // This must come before LCD_Init() for 7e
 
@@ -223,6 +229,9 @@ void EventLoop()
             PAGE_Test();
             CONFIG_SaveModelIfNeeded();
             CONFIG_SaveTxIfNeeded();
+#if HAS_DATALOG
+            DATALOG_Flush();
+#endif
         }
     	if(Transmitter.music_shutdown) {
 #if HAS_EXTENDED_AUDIO
@@ -254,6 +263,12 @@ void EventLoop()
     BUTTON_Handler();
     TOUCH_Handler();
     INPUT_CheckChanges();
+#if SUPPORT_ISR_PROFILE
+    PROFILE_Update();
+#endif
+#if SUPPORT_TRACE
+    TRACE_Update();
+#endif
 
     if (priority_ready & (1 << LOW_PRIORITY)) {
         priority_ready  &= ~(1 << LOW_PRIORITY);
@@ -274,7 +289,7 @@ void EventLoop()
 #endif
         GUI_RefreshScreen();
 #if HAS_HARD_POWER_OFF
-        if (PAGE_ModelDoneEditing())
+        if (CONFIG_ScanModelChanges() && PAGE_ModelDoneEditing())
             CONFIG_SaveModelIfNeeded();
         CONFIG_SaveTxIfNeeded();
 #endif
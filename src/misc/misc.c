@@ -29,29 +29,6 @@ void Delay(u32 count)
     }
 }
 
-//The folloiwng code came from: http://notabs.org/winzipcrc/winzipcrc.c
-// C99 winzip crc function, by Scott Duplichan
-//We could use the internal CRC implementation in the STM32, but this is really small
-//and perfomrance isn't really an issue
-u32 Crc(const void *buffer, u32 size)
-{
-   u32 crc = ~0;
-   const u8  *position = buffer;
-
-   while (size--) 
-      {
-      int bit;
-      crc ^= *position++;
-      for (bit = 0; bit < 8; bit++) 
-         {
-         s32 out = crc & 1;
-         crc >>= 1;
-         crc ^= -out & 0xEDB88320;
-         }
-      }
-   return ~crc;
-}
-
 /* Note that the following does no error checking on whether the string
  * is valid utf-8 or even if the length is ok.  Caveat Emptor.
  */
@@ -26,6 +26,7 @@
 #include "config/tx.h"
 #include "music.h"
 #include "target.h"
+#include "trace.h"
 #include <stdlib.h>
 
 #define MIXER_CYC1 (NUM_TX_INPUTS + 1)
@@ -56,15 +57,45 @@ static volatile s32 raw[NUM_SOURCES + 1];
 static buttonAction_t button_action;
 static unsigned switch_is_on(unsigned sw, volatile s32 *raw);
 static s32 get_trim(unsigned src);
+static s32 apply_mux(struct Mixer *mixer, s32 value, s32 scaled_value, s32 *orig_value);
 
 // keep track of interval between calls to MIXER_CalcChannels
 // for calculation of MUX_DELAY and ApplyLimits
 // Period depends on protocol for protocols that run mixer manually
 static u32 mixer_period;
 static u32 prev_calcchannels_ms;
+// Set while the main loop runs the mixer, which must not feed the input
+// event queue or the trace ring since those only allow the mixer interrupt
+// as producer
+static volatile u8 main_loop_mixer;
 
 static void MIXER_CreateCyclicOutput(volatile s32 *raw, s32 *cyclic);
 
+// Compiled mixer program
+// MIXER_CompileMixers() lowers Model.mixers into a flat list of pre-decoded
+// operations so that MIXER_CalcChannels() does not need to decode the
+// src/sw/flags bitfields or search the trim list on every iteration.
+// op[i] always corresponds to Model.mixers[i] (the mixers are already stored in
+// dependency order by MIXER_SetMixers).  Scalar and offset are still read from the
+// mixer so that they can be edited in place without a recompile.  Curve points edited
+// in place need a recompile to update the curve's tangent table.
+#define OP_SRC_INV    0x10
+#define OP_SW_INV     0x20
+#define OP_APPLY_TRIM 0x40
+#define OP_MUX(x)     ((x)->flags & 0x0F)
+struct MixerOp {
+    u8 src;     // raw[] index of the source
+    u8 sw;      // raw[] index of the switch (0 = always on)
+    u8 dest;    // raw[] index of the destination
+    u8 flags;   // mux type | OP_*
+    s8 trim;    // index into Model.trims or -1 if there is no trim for src
+    s8 curve;   // curve table (see CURVE_CreateTable) or -1
+};
+static struct {
+    volatile unsigned count;
+    struct MixerOp op[NUM_MIXERS];
+} program;
+
 struct Mixer *MIXER_GetAllMixers()
 {
     return Model.mixers;
@@ -96,6 +127,87 @@ void MIXER_EvalMixers(volatile s32 *raw)
 
 }
 
+static s8 find_trim(unsigned src)
+{
+    for (int i = 0; i < NUM_TRIMS; i++) {
+        if (MIXER_MapChannel(Model.trims[i].src) == src)
+            return i;
+    }
+    return -1;
+}
+
+// Must be called whenever the mixer list, the trim sources or the stick mode change
+// Only call this from the main loop: the mixer ISR may run while we rebuild, so the
+// program (and the curve tables it uses) is hidden until it is complete
+void MIXER_CompileMixers()
+{
+    unsigned count;
+    program.count = 0;
+    COMPILER_BARRIER();
+    CURVE_ResetTables();
+    for (count = 0; count < NUM_MIXERS; count++) {
+        struct Mixer *mixer = &Model.mixers[count];
+        struct MixerOp *op = &program.op[count];
+        if (MIXER_SRC(mixer->src) == 0)
+            break;
+        op->src = MIXER_SRC(mixer->src);
+        op->sw = MIXER_SRC(mixer->sw);
+        op->dest = mixer->dest + NUM_INPUTS + 1;
+        op->flags = MIXER_MUX(mixer);
+        if (MIXER_SRC_IS_INV(mixer->src))
+            op->flags |= OP_SRC_INV;
+        if (MIXER_SRC_IS_INV(mixer->sw))
+            op->flags |= OP_SW_INV;
+        op->curve = CURVE_CreateTable(&mixer->curve);
+        op->trim = -1;
+        if (MIXER_APPLY_TRIM(mixer)) {
+            op->trim = find_trim(op->src);
+            if (op->trim >= 0)
+                op->flags |= OP_APPLY_TRIM;
+        }
+    }
+    COMPILER_BARRIER();
+    program.count = count;
+}
+
+static void MIXER_RunProgram(volatile s32 *raw)
+{
+    unsigned i;
+    unsigned count = program.count;
+    s32 orig_value[NUM_CHANNELS];
+    for (i = 0; i < NUM_CHANNELS; i++) {
+        orig_value[i] = raw[i + NUM_INPUTS + 1];
+    }
+    for (i = 0; i < count; i++) {
+        const struct MixerOp *op = &program.op[i];
+        struct Mixer *mixer = &Model.mixers[i];
+        s32 value;
+        if (op->sw) {
+            value = raw[op->sw];
+            if (op->flags & OP_SW_INV)
+                value = -value;
+            if (value <= 0)
+                continue;
+        }
+        value = raw[op->src];
+        if (op->flags & OP_SRC_INV)
+            value = -value;
+        value = CURVE_EvaluateTable(value, &mixer->curve, op->curve);
+        value = value * mixer->scalar / 100 + PCT_TO_RANGE(mixer->offset);
+        if (OP_MUX(op) != MUX_REPLACE)
+            value = apply_mux(mixer, value, raw[op->dest], &orig_value[op->dest - NUM_INPUTS - 1]);
+        if (op->flags & OP_APPLY_TRIM) {
+            s32 trim = MIXER_GetTrimValue(op->trim);
+            value += (op->flags & OP_SRC_INV) ? -trim : trim;
+        }
+        if (value > INT16_MAX)
+            value = INT16_MAX;
+        else if (value < INT16_MIN)
+            value = INT16_MIN;
+        raw[op->dest] = value;
+    }
+}
+
 unsigned MIXER_MapChannel(unsigned channel)
 {
     switch(Transmitter.mode) {
@@ -154,6 +266,8 @@ static void MIXER_UpdateRawInputs()
         }
         raw[i] = CHAN_ReadInput(mapped_channel);
     }
+    if (! main_loop_mixer)
+        INPUT_QueueChanges(raw);
     if (PPMin_Mode() == PPM_IN_SOURCE && ppmSync) {
         for (i = 0; i < Model.num_ppmin_channels; i++) {
             raw[1 + NUM_INPUTS + NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS + i] = ppmChannels[i];
@@ -184,8 +298,10 @@ void MIXER_CalcChannels()
     int i;
     //1st step: Read Tx inputs
     MIXER_UpdateRawInputs();
+    BENCH_MixerStep(MIXERSTEP_INPUTS);
     //3rd steps
-    MIXER_EvalMixers(raw);
+    MIXER_RunProgram(raw);
+    BENCH_MixerStep(MIXERSTEP_MIXERS);
 
     //4th step: apply auto-templates
     s32 cyclic[3];
@@ -199,10 +315,23 @@ void MIXER_CalcChannels()
                 break;
         }
     }
+    BENCH_MixerStep(MIXERSTEP_CYCLIC);
     //5th step: apply limits
     for (i = 0; i < NUM_OUT_CHANNELS; i++) {
         Channels[i] = MIXER_GetChannel(i, APPLY_ALL);
     }
+    BENCH_MixerStep(MIXERSTEP_LIMITS);
+    if (! main_loop_mixer)
+        TRACE_Channels();
+}
+
+void MIXER_RecalcChannels()
+{
+    main_loop_mixer = 1;
+    COMPILER_BARRIER();
+    MIXER_CalcChannels();
+    COMPILER_BARRIER();
+    main_loop_mixer = 0;
 }
 
 volatile s32 *MIXER_GetInputs()
@@ -296,29 +425,8 @@ void MIXER_CreateCyclicOutput(volatile s32 *raw, s32 *cyclic)
     }
 }
 
-void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value)
+static s32 apply_mux(struct Mixer *mixer, s32 value, s32 scaled_value, s32 *orig_value)
 {
-    s32 value;
-    if (! MIXER_SRC(mixer->src))
-        return;
-    if (! switch_is_on(mixer->sw, raw)) {
-        // Switch is off, so this mixer is not active
-        return;
-    }
-    //1st: Get source value with trim
-    value = raw[MIXER_SRC(mixer->src)];
-    //Invert if necessary
-    if (MIXER_SRC_IS_INV(mixer->src))
-        value = - value;
-
-    //2nd: apply curve
-    value = CURVE_Evaluate(value, &mixer->curve);
-
-    //3rd: apply scalar and offset
-    value = value * mixer->scalar / 100 + PCT_TO_RANGE(mixer->offset);
-
-    //4th: multiplex result
-    s32 scaled_value = raw[mixer->dest + NUM_INPUTS + 1];
     switch(MIXER_MUX(mixer)) {
     case MUX_REPLACE:
         break;
@@ -392,6 +500,32 @@ void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value)
 #endif
     case MUX_LAST: break;
     }
+    return value;
+}
+
+void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value)
+{
+    s32 value;
+    if (! MIXER_SRC(mixer->src))
+        return;
+    if (! switch_is_on(mixer->sw, raw)) {
+        // Switch is off, so this mixer is not active
+        return;
+    }
+    //1st: Get source value with trim
+    value = raw[MIXER_SRC(mixer->src)];
+    //Invert if necessary
+    if (MIXER_SRC_IS_INV(mixer->src))
+        value = - value;
+
+    //2nd: apply curve
+    value = CURVE_Evaluate(value, &mixer->curve);
+
+    //3rd: apply scalar and offset
+    value = value * mixer->scalar / 100 + PCT_TO_RANGE(mixer->offset);
+
+    //4th: multiplex result
+    value = apply_mux(mixer, value, raw[mixer->dest + NUM_INPUTS + 1], orig_value);
 
     //5th: apply trim
     if (MIXER_APPLY_TRIM(mixer))
@@ -514,6 +648,7 @@ void MIXER_Init()
 {
     memset((void *)Channels, 0, sizeof(Channels));
     memset((void *)raw, 0, sizeof(raw));
+    MIXER_CompileMixers();
     //memset(&Model, 0, sizeof(Model));
 }
 
@@ -691,6 +826,7 @@ int MIXER_SetMixers(struct Mixer *mixers, int count)
         }
     }
     fix_mixer_dependencies(pos);
+    MIXER_CompileMixers();
     return 1;
 }
 
@@ -188,6 +188,9 @@ struct Trim {
 
 /* Curve functions */
 s32 CURVE_Evaluate(s32 value, struct Curve *curve);
+s32 CURVE_EvaluateTable(s32 value, struct Curve *curve, int table);
+int CURVE_CreateTable(struct Curve *curve);
+void CURVE_ResetTables();
 const char *CURVE_GetName(char *str, struct Curve *curve);
 unsigned CURVE_NumPoints(struct Curve *curve);
 
@@ -210,6 +213,7 @@ void MIXER_InitMixer(struct Mixer *mixer, unsigned ch);
 
 void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value);
 void MIXER_EvalMixers(volatile s32 *raw);
+void MIXER_CompileMixers();
 int MIXER_GetCachedInputs(s32 *raw, unsigned threshold);
 
 struct Mixer *MIXER_GetAllMixers();
@@ -233,4 +237,18 @@ int MIXER_SourceAsBoolean(unsigned src);
 
 void MIXER_Init();
 
+/* Called at the end of each step of MIXER_CalcChannels by the benchmark target */
+enum MixerStep {
+    MIXERSTEP_INPUTS,
+    MIXERSTEP_MIXERS,
+    MIXERSTEP_CYCLIC,
+    MIXERSTEP_LIMITS,
+    MIXERSTEP_LAST,
+};
+#ifdef MIXER_BENCHMARK
+void BENCH_MixerStep(enum MixerStep step);
+#else
+#define BENCH_MixerStep(x)
+#endif
+
 #endif
@@ -116,6 +116,7 @@ void STDMIXER_SetChannelOrderByProtocol()
             Model.timer[i].src = mapped_std_channels.throttle + NUM_INPUTS +1;
         TIMER_Reset(i);
     }
+    MIXER_CompileMixers();
     CLOCK_ResetWatchdog();
 }
 
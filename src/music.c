@@ -18,13 +18,40 @@
 #include "config/tx.h"
 #include "extended_audio.h"
 #include "config/model.h"
+#include "config/ini.h"
 #include <stdlib.h>
 
-static struct {u8 note; u8 duration;} Notes[100];
+struct Note {
+    u8 note;
+    u8 duration;
+};
+static struct Note Notes[100];
+static const struct Note *notes;
 static u8 Volume;
 static u8 next_note;
 static u8 num_notes;
 
+/* sound.ini is parsed on first use (and again after MUSIC_ReloadSounds) into a
+ * table of notes which every sound indexes into.  As before, each key of a section (including volume,
+ * vibrate and device) takes one entry.  Sections that do not fit in the table
+ * are parsed from the file when played */
+#define SOUND_UNCACHED    0x01
+#define SOUND_VIBRATE_OFF 0x02
+#define SOUND_NO_VOLUME   0xff
+static struct {
+    u8 start;
+    u8 count;
+    u8 volume;   // 0 - 100 from sound.ini or SOUND_NO_VOLUME
+    u8 flags;
+#if HAS_EXTENDED_AUDIO
+    u8 device;
+#endif
+} sounds[MUSIC_TOTAL];
+static struct Note sound_table[SOUND_TABLE_SIZE];
+static u8 sound_table_used;
+static u8 sounds_loaded;   // 0: not yet, 1: loaded, 2: could not read sound.ini
+ctassert((SOUND_TABLE_SIZE < 256), sound_table_too_big);
+
 #if NUM_TIMERS > 4
 #error "Number of timers is != 4.  This will cause the Alarm music to not work properly"
 #endif
@@ -118,7 +145,10 @@ static u8 get_note(const char *value)
 static int ini_handler(void* user, const char* section, const char* name, const char* value)
 {
     const char *requested_sec = (const char *)user;
-    if (strcasecmp(section, requested_sec) == 0) {
+    static u8 in_section;
+    if (ini_section_changed())
+        in_section = strcasecmp(section, requested_sec) == 0;
+    if (in_section) {
 #if HAS_EXTENDED_AUDIO
         if (strcasecmp("device", name) == 0) {
             for (u16 i = 1; i < AUDDEV_LAST; i++) {
@@ -141,6 +171,8 @@ static int ini_handler(void* user, const char* section, const char* name, const
             // The music volume should be controlled by TX volume setting as well as sound.ini
             Volume = Transmitter.volume * Volume/10; // = Transmitter.volume * 10 * sound_volume/100;
         }
+        if (num_notes == sizeof(Notes) / sizeof(Notes[0]))
+            return 1;
         Notes[num_notes].note = get_note(name);
         Notes[num_notes].duration = atoi(value) / 10; //convert from msec to centi-secs
         num_notes++;
@@ -149,11 +181,58 @@ static int ini_handler(void* user, const char* section, const char* name, const
     return 1;
 }
 
+static int load_handler(void* user, const char* section, const char* name, const char* value)
+{
+    (void)user;
+    static int music;
+    if (ini_section_changed()) {
+        for (music = 0; music < MUSIC_TOTAL; music++) {
+            if (strcasecmp(section, sections[music]) == 0)
+                break;
+        }
+        //Repeated sections would not be contiguous in the table
+        if (music < MUSIC_TOTAL && sounds[music].count)
+            sounds[music].flags |= SOUND_UNCACHED;
+    }
+    if (music == MUSIC_TOTAL || (sounds[music].flags & SOUND_UNCACHED))
+        return 1;
+    if (sound_table_used == SOUND_TABLE_SIZE) {
+        sounds[music].flags |= SOUND_UNCACHED;
+        return 1;
+    }
+    if (! sounds[music].count)
+        sounds[music].start = sound_table_used;
+#if HAS_EXTENDED_AUDIO
+    if (strcasecmp("device", name) == 0) {
+        for (u16 i = 1; i < AUDDEV_LAST; i++) {
+            if (strcasecmp(audio_devices[i], value) == 0) {
+                sounds[music].device = i;
+                break;
+            }
+        }
+    }
+#endif
+    if (strcasecmp("vibrate", name) == 0) {
+        if (strcasecmp(value, "off") == 0) {
+            sounds[music].flags |= SOUND_VIBRATE_OFF;
+        }
+    }
+    if (strcasecmp("volume", name) == 0) {
+        int volume = atoi(value);
+        sounds[music].volume = volume > 100 ? 100 : volume;
+    }
+    sound_table[sound_table_used].note = get_note(name);
+    sound_table[sound_table_used].duration = atoi(value) / 10; //convert from msec to centi-secs
+    sound_table_used++;
+    sounds[music].count++;
+    return 1;
+}
+
 u16 next_note_cb() {
     if (next_note == num_notes)
         return 0;
-    SOUND_SetFrequency(get_freq(Notes[next_note].note), Volume);
-    return Notes[next_note++].duration * 10;
+    SOUND_SetFrequency(get_freq(notes[next_note].note), Volume);
+    return notes[next_note++].duration * 10;
 }
 
 void MUSIC_Beep(char* note, u16 duration, u16 interval, u8 count)
@@ -166,6 +245,7 @@ void MUSIC_Beep(char* note, u16 duration, u16 interval, u8 count)
         return;
     if(count > sizeof(Notes)/2)
         count = sizeof(Notes)/2;
+    notes = Notes;
     tone = get_note(note);
     num_notes = count*2;
     for(i=0; i<count; i++) {
@@ -178,32 +258,82 @@ void MUSIC_Beep(char* note, u16 duration, u16 interval, u8 count)
     SOUND_Start((u16)Notes[0].duration * 10, next_note_cb, vibrate);
 }
 
-u16 MUSIC_GetSound(u16 music) {
-    num_notes = 0;
-    next_note = 1;
-    Volume = Transmitter.volume * 10;
+#ifdef _DEVO12_TARGET_H_
+static u8 sound_file_checked;
+#endif
+static const char *sound_file()
+{
     #ifdef _DEVO12_TARGET_H_
     static char filename[] = "media/sound.ini\0\0\0"; // placeholder for longer folder name
-    static u8 checked;
-        if(!checked) {
+        if(!sound_file_checked) {
+            sprintf(filename, "media/sound.ini");
             FILE *fh;
             fh = fopen("mymedia/sound.ini", "r");
             if(fh) {
                 sprintf(filename, "mymedia/sound.ini");
                 fclose(fh);
             }
-            checked = 1;
+            sound_file_checked = 1;
         }
+    return filename;
     #else
-    char filename[] = "media/sound.ini";
+    return "media/sound.ini";
     #endif
+}
+
+static void load_sounds()
+{
+    memset(sounds, 0, sizeof(sounds));
+    for (int i = 0; i < MUSIC_TOTAL; i++)
+        sounds[i].volume = SOUND_NO_VOLUME;
+    sound_table_used = 0;
+    sounds_loaded = 1;
+    if(CONFIG_IniParse(sound_file(), load_handler, NULL)) {
+        printf("ERROR: Could not read %s\n", sound_file());
+        sounds_loaded = 2;
+    }
+}
+
+// sound.ini may have changed (i.e. while the filesystem was exported over USB)
+void MUSIC_ReloadSounds()
+{
+    sounds_loaded = 0;
+#ifdef _DEVO12_TARGET_H_
+    sound_file_checked = 0;
+#endif
+}
+
+u16 MUSIC_GetSound(u16 music) {
+    num_notes = 0;
+    next_note = 1;
+    Volume = Transmitter.volume * 10;
     if (music >= MUSIC_TOTAL) {
         printf("ERROR: Music %d can not be found in sound.ini", music);
         return 1;
     }
-    if(CONFIG_IniParse(filename, ini_handler, (void *)sections[music])) {
-        printf("ERROR: Could not read %s\n", filename);
+    if (! sounds_loaded)
+        load_sounds();
+    if (sounds_loaded != 1)
         return 1;
+    if (sounds[music].flags & SOUND_UNCACHED) {
+        notes = Notes;
+        if(CONFIG_IniParse(sound_file(), ini_handler, (void *)sections[music])) {
+            printf("ERROR: Could not read %s\n", sound_file());
+            return 1;
+        }
+        return 0;
+    }
+    notes = &sound_table[sounds[music].start];
+    num_notes = sounds[music].count;
+#if HAS_EXTENDED_AUDIO
+    if (sounds[music].device)
+        playback_device = sounds[music].device;
+#endif
+    if (sounds[music].flags & SOUND_VIBRATE_OFF)
+        vibrate = 0;
+    if (sounds[music].volume != SOUND_NO_VOLUME) {
+        // The music volume should be controlled by TX volume setting as well as sound.ini
+        Volume = Transmitter.volume * sounds[music].volume / 10;
     }
     return 0;
 }
@@ -239,8 +369,8 @@ void MUSIC_Play(u16 music)
 #endif
 
     if(! num_notes) return;
-    SOUND_SetFrequency(get_freq(Notes[next_note].note), Volume);
-    SOUND_Start((u16)Notes[0].duration * 10, next_note_cb, vibrate);
+    SOUND_SetFrequency(get_freq(notes[next_note].note), Volume);
+    SOUND_Start((u16)notes[0].duration * 10, next_note_cb, vibrate);
 }
 
 #if HAS_EXTENDED_AUDIO
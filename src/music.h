@@ -124,5 +124,6 @@ void MUSIC_PlayValue(u16 music, s32 value, u8 unit, u8 prec);
 void MUSIC_Beep(char* note, u16 duration, u16 interval, u8 count);
 
 void MUSIC_Play(u16 music);
+void MUSIC_ReloadSounds();
 
 #endif
@@ -35,6 +35,9 @@ PAGEDEF(PAGEID_USB,      PAGE_USBInit,         PAGE_USBEvent,         PAGE_USBEx
 #if DEBUG_WINDOW_SIZE
 PAGEDEF(PAGEID_DEBUGLOG, PAGE_DebuglogInit,    PAGE_DebuglogEvent,    NULL,               MAIN_MENU,   _tr_noop("Debuglog"))
 #endif
+#if SUPPORT_ISR_PROFILE
+PAGEDEF(PAGEID_PROFILE,  PAGE_ProfileInit,     PAGE_ProfileEvent,     NULL,               MAIN_MENU,   _tr_noop("ISR profile"))
+#endif
 PAGEDEF(PAGEID_ABOUT,    PAGE_AboutInit,       NULL,                  NULL,               MAIN_MENU,   _tr_noop("About Deviation"))
 
 //Model menu
@@ -0,0 +1,54 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OVERRIDE_PLACEMENT
+#include "common.h"
+#include "pages.h"
+#include "gui/gui.h"
+#include "profile.h"
+
+enum {
+    NAME_WIDTH   = 30,
+    BUTTON_WIDTH = 40,
+};
+#endif //OVERRIDE_PLACEMENT
+
+#if SUPPORT_ISR_PROFILE
+#include "../common/_profile_page.c"
+
+static int row_cb(int absrow, int relrow, int y, void *data)
+{
+    (void)data;
+    GUI_CreateLabelBox(&gui->name[relrow], 0, y, NAME_WIDTH, LINE_HEIGHT, &LIST_FONT, name_cb, NULL, (void *)(long)absrow);
+    GUI_CreateLabelBox(&gui->value[relrow], NAME_WIDTH, y, LCD_WIDTH - NAME_WIDTH - ARROW_WIDTH, LINE_HEIGHT,
+                       &LIST_FONT, value_cb, NULL, (void *)(long)absrow);
+    return 0;
+}
+
+void PAGE_ProfileInit(int page)
+{
+    (void)page;
+    PAGE_ShowHeader(PAGE_GetName(PAGEID_PROFILE));
+    PAGE_SetModal(0);
+    next_update = 0;
+
+    GUI_CreateButtonPlateText(&gui->reset, 0, HEADER_HEIGHT, BUTTON_WIDTH, LINE_HEIGHT, &BUTTON_FONT,
+                              reset_str_cb, reset_press_cb, NULL);
+    GUI_CreateButtonPlateText(&gui->save, LCD_WIDTH - BUTTON_WIDTH, HEADER_HEIGHT, BUTTON_WIDTH, LINE_HEIGHT, &BUTTON_FONT,
+                              save_str_cb, save_press_cb, NULL);
+    GUI_CreateScrollable(&gui->scrollable, 0, HEADER_HEIGHT + LINE_SPACE, LCD_WIDTH, LCD_HEIGHT - HEADER_HEIGHT - LINE_SPACE,
+                         LINE_SPACE, PROFILE_ROWS, row_cb, NULL, NULL, NULL);
+}
+#endif //SUPPORT_ISR_PROFILE
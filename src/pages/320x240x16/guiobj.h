@@ -399,6 +399,15 @@ struct debuglog_obj {
     guiScrollable_t scrollable;
 };
 
+struct profile_obj {
+    guiLabel_t      legend;
+    guiButton_t     reset;
+    guiButton_t     save;
+    guiLabel_t      name[DEBUG_LINE_COUNT];
+    guiLabel_t      value[DEBUG_LINE_COUNT];
+    guiScrollable_t scrollable;
+};
+
 #ifdef HAS_MUSIC_CONFIG
 struct voiceconfig_obj {
     guiLabel_t msg;
@@ -655,6 +664,9 @@ struct _gui_objs {
         struct usb_obj usb;
         struct rtc_obj rtc;
         struct debuglog_obj debuglog;
+#if SUPPORT_ISR_PROFILE
+        struct profile_obj profile;
+#endif
 #ifdef HAS_MUSIC_CONFIG
         struct voiceconfig_obj voiceconfig;
 #endif
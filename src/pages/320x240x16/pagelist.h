@@ -34,6 +34,9 @@ PAGEDEF(PAGEID_USB,      PAGE_USBInit,         PAGE_USBEvent,         PAGE_USBEx
 #if DEBUG_WINDOW_SIZE
 PAGEDEF(PAGEID_DEBUGLOG, PAGE_DebuglogInit,    PAGE_DebuglogEvent,    NULL,               MAIN_MENU,   _tr_noop("Debuglog"))
 #endif
+#if SUPPORT_ISR_PROFILE
+PAGEDEF(PAGEID_PROFILE,  PAGE_ProfileInit,     PAGE_ProfileEvent,     NULL,               MAIN_MENU,   _tr_noop("ISR profile"))
+#endif
 
 //Model menu
 //----------
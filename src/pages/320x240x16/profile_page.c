@@ -0,0 +1,45 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "pages.h"
+#include "gui/gui.h"
+#include "profile.h"
+
+#if SUPPORT_ISR_PROFILE
+#include "../common/_profile_page.c"
+
+static int row_cb(int absrow, int relrow, int y, void *data)
+{
+    (void)data;
+    GUI_CreateLabelBox(&gui->name[relrow], 5, y, 80, 16, &LIST_FONT, name_cb, NULL, (void *)(long)absrow);
+    GUI_CreateLabelBox(&gui->value[relrow], 90, y, LCD_WIDTH - ARROW_WIDTH - 95, 16, &LIST_FONT, value_cb, NULL, (void *)(long)absrow);
+    return 0;
+}
+
+void PAGE_ProfileInit(int page)
+{
+    (void)page;
+    const int ROW_HEIGHT = 20;
+    PAGE_ShowHeader(PAGE_GetName(PAGEID_PROFILE));
+    next_update = 0;
+
+    GUI_CreateLabelBox(&gui->legend, 5, 40, 160, 16, &LABEL_FONT, NULL, NULL, "min/avg/max/p99 (us)");
+    GUI_CreateButton(&gui->reset, LCD_WIDTH - 64 - 64 - 10, 40, BUTTON_64x16, reset_str_cb, reset_press_cb, NULL);
+    GUI_CreateButton(&gui->save, LCD_WIDTH - 64, 40, BUTTON_64x16, save_str_cb, save_press_cb, NULL);
+    GUI_CreateScrollable(&gui->scrollable,
+         0, 40 + ROW_HEIGHT, LCD_WIDTH, LCD_HEIGHT - 40 - ROW_HEIGHT, ROW_HEIGHT, PROFILE_ROWS, row_cb, NULL, NULL, NULL);
+}
+#endif //SUPPORT_ISR_PROFILE
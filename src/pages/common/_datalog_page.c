@@ -29,7 +29,10 @@ static const char *ratesel_cb(guiObject_t *obj, int dir, void *data)
 {
     (void)obj;
     (void)data;
-    dlog->rate = GUI_TextSelectHelper(dlog->rate, 0, DLOG_RATE_LAST-1, dir, 1, 1, NULL);
+    //Step through the rates from fastest to slowest
+    int idx = (dlog->rate + DLOG_RATE_NUM_FAST) % DLOG_RATE_LAST;
+    idx = GUI_TextSelectHelper(idx, 0, DLOG_RATE_LAST-1, dir, 1, 1, NULL);
+    dlog->rate = (idx + DLOG_RATE_LAST - DLOG_RATE_NUM_FAST) % DLOG_RATE_LAST;
     return _tr(DATALOG_RateString(dlog->rate));
 }
 
@@ -277,7 +277,7 @@ static const char *protoselect_cb(guiObject_t *obj, int dir, void *data)
         if (Model.mixer_mode == MIXER_STANDARD)
             STDMIXER_SetChannelOrderByProtocol();
         else
-            RemapChannelsForProtocol(oldmap);
+            RemapChannelsForProtocol(oldmap);  //Recompiles the mixers after remapping them
         configure_bind_button();
     }
     GUI_TextSelectEnablePress((guiTextSelect_t *)obj,
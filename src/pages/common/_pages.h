@@ -169,6 +169,10 @@ void PAGE_DebuglogInit();
 void PAGE_DebuglogEvent();
 void PAGE_DebuglogExit();
 
+/* ISR profile */
+void PAGE_ProfileInit();
+void PAGE_ProfileEvent();
+
 /* Voiceconfig */
 void PAGE_VoiceconfigInit();
 void PAGE_VoiceconfigEvent();
@@ -0,0 +1,91 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PROFILE_ROWS (PROFILE_SRC_LAST + PROFILE_STATES)
+#define PROFILE_FILE "profile.csv"
+
+static struct profile_obj * const gui = &gui_objs.u.profile;
+static u32 next_update;
+static u8 saved;
+
+static const struct ProfileStats *row_stats(unsigned row)
+{
+    if (row < PROFILE_SRC_LAST)
+        return PROFILE_GetStats(row);
+    return PROFILE_GetStateStats(row - PROFILE_SRC_LAST);
+}
+
+static const char *name_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    unsigned row = (long)data;
+    if (row < PROFILE_SRC_LAST)
+        return PROFILE_Name(row);
+    snprintf(tempstring, sizeof(tempstring), "S%d", row - PROFILE_SRC_LAST);
+    return tempstring;
+}
+
+// min/avg/max/99th percentile in us
+static const char *value_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    const struct ProfileStats *s = row_stats((long)data);
+    if (! s->count)
+        return "-";
+    snprintf(tempstring, sizeof(tempstring), "%d/%d/%d/%d", s->min, (int)(s->total / s->count),
+             s->max, PROFILE_Percentile(s, 99));
+    return tempstring;
+}
+
+static const char *reset_str_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    (void)data;
+    return _tr("Reset");
+}
+
+static void reset_press_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    (void)data;
+    PROFILE_Reset();
+    saved = 0;
+    next_update = 0;
+    GUI_Redraw(&gui->save);
+}
+
+static const char *save_str_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    (void)data;
+    return saved ? _tr("Saved") : _tr("Save");
+}
+
+static void save_press_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    (void)data;
+    saved = PROFILE_Dump(PROFILE_FILE);
+    GUI_Redraw(&gui->save);
+}
+
+void PAGE_ProfileEvent()
+{
+    if (CLOCK_getms() < next_update)
+        return;
+    next_update = CLOCK_getms() + 500;
+    for (int i = 0; i < DEBUG_LINE_COUNT; i++)
+        GUI_Redraw(&gui->value[i]);
+}
@@ -140,6 +140,7 @@ static void okcancel_cb(guiObject_t *obj, const void *data)
         struct Trim *trim = MIXER_GetAllTrims();
         trim[tp->index] = tp->trim;
         MIXER_RegisterTrimButtons();
+        MIXER_CompileMixers();
     }
     PAGE_Pop();
 }
@@ -150,6 +150,7 @@ void PAGE_CalibInit(int page)
     }
     if (calibrate_state == CALI_EXIT)
         memcpy(Transmitter.calibration, cp->calibration, sizeof(cp->calibration));
+    ADC_UpdateCalibration();
 
     PAGE_Pop();
 //    PAGE_SetActionCB(NULL);
@@ -179,7 +180,10 @@ static const char *modeselect_cb(guiObject_t *obj, int dir, void *data)
 {
     (void)data;
     (void)obj;
-    Transmitter.mode = GUI_TextSelectHelper(Transmitter.mode, MODE_1, MODE_4, dir, 1, 1, NULL);
+    u8 changed;
+    Transmitter.mode = GUI_TextSelectHelper(Transmitter.mode, MODE_1, MODE_4, dir, 1, 1, &changed);
+    if (changed)
+        MIXER_CompileMixers();  // trim sources are mapped through the stick mode
     snprintf(tempstring, sizeof(tempstring), _tr("Mode %d"), Transmitter.mode);
     return tempstring;
 }
@@ -33,6 +33,9 @@ unsigned usb_cb(u32 button, unsigned flags, void *data)
         wait_press();
         wait_release();
         MSC_Disable();
+        MUSIC_ReloadSounds();
+        FONT_Flush();
+        GUI_FlushBackground();
         CONFIG_ReadModel(Transmitter.current_model);
         _draw_page(0);
     }
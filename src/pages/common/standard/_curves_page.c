@@ -139,6 +139,7 @@ static void auto_generate_cb(guiObject_t *obj, const void *data)
             x_start = x_end; // no need to calculate
         }
     }
+    MIXER_CompileMixers();  // Rebuild the curve tables
     GUI_Redraw(&gui->graph);
 }
 
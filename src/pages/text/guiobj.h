@@ -227,6 +227,14 @@ struct debuglog_obj {
     guiScrollable_t scrollable;
 };
 
+struct profile_obj {
+    guiButton_t     reset;
+    guiButton_t     save;
+    guiLabel_t      name[DEBUG_LINE_COUNT];
+    guiLabel_t      value[DEBUG_LINE_COUNT];
+    guiScrollable_t scrollable;
+};
+
 #ifdef HAS_MUSIC_CONFIG
 struct voiceconfig_obj {
     guiLabel_t msg;
@@ -392,6 +400,9 @@ struct _gui_objs {
         struct calibrate_obj calibrate;
         struct usb_obj usb;
         struct debuglog_obj debuglog;
+#if SUPPORT_ISR_PROFILE
+        struct profile_obj profile;
+#endif
 #ifdef HAS_MUSIC_CONFIG
         struct voiceconfig_obj voiceconfig;
 #endif
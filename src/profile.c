@@ -0,0 +1,201 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "profile.h"
+
+#if SUPPORT_ISR_PROFILE
+#define RING_SIZE 32  // Must be a power of 2
+ctassert(((RING_SIZE & (RING_SIZE - 1)) == 0), ring_size_not_power_of_2);
+
+/* Each ring has a single producer (its interrupt) and a single consumer
+ * (PROFILE_Update in the main loop), so no locking is needed as long as
+ * head is only written by the producer and tail only by the consumer */
+struct ProfileRing {
+    volatile u8 head;
+    volatile u8 tail;
+    struct IsrCounter dropped;
+    volatile u8 state[RING_SIZE];
+    volatile u16 time[RING_SIZE];
+};
+
+volatile u8 profile_state;
+static struct ProfileRing rings[PROFILE_SRC_LAST];
+static struct ProfileStats stats[PROFILE_SRC_LAST];
+static struct ProfileStats state_stats[PROFILE_STATES];
+static u32 dropped;
+
+void PROFILE_Record(enum ProfileSrc src, u16 start)
+{
+    u16 us = CLOCK_getus() - start;
+    struct ProfileRing *r = &rings[src];
+    u8 head = r->head;
+    u8 next = (head + 1) & (RING_SIZE - 1);
+    if (next == r->tail) {
+        r->dropped.count++;
+        return;
+    }
+    r->time[head] = us;
+    r->state[head] = src == PROFILE_PROTOCOL ? profile_state : 0;
+    r->head = next;
+}
+
+/* Buckets 0-3 hold 0-3us.  Above that, each power of 2 is split in 4 buckets
+ * so the reported percentile is within 25% of the real value */
+static unsigned bucket(u16 us)
+{
+    if (us < 4)
+        return us;
+    unsigned msb = 31 - __builtin_clz(us);
+    return (msb - 1) * 4 + ((us >> (msb - 2)) & 0x03);
+}
+
+static unsigned bucket_max(unsigned idx)
+{
+    if (idx < 4)
+        return idx;
+    unsigned msb = idx / 4 + 1;
+    return ((4 + (idx & 0x03) + 1) << (msb - 2)) - 1;
+}
+
+static void add_sample(struct ProfileStats *s, u16 us)
+{
+    if (! s->count || us < s->min)
+        s->min = us;
+    if (us > s->max)
+        s->max = us;
+    s->count++;
+    s->total += us;
+    unsigned idx = bucket(us);
+    if (s->hist[idx] == 0xffff) {
+        //Halve the histogram to keep the distribution without overflowing
+        for (int i = 0; i < PROFILE_BUCKETS; i++)
+            s->hist[i] /= 2;
+    }
+    s->hist[idx]++;
+}
+
+void PROFILE_Update()
+{
+    for (int src = 0; src < PROFILE_SRC_LAST; src++) {
+        struct ProfileRing *r = &rings[src];
+        u8 tail = r->tail;
+        while (tail != r->head) {
+            u16 us = r->time[tail];
+            add_sample(&stats[src], us);
+            if (src == PROFILE_PROTOCOL) {
+                unsigned state = r->state[tail];
+                add_sample(&state_stats[state < PROFILE_STATES ? state : PROFILE_STATES - 1], us);
+            }
+            tail = (tail + 1) & (RING_SIZE - 1);
+        }
+        r->tail = tail;
+        dropped += ISR_CounterTake(&r->dropped);
+    }
+}
+
+void PROFILE_Reset()
+{
+    for (int src = 0; src < PROFILE_SRC_LAST; src++) {
+        rings[src].tail = rings[src].head;
+        ISR_CounterTake(&rings[src].dropped);
+    }
+    memset(stats, 0, sizeof(stats));
+    memset(state_stats, 0, sizeof(state_stats));
+    dropped = 0;
+}
+
+const struct ProfileStats *PROFILE_GetStats(enum ProfileSrc src)
+{
+    return &stats[src];
+}
+
+const struct ProfileStats *PROFILE_GetStateStats(unsigned state)
+{
+    return &state_stats[state];
+}
+
+u32 PROFILE_Dropped()
+{
+    return dropped;
+}
+
+unsigned PROFILE_Percentile(const struct ProfileStats *s, unsigned pct)
+{
+    u32 total = 0;
+    for (int i = 0; i < PROFILE_BUCKETS; i++)
+        total += s->hist[i];
+    if (! total)
+        return 0;
+    u32 target = (total * pct + 99) / 100;
+    u32 sum = 0;
+    for (int i = 0; i < PROFILE_BUCKETS; i++) {
+        sum += s->hist[i];
+        if (sum >= target) {
+            unsigned max = bucket_max(i);
+            return max < s->max ? max : s->max;
+        }
+    }
+    return s->max;
+}
+
+const char *PROFILE_Name(enum ProfileSrc src)
+{
+    switch (src) {
+        case PROFILE_PROTOCOL: return "protocol";
+        case PROFILE_MIXER:    return "mixer";
+        case PROFILE_SYSTICK:  return "systick";
+        default: return "";
+    }
+}
+
+static void dump_stats(FILE *fh, const char *name, int state, const struct ProfileStats *s)
+{
+    fprintf(fh, "%s,%d,%u,%u,%u,%u,%u", name, state, (unsigned)s->count, s->min,
+            (unsigned)(s->total / s->count), s->max, PROFILE_Percentile(s, 99));
+    for (int i = 0; i < PROFILE_BUCKETS; i++)
+        fprintf(fh, ",%u", s->hist[i]);
+    fprintf(fh, "\n");
+}
+
+int PROFILE_Dump(const char *filename)
+{
+    PROFILE_Update();
+    FILE *fh = fopen(filename, "w");
+    if (! fh) {
+        printf("Couldn't open %s\n", filename);
+        return 0;
+    }
+    //The histogram columns are labeled with the upper limit of each bucket
+    fprintf(fh, "source,state,count,min,avg,max,p99");
+    for (int i = 0; i < PROFILE_BUCKETS; i++)
+        fprintf(fh, ",%u", bucket_max(i));
+    fprintf(fh, "\n");
+    for (int src = 0; src < PROFILE_SRC_LAST; src++) {
+        if (stats[src].count)
+            dump_stats(fh, PROFILE_Name(src), -1, &stats[src]);
+    }
+    for (int state = 0; state < PROFILE_STATES; state++) {
+        if (state_stats[state].count)
+            dump_stats(fh, PROFILE_Name(PROFILE_PROTOCOL), state, &state_stats[state]);
+    }
+    fprintf(fh, "dropped,%u\n", (unsigned)dropped);
+    fclose(fh);
+    return 1;
+}
+#endif //SUPPORT_ISR_PROFILE
+
+#define TESTNAME profile
+#include <tests.h>
@@ -0,0 +1,50 @@
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+/* Interrupt profiling
+ * Each profiled interrupt records its run-time (in us, from CLOCK_getus) into
+ * a small per-source ring buffer.  The main loop drains the rings into
+ * histograms from which min/avg/max and 99th-percentile times are reported.
+ * Protocols may tag the current state with PROFILE_SetState() to get a
+ * per-state breakdown of the protocol timer callback.
+ */
+enum ProfileSrc {
+    PROFILE_PROTOCOL,   // SYSCLK timer callback
+    PROFILE_MIXER,      // medium priority mixer calculation
+    PROFILE_SYSTICK,    // 1ms system tick
+    PROFILE_SRC_LAST,
+};
+
+#define PROFILE_STATES  16  //Per-state stats for the protocol callback. Last entry collects all higher states
+#define PROFILE_BUCKETS 60  //4 buckets per power of 2 covers 0 - 65535us
+
+struct ProfileStats {
+    u32 count;
+    u32 total;
+    u16 min;
+    u16 max;
+    u16 hist[PROFILE_BUCKETS];
+};
+
+#if SUPPORT_ISR_PROFILE
+extern volatile u8 profile_state;
+void PROFILE_Record(enum ProfileSrc src, u16 start);
+#define PROFILE_BEGIN(src)   u16 profile_start_##src = CLOCK_getus()
+#define PROFILE_END(src)     PROFILE_Record(src, profile_start_##src)
+#define PROFILE_SetState(s)  (profile_state = (s))
+#else
+#define PROFILE_BEGIN(src)
+#define PROFILE_END(src)
+#define PROFILE_SetState(s)
+#endif
+
+void PROFILE_Update();
+void PROFILE_Reset();
+const struct ProfileStats *PROFILE_GetStats(enum ProfileSrc src);
+const struct ProfileStats *PROFILE_GetStateStats(unsigned state);
+unsigned PROFILE_Percentile(const struct ProfileStats *stats, unsigned pct);
+u32 PROFILE_Dropped();
+const char *PROFILE_Name(enum ProfileSrc src);
+int PROFILE_Dump(const char *filename);
+
+#endif //_PROFILE_H_
@@ -65,25 +65,6 @@ s8 check_bitrate(u32 rate) {
 }
 
 
-// crc implementation from CRSF protocol document rev7
-static const u8 crc8tab[256] = {
-    0x00, 0xD5, 0x7F, 0xAA, 0xFE, 0x2B, 0x81, 0x54, 0x29, 0xFC, 0x56, 0x83, 0xD7, 0x02, 0xA8, 0x7D,
-    0x52, 0x87, 0x2D, 0xF8, 0xAC, 0x79, 0xD3, 0x06, 0x7B, 0xAE, 0x04, 0xD1, 0x85, 0x50, 0xFA, 0x2F,
-    0xA4, 0x71, 0xDB, 0x0E, 0x5A, 0x8F, 0x25, 0xF0, 0x8D, 0x58, 0xF2, 0x27, 0x73, 0xA6, 0x0C, 0xD9,
-    0xF6, 0x23, 0x89, 0x5C, 0x08, 0xDD, 0x77, 0xA2, 0xDF, 0x0A, 0xA0, 0x75, 0x21, 0xF4, 0x5E, 0x8B,
-    0x9D, 0x48, 0xE2, 0x37, 0x63, 0xB6, 0x1C, 0xC9, 0xB4, 0x61, 0xCB, 0x1E, 0x4A, 0x9F, 0x35, 0xE0,
-    0xCF, 0x1A, 0xB0, 0x65, 0x31, 0xE4, 0x4E, 0x9B, 0xE6, 0x33, 0x99, 0x4C, 0x18, 0xCD, 0x67, 0xB2,
-    0x39, 0xEC, 0x46, 0x93, 0xC7, 0x12, 0xB8, 0x6D, 0x10, 0xC5, 0x6F, 0xBA, 0xEE, 0x3B, 0x91, 0x44,
-    0x6B, 0xBE, 0x14, 0xC1, 0x95, 0x40, 0xEA, 0x3F, 0x42, 0x97, 0x3D, 0xE8, 0xBC, 0x69, 0xC3, 0x16,
-    0xEF, 0x3A, 0x90, 0x45, 0x11, 0xC4, 0x6E, 0xBB, 0xC6, 0x13, 0xB9, 0x6C, 0x38, 0xED, 0x47, 0x92,
-    0xBD, 0x68, 0xC2, 0x17, 0x43, 0x96, 0x3C, 0xE9, 0x94, 0x41, 0xEB, 0x3E, 0x6A, 0xBF, 0x15, 0xC0,
-    0x4B, 0x9E, 0x34, 0xE1, 0xB5, 0x60, 0xCA, 0x1F, 0x62, 0xB7, 0x1D, 0xC8, 0x9C, 0x49, 0xE3, 0x36,
-    0x19, 0xCC, 0x66, 0xB3, 0xE7, 0x32, 0x98, 0x4D, 0x30, 0xE5, 0x4F, 0x9A, 0xCE, 0x1B, 0xB1, 0x64,
-    0x72, 0xA7, 0x0D, 0xD8, 0x8C, 0x59, 0xF3, 0x26, 0x5B, 0x8E, 0x24, 0xF1, 0xA5, 0x70, 0xDA, 0x0F,
-    0x20, 0xF5, 0x5F, 0x8A, 0xDE, 0x0B, 0xA1, 0x74, 0x09, 0xDC, 0x76, 0xA3, 0xF7, 0x22, 0x88, 0x5D,
-    0xD6, 0x03, 0xA9, 0x7C, 0x28, 0xFD, 0x57, 0x82, 0xFF, 0x2A, 0x80, 0x55, 0x01, 0xD4, 0x7E, 0xAB,
-    0x84, 0x51, 0xFB, 0x2E, 0x7A, 0xAF, 0x05, 0xD0, 0xAD, 0x78, 0xD2, 0x07, 0x53, 0x86, 0x2C, 0xF9};
-
 // CRC8 implementation with polynom = 0xBA
 static const u8 crc8tab_BA[256] = {
     0x00, 0xBA, 0xCE, 0x74, 0x26, 0x9C, 0xE8, 0x52, 0x4C, 0xF6, 0x82, 0x38, 0x6A, 0xD0, 0xA4, 0x1E,
@@ -110,15 +91,16 @@ static u8 crsf_crc(const u8 crctab[], const u8 *ptr, u8 len) {
     }
     return crc;
 }
+// CRSF uses CRC-8/DVB-S2
 u8 crsf_crc8(const u8 *ptr, u8 len) {
-    return crsf_crc(crc8tab, ptr, len);
+    return CRC8_Update(0, ptr, len);
 }
 u8 crsf_crc8_BA(const u8 *ptr, u8 len) {
     return crsf_crc(crc8tab_BA, ptr, len);
 }
 // crc accumulator format - start with crc=0
 void crsf_crc8_acc(u8 *crc, const u8 val) {
-    *crc = crc8tab[*crc ^ val];
+    *crc = CRC8_Update(*crc, &val, 1);
 }
 void crsf_crc8_BA_acc(u8 *crc, const u8 val) {
     *crc = crc8tab_BA[*crc ^ val];
@@ -604,42 +586,14 @@ US_TO_TICKS(x) ((x - 1500) * 8 / 5 + 992)
 #define STICK_SCALE    800  // +/-100 gives 2000/1000 us
 static u8 build_rcdata_pkt()
 {
-    int i;
-	u16 channels[CRSF_CHANNELS];
+    u16 channels[CRSF_CHANNELS];
 
-    for (i=0; i < CRSF_CHANNELS; i++) {
-        if (i < Model.num_channels)
-            channels[i] = (u16)(Channels[i] * STICK_SCALE / CHAN_MAX_VALUE + 992);
-        else
-            channels[i] = 992;  // midpoint
-    }
+    CHANFRAME_Scale(channels, CRSF_CHANNELS, CHANFRAME_SCALE(STICK_SCALE, CHAN_MAX_VALUE), 992);
 
     packet[0] = ADDR_MODULE;
     packet[1] = 24;   // length of type + payload + crc
     packet[2] = TYPE_CHANNELS;
-
-    packet[3]  = (u8) ((channels[0] & 0x07FF));
-    packet[4]  = (u8) ((channels[0] & 0x07FF)>>8   | (channels[1] & 0x07FF)<<3);
-    packet[5]  = (u8) ((channels[1] & 0x07FF)>>5   | (channels[2] & 0x07FF)<<6);
-    packet[6]  = (u8) ((channels[2] & 0x07FF)>>2);
-    packet[7]  = (u8) ((channels[2] & 0x07FF)>>10  | (channels[3] & 0x07FF)<<1);
-    packet[8]  = (u8) ((channels[3] & 0x07FF)>>7   | (channels[4] & 0x07FF)<<4);
-    packet[9]  = (u8) ((channels[4] & 0x07FF)>>4   | (channels[5] & 0x07FF)<<7);
-    packet[10] = (u8) ((channels[5] & 0x07FF)>>1);
-    packet[11] = (u8) ((channels[5] & 0x07FF)>>9   | (channels[6] & 0x07FF)<<2);
-    packet[12] = (u8) ((channels[6] & 0x07FF)>>6   | (channels[7] & 0x07FF)<<5);
-    packet[13] = (u8) ((channels[7] & 0x07FF)>>3);
-    packet[14] = (u8) ((channels[8] & 0x07FF));
-    packet[15] = (u8) ((channels[8] & 0x07FF)>>8   | (channels[9] & 0x07FF)<<3);
-    packet[16] = (u8) ((channels[9] & 0x07FF)>>5   | (channels[10] & 0x07FF)<<6);  
-    packet[17] = (u8) ((channels[10] & 0x07FF)>>2);
-    packet[18] = (u8) ((channels[10] & 0x07FF)>>10 | (channels[11] & 0x07FF)<<1);
-    packet[19] = (u8) ((channels[11] & 0x07FF)>>7  | (channels[12] & 0x07FF)<<4);
-    packet[20] = (u8) ((channels[12] & 0x07FF)>>4  | (channels[13] & 0x07FF)<<7);
-    packet[21] = (u8) ((channels[13] & 0x07FF)>>1);
-    packet[22] = (u8) ((channels[13] & 0x07FF)>>9  | (channels[14] & 0x07FF)<<2);
-    packet[23] = (u8) ((channels[14] & 0x07FF)>>6  | (channels[15] & 0x07FF)<<5);
-    packet[24] = (u8) ((channels[15] & 0x07FF)>>3);
+    CHANFRAME_PackLE(&packet[3], channels, CRSF_CHANNELS, 11);
 
     u8 *p = &packet[25];
 #if SUPPORT_CRSF_CONFIG
@@ -653,43 +607,27 @@ static u8 build_rcdata_pkt()
     return packet[1] + 2;
 }
 
-static enum {
-    ST_DATA0,
-    ST_DATA1,
-} state;
-
-static u16 mixer_runtime;
 static u16 serial_cb()
 {
     u8 length;
 
-    switch (state) {
-    case ST_DATA0:
-        CLOCK_RunMixer();    // clears mixer_sync, which is then set when mixer update complete
-        state = ST_DATA1;
-        return mixer_runtime;
-
-    case ST_DATA1:
-        if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
 #if SUPPORT_CRSF_CONFIG
-        length = CRSF_serial_txd(packet);
-        if (length == 0) {
-            length = build_rcdata_pkt();
-        }
-#else
+    length = CRSF_serial_txd(packet);
+    if (length == 0) {
         length = build_rcdata_pkt();
+    }
+#else
+    length = build_rcdata_pkt();
 #endif
-        UART_Send(packet, length);
+    UART_Send(packet, length);
 
 #if SUPPORT_CRSF_CONFIG
-        if (CBUF_Len(receive_buf)) CLOCK_RunOnce(processCrossfireTelemetryData);
+    if (CBUF_Len(receive_buf)) CLOCK_RunOnce(processCrossfireTelemetryData);
 #endif
 
-        state = ST_DATA0;
-        return get_update_interval() - mixer_runtime;
-    }
-
-    return CRSF_FRAME_PERIOD;   // avoid compiler warning
+    u16 interval = get_update_interval();
+    CLOCK_ScheduleMixer(interval);  // channels ready for the next packet
+    return interval;
 }
 
 static void initialize()
@@ -713,8 +651,6 @@ static void initialize()
     CBUF_Init(receive_buf);
     UART_StartReceive(serial_rcv);
 #endif
-    state = ST_DATA0;
-    mixer_runtime = 50;
 #if SUPPORT_CRSF_CONFIG
     model_id_send = 1;
 #endif
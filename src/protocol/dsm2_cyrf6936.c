@@ -19,6 +19,7 @@
 #include "mixer.h"
 #include "telemetry.h"
 #include "config/model.h"
+#include "profile.h"
 
 #ifdef PROTO_HAS_CYRF6936
 #ifdef MODULAR 
@@ -90,12 +91,6 @@ enum {
     DSM2_CH2_READ_B  = 10,
     DSM2_BIND        = 11,
     DSM2_CHANSEL     = BIND_COUNT + 11,
-#ifndef MODULAR
-    DSM2_CH1_WRITE_A_MIX,
-    DSM2_CH1_WRITE_B_MIX,
-    DSM2_CH2_READ_A_MIX,
-    DSM2_CH2_READ_B_MIX,
-#endif
 };
    
 static const u8 pncodes[5][9][8] = {
@@ -752,9 +747,6 @@ static u8 telem_data_index;
 #endif // test data
 
 
-#ifndef MODULAR
-static u16 mixer_runtime;
-#endif
 static u16 dsm2_cb()
 {
 #define CH1_CH2_DELAY 4010  // Time between write of channel 1 and channel 2
@@ -776,6 +768,7 @@ static u16 dsm2_cb()
         CYRF_TuneFreq(freq_offset);
     }
 #endif
+    PROFILE_SetState(state);
     if(state >= DSM2_BIND && state < DSM2_CHANSEL) {
         //Binding
         state += 1;
@@ -797,24 +790,13 @@ static u16 dsm2_cb()
         chidx = 0;
         crcidx = 0;
         set_sop_data_crc();
-#ifdef MODULAR
         state = DSM2_CH1_WRITE_A;
-	return 10000;
-#else
-        state = DSM2_CH1_WRITE_A_MIX;
-        return 10000 - mixer_runtime;
-    } else if(state == DSM2_CH1_WRITE_A_MIX || state == DSM2_CH1_WRITE_B_MIX) {
-        state = (state == DSM2_CH1_WRITE_A_MIX) ? DSM2_CH1_WRITE_A : DSM2_CH1_WRITE_B;
-        CLOCK_RunMixer();
-        return mixer_runtime;
-#endif
+        CLOCK_ScheduleMixer(10000);  // channels ready for the next CH1 write
+        return 10000;
     } else if(state == DSM2_CH1_WRITE_A || state == DSM2_CH1_WRITE_B
            || state == DSM2_CH2_WRITE_A || state == DSM2_CH2_WRITE_B)
     {
         if (state == DSM2_CH1_WRITE_A || state == DSM2_CH1_WRITE_B) {
-#ifndef MODULAR
-            if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
-#endif
             build_data_packet(state == DSM2_CH1_WRITE_B);
         }
         CYRF_WriteDataPacket(packet);
@@ -857,44 +839,24 @@ static u16 dsm2_cb()
             set_sop_data_crc();
             if (state == DSM2_CH2_CHECK_A) {
                 if(num_channels < 8) {
-#ifdef MODULAR
                     state = DSM2_CH1_WRITE_A;
+                    CLOCK_ScheduleMixer(22000 - CH1_CH2_DELAY - WRITE_DELAY);
                     return 22000 - CH1_CH2_DELAY - WRITE_DELAY;
                 }
                 state = DSM2_CH1_WRITE_B;
             } else {
                 state = DSM2_CH1_WRITE_A;
             }
+            CLOCK_ScheduleMixer(11000 - CH1_CH2_DELAY - WRITE_DELAY);
             return 11000 - CH1_CH2_DELAY - WRITE_DELAY;
-#else
-                    state = DSM2_CH1_WRITE_A_MIX;
-                    return 22000 - CH1_CH2_DELAY - WRITE_DELAY - mixer_runtime;
-                }
-                state = DSM2_CH1_WRITE_B_MIX;
-            } else {
-                state = DSM2_CH1_WRITE_A_MIX;
-            }
-            return 11000 - CH1_CH2_DELAY - WRITE_DELAY - mixer_runtime;
-#endif
         } else {
             state++;
             CYRF_SetTxRxMode(RX_EN); //Receive mode
             CYRF_WriteRegister(CYRF_05_RX_CTRL, 0x80); //Prepare to receive
-#ifndef MODULAR
-            if (mixer_runtime > READ_DELAY) {
-                state = (state == DSM2_CH2_READ_A) ? DSM2_CH2_READ_A_MIX : DSM2_CH2_READ_B_MIX;
-                return 11000 - CH1_CH2_DELAY - WRITE_DELAY - READ_DELAY - mixer_runtime;
-            } else {
-#endif
-                return 11000 - CH1_CH2_DELAY - WRITE_DELAY - READ_DELAY;
-            }
-#ifndef MODULAR
+            //The CH1 write follows READ_DELAY after the read
+            CLOCK_ScheduleMixer(11000 - CH1_CH2_DELAY - WRITE_DELAY);
+            return 11000 - CH1_CH2_DELAY - WRITE_DELAY - READ_DELAY;
         }
-    } else if(state == DSM2_CH2_READ_A_MIX || state == DSM2_CH2_READ_B_MIX) {
-        state = (state == DSM2_CH2_READ_A_MIX) ? DSM2_CH2_READ_A : DSM2_CH2_READ_B;
-        CLOCK_RunMixer();
-        return mixer_runtime;
-#endif
     } else if(state == DSM2_CH2_READ_A || state == DSM2_CH2_READ_B) {
         //Read telemetry if needed
         u8 rx_state = CYRF_ReadRegister(CYRF_07_RX_IRQ_STATUS);
@@ -917,6 +879,7 @@ static u16 dsm2_cb()
                     break;
             }
             CYRF_WriteRegister(CYRF_05_RX_CTRL, 0x80);  //Prepare to receive
+            CLOCK_ScheduleMixer(11000 + READ_DELAY);
             return 11000;
         }
         if (state == DSM2_CH2_READ_A)
@@ -925,9 +888,6 @@ static u16 dsm2_cb()
             state = DSM2_CH1_WRITE_A;
         CYRF_SetTxRxMode(TX_EN); //Write mode
         set_sop_data_crc();
-#ifndef MODULAR
-        if (mixer_runtime <= READ_DELAY) CLOCK_RunMixer();
-#endif
         return READ_DELAY;
     } 
     return 0;
@@ -976,9 +936,6 @@ static void initialize(u8 bind)
     data_col = 7 - sop_col;
     model = MODEL;
     num_channels = Model.num_channels;
-#ifndef MODULAR
-    mixer_runtime = 50;
-#endif
     if (num_channels < 6)
         num_channels = 6;
     else if (num_channels > 12)
@@ -1023,4 +980,6 @@ uintptr_t DSM2_Cmds(enum ProtoCmds cmd)
     return 0;
 }
 
+#define TESTNAME dsm2
+#include <tests.h>
 #endif
@@ -190,9 +190,7 @@ static void XN297L_WritePayload(const u8* msg, u8 len)
     u8 offset = xn297_addr_len < 4 ? 1 : 0;
 
     // crc
-    u16 crc = initial;
-    for (u8 i = offset; i < last; ++i)
-        crc = crc16_update(crc, buf[i], 8);
+    u16 crc = CRC16_Update(initial, &buf[offset], last - offset);
     crc ^= xn297_crc_xorout_scrambled[xn297_addr_len - 3 + len];
     buf[last++] = crc >> 8;
     buf[last++] = crc & 0xff;
@@ -116,11 +116,8 @@ static void ssv_pack_dpl(u8 const addr[], u8 pid, u8* len, u8* payload, u8* pack
         u16 val;
     } crc;
 
-    crc.val=0x3c18;
-    for (i = 0; i < 7; ++i)
-        crc.val=crc16_update(crc.val,header[i],8);
-    for (i = 0; i < *len; ++i)
-        crc.val=crc16_update(crc.val,payload[i],8);
+    crc.val = CRC16_Update(0x3c18, header, 7);
+    crc.val = CRC16_Update(crc.val, payload, *len);
 
     // encode payload and crc
     // xor with this:
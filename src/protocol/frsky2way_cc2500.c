@@ -345,7 +345,7 @@ static u8 testdata[] = {
  0x00 };
 #endif
 
-static u16 mixer_runtime;
+static u16 mixer_runtime;  // CLOCK_MixerRuntime() sampled once per frame
 static u16 frsky2way_cb()
 {
     unsigned len = 0;
@@ -437,7 +437,7 @@ static u16 frsky2way_cb()
         CC2500_WriteReg(CC2500_23_FSCAL3, 0x89);
         //CC2500_WriteReg(CC2500_3E_PATABLE, 0xfe);
         CC2500_Strobe(CC2500_SFRX);
-        if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
+        mixer_runtime = CLOCK_MixerRuntime();
         frsky2way_build_data_packet();
         CC2500_WriteData(packet, packet[0]+1);
         state++;
@@ -468,7 +468,7 @@ static int get_tx_id()
 static void initialize(int bind)
 {
     CLOCK_StopTimer();
-    mixer_runtime = 50;
+    mixer_runtime = CLOCK_MixerRuntime();
     course = (int)Model.proto_opts[PROTO_OPTS_FREQCOURSE];
     fine = Model.proto_opts[PROTO_OPTS_FREQFINE];
     //fixed_id = 0x3e19;
@@ -102,12 +102,6 @@ static const u8 hop_data[] = {
 };
 
 
-static const u16 CRC_Short[] = {
-  0x0000,0x1189,0x2312,0x329b,0x4624,0x57ad,0x6536,0x74bf,
-  0x8c48,0x9dc1,0xaf5a,0xbed3,0xca6c,0xdbe5,0xe97e,0xf8f7,
-};
-
-
 
 static void init_hop_FRSkyX2(void)
 {
@@ -136,19 +130,8 @@ static void init_hop_FRSkyX2(void)
     hop_data_v2[HOP_DATA_SIZE - 1] = 0;                                        // Bind freq
 }
 
-static u16 crcTable(u8 val)
-{
-  u16 word;
-  word = pgm_read_word(&CRC_Short[val & 0x0F]);
-  val /= 16;
-  return word ^ (0x1081 * val);
-}
-
 static u16 crc(u8 *data, u8 len) {
-  u16 crc = 0;
-  for (int i = 0; i < len; i++)
-      crc = (crc << 8) ^ crcTable((u8)(crc >> 8) ^ *data++);
-  return crc;
+  return CRC16_UpdateFrSkyX(0, data, len);
 }
 
 static void initialize_data(u8 adr)
@@ -257,7 +240,7 @@ static u16 scaleForPXX(u8 chan, u8 failsafe)
     if (Model.proto_opts[PROTO_OPTS_RSSICHAN] && (chan == Model.num_channels - 1) && !failsafe)
         chan_val = Telemetry.value[TELEM_FRSKY_RSSI] * 21;      // Max RSSI value seems to be 99, scale it to around 2000
     else
-        chan_val = chan_val * STICK_SCALE / CHAN_MAX_VALUE + 1024;
+        chan_val = CHANFRAME_ScaleValue(chan_val, CHANFRAME_SCALE(STICK_SCALE, CHAN_MAX_VALUE)) + 1024;
 
     if (chan_val > 2046)   chan_val = 2046;
     else if (chan_val < 1) chan_val = 1;
@@ -282,8 +265,7 @@ static void frskyX_data_frame() {
     //0x1D 0xB3 0xFD 0x02 0x56 0x07 0x15 0x00 0x00 0x00 0x04 0x40 0x00 0x04 0x40 0x00 0x04 0x40 0x00 0x04 0x40 0x08 0x00 0x00 0x00 0x00 0x00 0x00 0x96 0x12
     // channel packing: H (0)7-4, L (0)3-0; H (1)3-0, L (0)11-8; H (1)11-8, L (1)7-4 etc
 
-    u16 chan_0;
-    u16 chan_1;
+    u16 channels[8];
     static u8 failsafe_chan;
     u8 startChan = 0;
 
@@ -319,27 +301,16 @@ static void frskyX_data_frame() {
 
     startChan = chan_offset;
 
-    for (u8 i = 0; i < 12 ; i += 3) {    // 12 bytes of channel data
+    for (u8 i = 0; i < 8; i++) {
         if (FS_flag & 0x10 && (((failsafe_chan & 0x7) | chan_offset) == startChan)) {
             packet[7] = FS_flag;
-            chan_0 = scaleForPXX(failsafe_chan, 1);
+            channels[i] = scaleForPXX(failsafe_chan, 1);
         } else {
-            chan_0 = scaleForPXX(startChan, 0);
+            channels[i] = scaleForPXX(startChan, 0);
         }
         startChan++;
-
-        if (FS_flag & 0x10 && (((failsafe_chan & 0x7) | chan_offset) == startChan)) {
-            packet[7] = FS_flag;
-            chan_1 = scaleForPXX(failsafe_chan, 1);
-        } else {
-            chan_1 = scaleForPXX(startChan, 0);
-        }
-        startChan++;
-
-        packet[9+i]   = chan_0;
-        packet[9+i+1] = (((chan_0 >> 8) & 0x0F) | (chan_1 << 4));
-        packet[9+i+2] = chan_1 >> 4;
     }
+    CHANFRAME_PackLE(&packet[9], channels, 8, 12);    // 12 bytes of channel data
 
     packet[21] = seq_rx_expected << 4 | seq_tx_send;
 
@@ -475,7 +446,7 @@ static const u8 telem_test[][17] = {
 #endif
 
 
-static u16 mixer_runtime;
+static u16 mixer_runtime;  // CLOCK_MixerRuntime() sampled once per frame
 static u16 frskyx_cb() {
   u8 len;
 
@@ -509,7 +480,7 @@ static u16 frskyx_cb() {
       set_start(channr);
       CC2500_SetPower(Model.tx_power);
       CC2500_Strobe(CC2500_SFRX);
-      if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
+      mixer_runtime = CLOCK_MixerRuntime();
       frskyX_data_frame();
       CC2500_Strobe(CC2500_SIDLE);
       CC2500_WriteData(packet, packet[0] + 1);
@@ -690,7 +661,7 @@ static int get_tx_id()
 static void initialize(int bind)
 {
     CLOCK_StopTimer();
-    mixer_runtime = 50;
+    mixer_runtime = CLOCK_MixerRuntime();
 
     // initialize statics since 7e modules don't initialize
     fine = Model.proto_opts[PROTO_OPTS_FREQFINE];
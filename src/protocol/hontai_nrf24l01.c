@@ -130,36 +130,12 @@ static const u8 addr_vals[4][16] = {
 // Bit vector from bit position
 #define BV(bit) (1 << bit)
 
-// proudly swiped from http://www.drdobbs.com/implementing-the-ccitt-cyclical-redundan/199904926
-#define POLY 0x8408
-static u16 crc16(u8 *data_p, u32 length)
+// CRC-16/X-25 over all but the last 2 bytes, appended LSB first
+static void crc16(u8 *data_p, u32 length)
 {
-    u8 i;
-    u32 data;
-    u32 crc;
-     
-    crc = 0xffff;
-     
-    if (length == 0) return (~crc);
-     
-    length -= 2;
-    do {
-        for (i = 0, data = (u8)0xff & *data_p++;
-             i < 8;
-             i++, data >>= 1) {
-                 if ((crc & 0x0001) ^ (data & 0x0001))
-                     crc = (crc >> 1) ^ POLY;
-                 else
-                     crc >>= 1;
-        }
-    } while (--length);
-     
-    crc = ~crc;
-    data = crc;
-    crc = (crc << 8) | (data >> 8 & 0xFF);
-    *data_p++ = crc >> 8;
-    *data_p   = crc & 0xff;
-    return crc;
+    u16 crc = ~CRC16_UpdateReflected(0xffff, data_p, length - 2);
+    data_p[length-2] = crc & 0xff;
+    data_p[length-1] = crc >> 8;
 }
 
 #define CHAN_RANGE (CHAN_MAX_VALUE - CHAN_MIN_VALUE)
@@ -144,7 +144,7 @@ static u8 fsConfigChanged()
 {
     u16 temp = 0;
     for (u8 i=0; i < 8; i++)
-        temp = crc16_update(temp, Model.limits[i].failsafe, 8);
+        temp = CRC16_Update(temp, (const u8 *)&Model.limits[i].failsafe, 1);
     if (temp != fs_config) {
         fs_config = temp;
         return 1;
@@ -111,26 +111,18 @@ static void NCC_init()
 static const u8 NCC_xor[]={0x80, 0x44, 0x64, 0x75, 0x6C, 0x71, 0x2A, 0x36, 0x7C, 0xF1, 0x6E, 0x52, 0x09, 0x9D};
 static void NCC_Crypt_Packet()
 {
-    u16 crc = 0;
     for(u8 i=0; i < NCC_TX_PACKET_LEN-2; i++)
-    {
         packet[i] ^= NCC_xor[i];
-        crc = crc16_update(crc, packet[i], 8);
-    }
-    crc ^= 0x60DE;
+    u16 crc = CRC16_Update(0, packet, NCC_TX_PACKET_LEN-2) ^ 0x60DE;
     packet[NCC_TX_PACKET_LEN-2] = crc >> 8;
     packet[NCC_TX_PACKET_LEN-1] = crc;
 }
 
 static u8 NCC_Decrypt_Packet()
 {
-    u16 crc = 0;
+    u16 crc = CRC16_Update(0, packet, NCC_RX_PACKET_LEN-2) ^ 0xA950;
     for(u8 i=0; i < NCC_RX_PACKET_LEN-2; i++)
-    {
-        crc = crc16_update(crc, packet[i], 8);
         packet[i] ^= NCC_xor[i];
-    }
-    crc ^= 0xA950;
     if((crc >> 8) == packet[NCC_RX_PACKET_LEN-2] && (crc & 0xFF) == packet[NCC_RX_PACKET_LEN-1] )
     {// CRC match
         return 1;
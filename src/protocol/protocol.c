@@ -606,6 +606,8 @@ void PROTO_CS_HI(int module)
 
 void PROTO_CS_LO(int module)
 {
+    //Wait for the previous DMA burst to release its chip select
+    PROTOSPI_wait();
 #if HAS_4IN1_FLASH
     if (SPISwitch_Present()) {
         SPISwitch_CS_LO(module);
@@ -144,7 +144,7 @@ static u16 scaleForPXX(u8 chan, u8 failsafe)
         chan_val = Telemetry.value[TELEM_FRSKY_RSSI] * 21;      // Max RSSI value seems to be 99, scale it to around 2000
     else
 #endif
-        chan_val = chan_val * STICK_SCALE / CHAN_MAX_VALUE + 1024;
+        chan_val = CHANFRAME_ScaleValue(chan_val, CHANFRAME_SCALE(STICK_SCALE, CHAN_MAX_VALUE)) + 1024;
 
     if (chan_val > 2046)   chan_val = 2046;
     else if (chan_val < 1) chan_val = 1;
@@ -162,8 +162,7 @@ static u16 scaleForPXX(u8 chan, u8 failsafe)
 
 static void build_data_pkt(u8 bind)
 {
-    u16 chan_0;
-    u16 chan_1;
+    u16 channels[8];
     u8 startChan = chan_offset;
 
     // data frames sent every 8ms; failsafe every 8 seconds
@@ -196,14 +195,9 @@ static void build_data_pkt(u8 bind)
 
     packet[2] = 0;  // FLAG2, Reserved for future use, must be “0” in this version.
 
-    for(u8 i = 0; i < 12 ; i += 3) {    // 12 bytes of channel data
-        chan_0 = scaleForPXX(startChan++, FS_flag == 0x10 ? 1 : 0);
-        chan_1 = scaleForPXX(startChan++, FS_flag == 0x10 ? 1 : 0);
-
-        packet[3+i]   = chan_0;
-        packet[3+i+1] = (((chan_0 >> 8) & 0x0F) | (chan_1 << 4));
-        packet[3+i+2] = chan_1 >> 4;
-    }
+    for(u8 i = 0; i < 8; i++)
+        channels[i] = scaleForPXX(startChan++, FS_flag == 0x10 ? 1 : 0);
+    CHANFRAME_PackLE(&packet[3], channels, 8, 12);    // 12 bytes of channel data
 
     // extra_flags byte definitions pulled from openTX
     // b0: antenna selection on Horus and Xlite
@@ -229,12 +223,9 @@ static enum {
 #else
   PXX_BIND_DONE = 5,
 #endif
-  PXX_DATA1,
-  PXX_DATA2,
+  PXX_DATA,
 } state;
 
-static u16 mixer_runtime;
-
 #if HAS_EXTENDED_TELEMETRY
 // Support S.Port telemetry on RX pin
 // couple defines to avoid errors from include file
@@ -265,18 +256,11 @@ static u16 pxxout_cb()
         PROTOCOL_SetBindState(0);
         state++;
         // intentional fall-through
-    case PXX_DATA1:
-        CLOCK_RunMixer();    // clears mixer_sync, which is then set when mixer update complete
-        state = PXX_DATA2;
-        return mixer_runtime;
-    case PXX_DATA2:
-#ifndef EMULATOR
-        if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
-#endif
+    case PXX_DATA:
         build_data_pkt(0);
         PXX_Enable(packet);
-        state = PXX_DATA1;
-        return STD_DELAY - mixer_runtime;
+        CLOCK_ScheduleMixer(STD_DELAY);  // channels ready for the next packet
+        return STD_DELAY;
     }
 }
 
@@ -304,13 +288,12 @@ static void initialize(u8 bind)
     FS_flag = 0;
     range_check = 0;
     packet[0] = (u8) Model.fixed_id & 0x3f;  // limit to valid range - 6 bits
-    mixer_runtime = 50;
 
     if (bind) {
         state = PXX_BIND;
         PROTOCOL_SetBindState(5000);
     } else {
-        state = PXX_DATA1;
+        state = PXX_DATA;
     }
     CLOCK_StartTimer(1000, pxxout_cb);
 }
@@ -70,7 +70,7 @@ static enum {
 
 static u16 fixed_id;
 static u8 packet[PACKET_SIZE];
-static u16 mixer_runtime;
+static u16 mixer_runtime;  // CLOCK_MixerRuntime() sampled once per frame
 
 static u8 hop_data[NUM_HOPS];
 
@@ -116,7 +116,7 @@ static u16 scaleForRedpine(u8 chan)
 {
     s32 chan_val;
 
-    chan_val = Channels[chan] * 15 * 100 / (2 * CHAN_MAX_VALUE) + 1024;
+    chan_val = CHANFRAME_ScaleValue(Channels[chan], CHANFRAME_SCALE(15 * 100, 2 * CHAN_MAX_VALUE)) + 1024;
 
     if (chan_val > 2046)   chan_val = 2046;
     else if (chan_val < 10) chan_val = 10;
@@ -248,7 +248,7 @@ break;
         if (format != (unsigned)Model.proto_opts[PROTO_OPTS_FORMAT]) {
             format = (unsigned)Model.proto_opts[PROTO_OPTS_FORMAT];
             redpine_init(format);
-            mixer_runtime = 50;
+            mixer_runtime = CLOCK_MixerRuntime();
             return 5000;
         }
 
@@ -256,9 +256,7 @@ break;
         set_start(channr);
         CC2500_SetPower(Model.tx_power);
         CC2500_Strobe(CC2500_SFRX);
-        if (mixer_sync != MIX_DONE && mixer_runtime < 2000) {
-            mixer_runtime += 1;
-        }
+        mixer_runtime = CLOCK_MixerRuntime();
 
         if ((unsigned)Model.proto_opts[PROTO_OPTS_VTX_SEND] == 0) {
             redpine_data_frame();
@@ -386,7 +384,7 @@ static int get_tx_id()
 static void initialize(int bind)
 {
     CLOCK_StopTimer();
-    mixer_runtime = 50;
+    mixer_runtime = CLOCK_MixerRuntime();
 
     // initialize statics since 7e modules don't initialize
     fine = 0;
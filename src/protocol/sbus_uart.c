@@ -41,40 +41,12 @@ static u8 packet[SBUS_PACKET_SIZE];
 #define STICK_SCALE    800  // +/-100 gives 2000/1000 us
 static void build_rcdata_pkt()
 {
-    int i;
-	u16 channels[SBUS_CHANNELS];
-
-    for (i=0; i < SBUS_CHANNELS; i++) {
-        if (i < Model.num_channels)
-            channels[i] = (u16)(Channels[i] * STICK_SCALE / CHAN_MAX_VALUE + 992);
-        else
-            channels[i] = 992;  // midpoint
-    }
+    u16 channels[SBUS_CHANNELS];
 
-	packet[0] = 0x0f; 
+    CHANFRAME_Scale(channels, SBUS_CHANNELS, CHANFRAME_SCALE(STICK_SCALE, CHAN_MAX_VALUE), 992);
 
-  	packet[1] = (u8) ((channels[0] & 0x07FF));
-  	packet[2] = (u8) ((channels[0] & 0x07FF)>>8 | (channels[1] & 0x07FF)<<3);
-  	packet[3] = (u8) ((channels[1] & 0x07FF)>>5 | (channels[2] & 0x07FF)<<6);
-  	packet[4] = (u8) ((channels[2] & 0x07FF)>>2);
-  	packet[5] = (u8) ((channels[2] & 0x07FF)>>10 | (channels[3] & 0x07FF)<<1);
-  	packet[6] = (u8) ((channels[3] & 0x07FF)>>7 | (channels[4] & 0x07FF)<<4);
-  	packet[7] = (u8) ((channels[4] & 0x07FF)>>4 | (channels[5] & 0x07FF)<<7);
-  	packet[8] = (u8) ((channels[5] & 0x07FF)>>1);
-  	packet[9] = (u8) ((channels[5] & 0x07FF)>>9 | (channels[6] & 0x07FF)<<2);
-  	packet[10] = (u8) ((channels[6] & 0x07FF)>>6 | (channels[7] & 0x07FF)<<5);
-  	packet[11] = (u8) ((channels[7] & 0x07FF)>>3);
-  	packet[12] = (u8) ((channels[8] & 0x07FF));
-  	packet[13] = (u8) ((channels[8] & 0x07FF)>>8 | (channels[9] & 0x07FF)<<3);
-  	packet[14] = (u8) ((channels[9] & 0x07FF)>>5 | (channels[10] & 0x07FF)<<6);  
-  	packet[15] = (u8) ((channels[10] & 0x07FF)>>2);
-  	packet[16] = (u8) ((channels[10] & 0x07FF)>>10 | (channels[11] & 0x07FF)<<1);
-  	packet[17] = (u8) ((channels[11] & 0x07FF)>>7 | (channels[12] & 0x07FF)<<4);
-  	packet[18] = (u8) ((channels[12] & 0x07FF)>>4 | (channels[13] & 0x07FF)<<7);
-  	packet[19] = (u8) ((channels[13] & 0x07FF)>>1);
-  	packet[20] = (u8) ((channels[13] & 0x07FF)>>9 | (channels[14] & 0x07FF)<<2);
-  	packet[21] = (u8) ((channels[14] & 0x07FF)>>6 | (channels[15] & 0x07FF)<<5);
-  	packet[22] = (u8) ((channels[15] & 0x07FF)>>3);
+	packet[0] = 0x0f; 
+    CHANFRAME_PackLE(&packet[1], channels, SBUS_CHANNELS, 11);
 
 	packet[23] = 0x00; // flags
 	packet[24] = 0x00;
@@ -82,32 +54,16 @@ static void build_rcdata_pkt()
 
 // static u8 testrxframe[] = { 0x00, 0x0C, 0x14, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x01, 0x03, 0x00, 0x00, 0x00, 0xF4 };
 
-static enum {
-    ST_DATA1,
-    ST_DATA2,
-} state;
-
-static u16 mixer_runtime;
 static u16 sbus_period;
 static u16 serial_cb()
 {
     if (sbus_period != Model.proto_opts[PROTO_OPTS_PERIOD] * 1000)
         sbus_period = Model.proto_opts[PROTO_OPTS_PERIOD] * 1000;
 
-    switch (state) {
-    case ST_DATA1:
-        CLOCK_RunMixer();    // clears mixer_sync, which is then set when mixer update complete
-        state = ST_DATA2;
-        return mixer_runtime;
-
-    case ST_DATA2:
-        if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
-        build_rcdata_pkt();
-        UART_Send(packet, sizeof packet);
-        state = ST_DATA1;
-        return sbus_period - mixer_runtime;
-    }
-    return sbus_period;   // avoid compiler warning
+    build_rcdata_pkt();
+    UART_Send(packet, sizeof packet);
+    CLOCK_ScheduleMixer(sbus_period);  // channels ready for the next packet
+    return sbus_period;
 }
 
 static void initialize()
@@ -126,8 +82,6 @@ static void initialize()
     UART_Initialize();
     UART_SetDataRate(SBUS_DATARATE);
 	UART_SetFormat(8, UART_PARITY_EVEN, UART_STOPBITS_2);
-    state = ST_DATA1;
-    mixer_runtime = 50;
     sbus_period = Model.proto_opts[PROTO_OPTS_PERIOD] ? (Model.proto_opts[PROTO_OPTS_PERIOD] * 1000) : SBUS_FRAME_PERIOD_MAX;
 
     CLOCK_StartTimer(1000, serial_cb);
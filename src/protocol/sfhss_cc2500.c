@@ -62,7 +62,6 @@ static enum {
     SFHSS_TUNE  = 0x103,
     SFHSS_DATA1 = 0x02,
     SFHSS_DATA2 = 0x0b,
-    SFHSS_MIX,
 } state;
 
 #define FREQ0_VAL 0xC4
@@ -252,7 +251,6 @@ static void send_packet()
 }
 
 
-static u16 mixer_runtime;
 static u16 SFHSS_cb()
 {
     switch(state) {
@@ -274,7 +272,6 @@ static u16 SFHSS_cb()
 
     /* Work cycle, 6.8ms, second packet 1.65ms after first */
     case SFHSS_DATA1:
-        if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
         build_data_packet();
         send_packet();
         state = SFHSS_DATA2;
@@ -290,13 +287,9 @@ static u16 SFHSS_cb()
         tune_freq();
 #endif
         tune_power();
-        state = SFHSS_MIX;
-        return 3150 - mixer_runtime;
-
-    case SFHSS_MIX:
         state = SFHSS_DATA1;
-        CLOCK_RunMixer();
-        return mixer_runtime;
+        CLOCK_ScheduleMixer(3150);  // channels ready for the next packet
+        return 3150;
 /*
     case SFHSS_DATA1:
         build_data_packet();
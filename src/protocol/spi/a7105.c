@@ -17,6 +17,7 @@
 #include "config/tx.h"
 #include "protocol/interface.h"
 #include "protospi.h"
+#include "trace.h"
 
 #ifdef PROTO_HAS_A7105
 
@@ -49,13 +50,11 @@ u8 A7105_ReadReg(u8 address)
 
 void A7105_WriteData(u8 *dpbuffer, u8 len, u8 channel)
 {
-    int i;
+    TRACE_Packet(TRACE_TX, A7105, dpbuffer, len);
     CS_LO();
     PROTOSPI_xfer(A7105_RST_WRPTR);
     PROTOSPI_xfer(0x05);
-    for (i = 0; i < len; i++)
-        PROTOSPI_xfer(dpbuffer[i]);
-    CS_HI();
+    PROTOSPI_xfer_block(dpbuffer, NULL, len, CS_HI);
 
     A7105_WriteReg(0x0F, channel);
 
@@ -68,6 +67,7 @@ void A7105_ReadData(u8 *dpbuffer, u8 len)
     A7105_Strobe(A7105_RST_RDPTR);
     for(int i = 0; i < len; i++)
         dpbuffer[i] = A7105_ReadReg(0x05);
+    TRACE_Packet(TRACE_RX, A7105, dpbuffer, len);
     return;
 }
 
@@ -17,6 +17,7 @@
 #include "config/tx.h"
 #include "protocol/interface.h"
 #include "protospi.h"
+#include "trace.h"
 
 #ifdef PROTO_HAS_CC2500
 //GPIOA.14
@@ -61,6 +62,7 @@ u8 CC2500_ReadReg(u8 address)
 void CC2500_ReadData(u8 *dpbuffer, int len)
 {
     CC2500_ReadRegisterMulti(CC2500_3F_RXFIFO, dpbuffer, len);
+    TRACE_Packet(TRACE_RX, CC2500, dpbuffer, len);
 }
 
 void CC2500_Strobe(u8 state)
@@ -75,15 +77,12 @@ void CC2500_WriteRegisterMulti(u8 address, const u8 data[], u8 length)
 {
     CS_LO();
     PROTOSPI_xfer(CC2500_WRITE_BURST | address);
-    for(int i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
-    CS_HI();
+    PROTOSPI_xfer_block(data, NULL, length, CS_HI);
 }
 
 void CC2500_WriteData(u8 *dpbuffer, u8 len)
 {
+    TRACE_Packet(TRACE_TX, CC2500, dpbuffer, len);
     CC2500_Strobe(CC2500_SFTX);
     CC2500_WriteRegisterMulti(CC2500_3F_TXFIFO, dpbuffer, len);
     CC2500_Strobe(CC2500_STX);
@@ -24,6 +24,7 @@
 //#pragma long_calls_off
 #include "protocol/interface.h"
 #include "protospi.h"
+#include "trace.h"
 
 #if !defined(HAS_4IN1_FLASH)
 #define HAS_4IN1_FLASH 0
@@ -60,11 +61,7 @@ static void WriteRegisterMulti(u8 address, const u8 data[], u8 length)
 {
     CS_LO();
     PROTOSPI_xfer(0x80 | address);
-    for(u32 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
-    CS_HI();
+    PROTOSPI_xfer_block(data, NULL, length, CS_HI);
 }
 
 static void ReadRegisterMulti(u8 address, u8 data[], u8 length)
@@ -274,10 +271,12 @@ void CYRF_StartReceive()
 void CYRF_ReadDataPacketLen(u8 dpbuffer[], u8 length)
 {
     ReadRegisterMulti(CYRF_21_RX_BUFFER, dpbuffer, length);
+    TRACE_Packet(TRACE_RX, CYRF6936, dpbuffer, length);
 }
 
 void CYRF_WriteDataPacketLen(const u8 dpbuffer[], u8 len)
 {
+    TRACE_Packet(TRACE_TX, CYRF6936, dpbuffer, len);
     CYRF_WriteRegister(CYRF_01_TX_LENGTH, len);
     CYRF_WriteRegister(CYRF_02_TX_CTRL, 0x40); //clear the transmit buffer
     WriteRegisterMulti(CYRF_20_TX_BUFFER, dpbuffer, len);
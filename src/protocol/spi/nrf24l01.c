@@ -17,6 +17,7 @@
 #include "config/tx.h"
 #include "protocol/interface.h"
 #include "protospi.h"
+#include "trace.h"
 
 #ifdef PROTO_HAS_NRF24L01
 
@@ -67,23 +68,16 @@ u8 NRF24L01_WriteRegisterMulti(u8 reg, const u8 data[], u8 length)
 {
     CS_LO();
     u8 res = PROTOSPI_xfer(W_REGISTER | ( REGISTER_MASK & reg));
-    for (u8 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
-    CS_HI();
+    PROTOSPI_xfer_block(data, NULL, length, CS_HI);
     return res;
 }
 
 u8 NRF24L01_WritePayload(u8 *data, u8 length)
 {
+    TRACE_Packet(TRACE_TX, NRF24L01, data, length);
     CS_LO();
     u8 res = PROTOSPI_xfer(W_TX_PAYLOAD);
-    for (u8 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
-    CS_HI();
+    PROTOSPI_xfer_block(data, NULL, length, CS_HI);
     return res;
 }
 
@@ -117,6 +111,7 @@ u8 NRF24L01_ReadPayload(u8 *data, u8 length)
         data[i] = PROTOSPI_xfer(0xFF);
     }
     CS_HI();
+    TRACE_Packet(TRACE_RX, NRF24L01, data, length);
     return res;
 }
 
@@ -320,22 +315,8 @@ uint8_t bit_reverse(uint8_t b_in)
 }
 #endif
 
-static const uint16_t polynomial = 0x1021;
 static const uint16_t initial    = 0xb5d2;
 
-u16 crc16_update(u16 crc, u8 a, u8 bits)
-{
-    crc ^= a << 8;
-    while (bits--) {
-        if (crc & 0x8000) {
-            crc = (crc << 1) ^ polynomial;
-        } else {
-            crc = crc << 1;
-        }
-    }
-    return crc;
-}
-
 
 void XN297_SetTXAddr(const u8* addr, int len)
 {
@@ -418,10 +399,7 @@ u8 XN297_WritePayload(u8* msg, int len)
     }
     if (xn297_crc) {
         int offset = xn297_addr_len < 4 ? 1 : 0;
-        u16 crc = initial;
-        for (int i = offset; i < last; ++i) {
-            crc = crc16_update(crc, packet[i], 8);
-        }
+        u16 crc = CRC16_Update(initial, &packet[offset], last - offset);
         if(xn297_scramble_enabled)
             crc ^= pgm_read_word(&xn297_crc_xorout_scrambled[xn297_addr_len - 3 + len]);
         else
@@ -482,11 +460,8 @@ u8 XN297_WriteEnhancedPayload(u8* msg, int len, int noack, u16 crc_xorout)
     // crc
     if (xn297_crc) {
         int offset = xn297_addr_len < 4 ? 1 : 0;
-        u16 crc = initial;
-        for (int i = offset; i < last; ++i) {
-            crc = crc16_update(crc, packet[i], 8);
-        }
-        crc = crc16_update(crc, packet[last] & 0xc0, 2);
+        u16 crc = CRC16_Update(initial, &packet[offset], last - offset);
+        crc = CRC16_UpdateBits(crc, packet[last] & 0xc0, 2);
         crc ^= crc_xorout;
 
         packet[last++] |= (crc >> 8) >> 2;
@@ -562,23 +537,20 @@ void HS6200_SetTXAddr(const u8* addr, u8 len)
     // precompute address crc
     hs6200_crc_init = 0xffff;
     for(int i=0; i<len; i++)
-        hs6200_crc_init = crc16_update(hs6200_crc_init, addr[len-1-i], 8);
+        hs6200_crc_init = CRC16_Update(hs6200_crc_init, &addr[len-1-i], 1);
     memcpy(hs6200_tx_addr, addr, len);
     hs6200_address_length = len;
 }
 
 static u16 hs6200_calc_crc(u8* msg, u8 len)
 {
-    u8 pos;
-    u16 crc = hs6200_crc_init;
-    
+    u8 pos = len > 0 ? len-1 : 0;
+
     // pcf + payload
-    for(pos=0; pos < len-1; pos++) { 
-        crc = crc16_update(crc, msg[pos], 8);
-    }
+    u16 crc = CRC16_Update(hs6200_crc_init, msg, pos);
     // last byte (1 bit only)
     if(len > 0) {
-        crc = crc16_update(crc, msg[pos+1], 1);
+        crc = CRC16_UpdateBits(crc, msg[pos+1], 1);
     }
     
     return crc;
@@ -37,50 +37,27 @@ ctassert(LAST_PROTO_OPT <= NUM_PROTO_OPTS, too_many_protocol_opts);
 
 static u8 packet[SUMD_MAX_PACKET_SIZE];
 
-#define CRC_POLYNOME 0x1021
-static u16 crc16(u16 crc, u8 value) {
-    u8 i;
-
-    crc = crc ^ (s16)value << 8;
-
-    for (i=0; i < 8; i++) {
-        if (crc & 0x8000)
-            crc = (crc << 1) ^ CRC_POLYNOME;
-        else
-            crc = (crc << 1);
-    }
-    return crc;
-}
-
-static u16 crc(u8 *data, u8 len) {
-  u16 crc = 0;
-  for (int i=0; i < len; i++)
-      crc = crc16(crc, *data++);
-  return crc;
-}
-
 
 // #define STICK_SCALE    869  // full scale at +-125
 #define STICK_SCALE     3200  // +/-100 gives 15200/8800
 #define STICK_CENTER   12000
 static int build_rcdata_pkt()
 {
-    u16 chanval;
+    u16 channels[SUMD_MAX_CHANNELS];
     u16 crc_val = 0;
+    int num_channels = Model.num_channels;
     int j = 0;
 
 
     packet[j++] = 0xa8;     // manufacturer id
     packet[j++] = 0x01;     // 0x01 normal packet, 0x81 failsafe setting
-    packet[j++] = Model.num_channels;
+    packet[j++] = num_channels;
 
-    for (int i=0; i < Model.num_channels; i++) {
-        chanval = (u16)(Channels[i] * STICK_SCALE / CHAN_MAX_VALUE + STICK_CENTER);
-        packet[j++] = chanval >> 8;
-        packet[j++] = chanval;
-    }
+    CHANFRAME_Scale(channels, num_channels, CHANFRAME_SCALE(STICK_SCALE, CHAN_MAX_VALUE), STICK_CENTER);
+    CHANFRAME_PackBE(&packet[j], channels, num_channels, 16);
+    j += 2 * num_channels;
 
-    crc_val = crc(packet, j);
+    crc_val = CRC16_Update(0, packet, j);
     packet[j++] = crc_val >> 8;
     packet[j++] = crc_val;
 
@@ -88,30 +65,14 @@ static int build_rcdata_pkt()
 }
 
 
-static enum {
-    ST_DATA1,
-    ST_DATA2,
-} state;
-
-static u16 mixer_runtime;
 static u16 sumd_period;
 static u16 serial_cb() {
     if (sumd_period != Model.proto_opts[PROTO_OPTS_PERIOD] * 1000)
         sumd_period = Model.proto_opts[PROTO_OPTS_PERIOD] * 1000;
 
-    switch (state) {
-    case ST_DATA1:
-        CLOCK_RunMixer();    // clears mixer_sync, which is then set when mixer update complete
-        state = ST_DATA2;
-        return mixer_runtime;
-
-    case ST_DATA2:
-        if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
-        UART_Send(packet, build_rcdata_pkt());
-        state = ST_DATA1;
-        return sumd_period - mixer_runtime;
-    }
-    return sumd_period;   // avoid compiler warning
+    UART_Send(packet, build_rcdata_pkt());
+    CLOCK_ScheduleMixer(sumd_period);  // channels ready for the next packet
+    return sumd_period;
 }
 
 static void initialize()
@@ -129,8 +90,6 @@ static void initialize()
 #endif
     UART_Initialize();
     UART_SetDataRate(SUMD_DATARATE);
-    state = ST_DATA1;
-    mixer_runtime = 50;
     sumd_period = Model.proto_opts[PROTO_OPTS_PERIOD] ? (Model.proto_opts[PROTO_OPTS_PERIOD] * 1000) : SUMD_FRAME_PERIOD_STD;
 
     CLOCK_StartTimer(1000, serial_cb);
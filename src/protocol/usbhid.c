@@ -78,12 +78,6 @@ static void build_data_pkt()
     packet[USBHID_ANALOG_CHANNELS] = digital;
 }
 
-static enum {
-    ST_DATA1,
-    ST_DATA2,
-} state;
-
-static u16 mixer_runtime;
 // ms suffix on usbhid_period_ms to indicate that it's in milliseconds not microseconds like other protocols
 static u16 usbhid_period_ms;
 static u16 usbhid_cb()
@@ -102,23 +96,13 @@ static u16 usbhid_cb()
         HID_SetInterval(usbhid_period_ms);
         HID_Enable();
     }
-    switch (state) {
-        case ST_DATA1:
-            CLOCK_RunMixer();    // clears mixer_sync, which is then set when mixer update complete
-            state = ST_DATA2;
-            return mixer_runtime;
-
-        case ST_DATA2:
-            if (mixer_sync != MIX_DONE && mixer_runtime < 2000) mixer_runtime += 50;
-            build_data_pkt();
-            HID_Write(packet, sizeof(packet));
-            state = ST_DATA1;
-            // return with - 200 in case host is polling slightly faster than our clock
-            // this doesn't guarantee perfect timing, but it should be sufficient to
-            // catch most variations and get us back to waiting for the host
-            return usbhid_period_ms * 1000 - mixer_runtime - 200;
-    }
-    return usbhid_period_ms * 1000 - 200;   // avoid compiler warning
+    build_data_pkt();
+    HID_Write(packet, sizeof(packet));
+    // return with - 200 in case host is polling slightly faster than our clock
+    // this doesn't guarantee perfect timing, but it should be sufficient to
+    // catch most variations and get us back to waiting for the host
+    CLOCK_ScheduleMixer(usbhid_period_ms * 1000 - 200);  // channels ready for the next packet
+    return usbhid_period_ms * 1000 - 200;
 }
 
 static void deinit()
@@ -130,8 +114,6 @@ static void deinit()
 static void initialize()
 {
     CLOCK_StopTimer();
-    state = ST_DATA1;
-    mixer_runtime = 50;
     num_channels = Model.num_channels;
     usbhid_period_ms = period_index_to_ms(Model.proto_opts[PROTO_OPTS_PERIOD]);
     HID_SetInterval(usbhid_period_ms);
@@ -128,8 +128,8 @@ static u8 process_packet(void)
     u16 crc = 0xb5d2;
 
     // unscramble address and reverse order
+    crc = CRC16_Update(crc, raw_packet, ADDRESS_LENGTH - Model.proto_opts[PROTOOPTS_ADDRESS]);
     for (i = 0; i < ADDRESS_LENGTH - Model.proto_opts[PROTOOPTS_ADDRESS]; i++) {
-        crc = crc16_update(crc, raw_packet[i], 8);
         if (Model.proto_opts[PROTOOPTS_UNSCRAMBLED])
             xn297dump.packet[ADDRESS_LENGTH - Model.proto_opts[PROTOOPTS_ADDRESS] - i - 1] = raw_packet[i];
         else
@@ -137,8 +137,9 @@ static u8 process_packet(void)
     }
 
     // unscramble payload
-    for (i = ADDRESS_LENGTH - Model.proto_opts[PROTOOPTS_ADDRESS]; i < xn297dump.pkt_len - CRC_LENGTH; i++) {
-        crc = crc16_update(crc, raw_packet[i], 8);
+    if (xn297dump.pkt_len - CRC_LENGTH > i)
+        crc = CRC16_Update(crc, &raw_packet[i], xn297dump.pkt_len - CRC_LENGTH - i);
+    for (; i < xn297dump.pkt_len - CRC_LENGTH; i++) {
         if (Model.proto_opts[PROTOOPTS_UNSCRAMBLED])
             xn297dump.packet[i] = bit_reverse(raw_packet[i]);
         else
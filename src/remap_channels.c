@@ -119,5 +119,6 @@ void RemapChannelsForProtocol(const u8 *oldmap)
                 break;
         }
     }
+    //Sort and recompile the mixers so the mixer ISR uses the new destinations
     MIXER_SetMixers(NULL, 0);
 }
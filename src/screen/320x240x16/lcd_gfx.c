@@ -441,6 +441,13 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
     fclose(fh);
     LCD_DrawStop(); 
 }
+
+u8 LCD_ReadWindowedImageFromFile(const char *file, u16 *buf, u16 w, u16 h, u16 x_off, u16 y_off)
+{
+    //PBM images are drawn straight from the file
+    (void)file; (void)buf; (void)w; (void)h; (void)x_off; (void)y_off;
+    return 0;
+}
 #else
 u8 LCD_ImageIsTransparent(const char *file)
 {
@@ -494,35 +501,35 @@ u8 LCD_ImageDimensions(const char *file, u16 *w, u16 *h)
     return 1;
 }
 
-void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h, u16 x_off, u16 y_off)
-{
-    int i, j;
-    FILE *fh;
-    unsigned transparent = 0;
-    unsigned row_has_transparency = 0;
-    (void)row_has_transparency;
-
-    u8 buf[480 * 2];
-
-    if (w == 0 || h == 0)
-        return;
+struct bmp_info {
+    u32 offset;
+    u32 img_w;
+    u32 img_h;
+    unsigned transparent;
+    unsigned missing;
+};
 
-    fh = fopen(file, "rb");
+/* Opens a 16bpp BMP and checks its header.  buf must hold at least 0x46 bytes
+ * Returns NULL if the file is missing (info->missing is set) or the format is
+ * not supported */
+static FILE *bmp_open(const char *file, u8 *buf, struct bmp_info *info)
+{
+    FILE *fh = fopen(file, "rb");
+    info->missing = ! fh;
     if(! fh) {
         printf("DEBUG: LCD_DrawWindowedImageFromFile: Image not found: %s\n", file);
-        if (w > 0 && h > 0)
-            LCD_FillRect(x, y, w, h, 0);
-        return;
+        return NULL;
     }
     setbuf(fh, 0);
-    u32 img_w, img_h, offset, compression;
+    u32 compression;
 
     if(fread(buf, 0x46, 1, fh) != 1 || buf[0] != 'B' || buf[1] != 'M')
     {
         fclose(fh);
         printf("DEBUG: LCD_DrawWindowedImageFromFile: Buffer read issue?\n");
-        return;
+        return NULL;
     }
+    info->transparent = 0;
     compression = *((u32 *)(buf + 0x1e));
     if(*((u16 *)(buf + 0x1a)) != 1      /* 1 plane */
        || *((u16 *)(buf + 0x1c)) != 16  /* 16bpp */
@@ -531,7 +538,7 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
     {
         fclose(fh);
         printf("DEBUG: LCD_DrawWindowedImageFromFile: BMP Format not correct\n");
-        return;
+        return NULL;
     }
     if(compression == 3)
     {
@@ -540,19 +547,74 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
            && *((u16 *)(buf + 0x3e)) == 0x001f
            && *((u16 *)(buf + 0x42)) == 0x8000)
         {
-            transparent = 1;
+            info->transparent = 1;
         } else if(*((u16 *)(buf + 0x36)) != 0xf800 
            || *((u16 *)(buf + 0x3a)) != 0x07e0
            || *((u16 *)(buf + 0x3e)) != 0x001f)
         {
             fclose(fh);
             printf("DEBUG: LCD_DrawWindowedImageFromFile: BMP Format not correct second check\n");
-            return;
+            return NULL;
         }
     }
-    offset = *((u32 *)(buf + 0x0a));
-    img_w = *((u32 *)(buf + 0x12));
-    img_h = *((u32 *)(buf + 0x16));
+    info->offset = *((u32 *)(buf + 0x0a));
+    info->img_w = *((u32 *)(buf + 0x12));
+    info->img_h = *((u32 *)(buf + 0x16));
+    return fh;
+}
+
+/* Copies a window of an opaque BMP into buf as 565 pixels, top row first
+ * Returns 0 if the image is missing, transparent or too small */
+u8 LCD_ReadWindowedImageFromFile(const char *file, u16 *buf, u16 w, u16 h, u16 x_off, u16 y_off)
+{
+    u8 hdr[0x46];
+    struct bmp_info info;
+    FILE *fh = bmp_open(file, hdr, &info);
+    if (! fh)
+        return 0;
+    u8 ok = ! info.transparent && w + x_off <= info.img_w && h + y_off <= info.img_h;
+    //Rows are padded to 4 bytes
+    u32 row_bytes = (info.img_w * 2 + 3) & ~3;
+    for (int j = h - 1; ok && j >= 0; j--) {
+        /* Bitmap start is at lower-left corner */
+        fseek(fh, info.offset + row_bytes * (info.img_h - (y_off + j) - 1) + x_off * 2, SEEK_SET);
+        u16 *row = buf + j * w;
+        if (fread(row, 2 * w, 1, fh) != 1) {
+            ok = 0;
+            break;
+        }
+        if (LCD_DEPTH == 1) {
+            for (int i = 0; i < w; i++)
+                row[i] = (row[i] & 0x8410) == 0x8410 ?  0 : 0xffff;
+        }
+    }
+    fclose(fh);
+    return ok;
+}
+
+void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h, u16 x_off, u16 y_off)
+{
+    int i, j;
+    FILE *fh;
+    unsigned transparent;
+    unsigned row_has_transparency = 0;
+    (void)row_has_transparency;
+
+    u8 buf[480 * 2];
+
+    if (w == 0 || h == 0)
+        return;
+
+    struct bmp_info info;
+    fh = bmp_open(file, buf, &info);
+    if(! fh) {
+        //Only a missing image is blanked, one with a bad header is skipped
+        if (info.missing && w > 0 && h > 0)
+            LCD_FillRect(x, y, w, h, 0);
+        return;
+    }
+    u32 img_w = info.img_w, img_h = info.img_h, offset = info.offset;
+    transparent = info.transparent;
     if(w < 0)
         w = img_w;
     if(h < 0)
@@ -610,11 +672,13 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
             }
 #endif
         } else {
-            for (i = 0; i < w; i++ ) {
-                if (LCD_DEPTH == 1)
-                    *color = (*color & 0x8410) == 0x8410 ?  0 : 0xffff;
-                LCD_DrawPixel(*color++);
-            }
+#if LCD_DEPTH == 1
+            //LCD_DrawPixels is only available on color displays
+            for (i = 0; i < w; i++)
+                LCD_DrawPixel((color[i] & 0x8410) == 0x8410 ?  0 : 0xffff);
+#else
+            LCD_DrawPixels(color, w);
+#endif
         }
         if((u16)w < img_w) {
             fseek(fh, 2 * (img_w - w), SEEK_CUR);
@@ -47,7 +47,6 @@
 #define CHAR_SPACING 1
 #define NUM_FONTS 10
 
-#define FONT_NAME_LEN 9
 char FontNames[NUM_FONTS][FONT_NAME_LEN];
 
 static struct {
@@ -71,23 +70,35 @@ void LCD_PrintCharXY(unsigned int x, unsigned int y, u32 c)
         return;
     }
     // Check if the requested character is available
-    LCD_DrawStart(x, y, x + width - 1,  y + get_height() - 1, DRAW_NWSE);
-    for (col = 0; col < width; col++)
+    u8 height = get_height();
+    u8 row_bytes = (height - 1) / 8 + 1;
+    LCD_DrawStart(x, y, x + width - 1,  y + height - 1, DRAW_NWSE);
+    // Data is stored by column, right aligned and drawn top to bottom, but
+    // the window is filled row by row
+    for (row = 0; row < height; ++row)
     {
-        const u8 *data = offset++;
-        u8 bit = 0;
-        // Data is right aligned,adrawn top to bottom
-        for (row = 0; row < get_height(); ++row)
+        const u8 *data = offset + row / 8;
+        u8 mask = 1 << (row % 8);
+#ifdef TRANSPARENT_COLOR
+        //The display skips transparent pixels, so the window is streamed
+        for (col = 0; col < width; col++, data += row_bytes)
+            LCD_DrawPixel((*data & mask) ? cur_str.color : TRANSPARENT_COLOR);
+#else
+        //Only the first pixel of each run needs to be positioned
+        u8 in_run = 0;
+        for (col = 0; col < width; col++, data += row_bytes)
         {
-            if (bit == 8) {
-                data = offset++;
-                bit = 0;
+            if (*data & mask) {
+                if (in_run)
+                    LCD_DrawPixel(cur_str.color);
+                else
+                    LCD_DrawPixelXY(x + col, y + row, cur_str.color);
+                in_run = 1;
+            } else {
+                in_run = 0;
             }
-            if (*data & (1 << bit)) {
-                LCD_DrawPixelXY(x + col, y + row, cur_str.color);
-            }
-            bit++;
         }
+#endif
     }
     LCD_DrawStop();
 }
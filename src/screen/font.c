@@ -20,19 +20,70 @@ static FSHANDLE FontFH;
 
 #define RANGE_TABLE_SIZE 20
 
-static struct font_def
+/* With a glyph cache, the header of every font used is kept in RAM so that
+ * switching fonts does not touch the filesystem.  The font file is only
+ * (re)opened when a glyph is not in the cache */
+#if FONT_CACHE_SIZE
+    #define NUM_FONT_DEFS 10
+#else
+    #define NUM_FONT_DEFS 1
+#endif
+
+struct font_def
 {
-    FILE *fh;
+    char name[FONT_NAME_LEN];
     u8 height;          /* Character height for storage        */
     u16 range[2 * (RANGE_TABLE_SIZE + 1)];  /* Array containing the ranges of supported characters */
-}font;
+};
+
+static struct font_def fonts[NUM_FONT_DEFS];
+static struct font_def *font;   /* Current font */
+static FILE *font_fh;
+static struct font_def *font_fh_def;   /* Font that font_fh belongs to */
+
+#if FONT_CACHE_SIZE
+struct glyph
+{
+    u16 c;
+    u8 font;            /* Index in fonts[] + 1, 0 if unused */
+    u8 width;
+    u8 size;
+    u16 last_used;
+    u8 data[CHAR_BUF_SIZE];
+};
+static struct glyph glyphs[FONT_CACHE_SIZE];
+static u16 glyph_tick;
+static u8 next_font_def;
+#endif
+
+static u8 open_file(struct font_def *def)
+{
+    char filename[20];
+    if (font_fh_def == def)
+        return 1;
+    if (font_fh) {
+        fclose(font_fh);
+        font_fh = NULL;
+        font_fh_def = NULL;
+    }
+    sprintf(filename, "media/%s.fon", def->name);
+    finit(&FontFH, "media");
+    font_fh = fopen2(&FontFH, filename, "rb");
+    if (! font_fh) {
+        printf("Couldn't open font file: %s\n", filename);
+        return 0;
+    }
+    setbuf(font_fh, 0);
+    font_fh_def = def;
+    return 1;
+}
 
 static u8 get_char_range(u32 c, u32 *begin, u32 *end)
 {
     u32 offset = 0;
     u32 pos = 5;
     u8 buf[6];
-    u16 *range = font.range;
+    u16 *range = font->range;
     while(1) {
         if (range[0] == 0 && range[1] == 0)
             break;
@@ -44,88 +95,192 @@ static u8 get_char_range(u32 c, u32 *begin, u32 *end)
         range += 2;
         pos += 4;
     }
-    fseek(font.fh, pos, SEEK_SET);
-    fread(buf, 6, 1, font.fh);
+    fseek(font_fh, pos, SEEK_SET);
+    fread(buf, 6, 1, font_fh);
     *begin = buf[0] | (buf[1] << 8) | (buf[2] << 16);
     *end   = buf[3] | (buf[4] << 8) | (buf[5] << 16);
     return 1;
 }
 
-void char_read(u8 *fontbuf, u32 c, u8 *width)
+static void read_glyph(u8 *fontbuf, u32 c, u8 *width, u8 *size)
 {
     u32 begin;
     u32 end;
 
-    u8 row_bytes = ((font.height - 1) / 8) + 1;
+    *width = 0;
+    *size = 0;
+    if (! font || ! open_file(font))
+        return;
+    u8 row_bytes = ((font->height - 1) / 8) + 1;
     get_char_range(c, &begin, &end);
     *width = (end - begin) / row_bytes;
-    fseek(font.fh, begin, SEEK_SET);
+    fseek(font_fh, begin, SEEK_SET);
     if (end - begin > CHAR_BUF_SIZE) {
         printf("Character '%04d' is larger than allowed size\n", (int)c);
         end = begin + (CHAR_BUF_SIZE / row_bytes) * row_bytes;
         *width = (end - begin) / row_bytes;
     }
-    fread(fontbuf, end - begin, 1, font.fh);
+    *size = end - begin;
+    fread(fontbuf, end - begin, 1, font_fh);
+}
+
+#if FONT_CACHE_SIZE
+static void flush_glyphs(u8 font_id)
+{
+    for (int i = 0; i < FONT_CACHE_SIZE; i++) {
+        if (glyphs[i].font == font_id)
+            glyphs[i].font = 0;
+    }
+}
+
+// Returns the cached glyph of c in the current font, loading it if needed
+static struct glyph *get_glyph(u32 c)
+{
+    u8 font_id = font - fonts + 1;
+    struct glyph *lru = &glyphs[0];
+    if (++glyph_tick == 0) {
+        //Restart the LRU ordering rather than handle the wrap
+        for (int i = 0; i < FONT_CACHE_SIZE; i++)
+            glyphs[i].last_used = 0;
+        glyph_tick = 1;
+    }
+    for (int i = 0; i < FONT_CACHE_SIZE; i++) {
+        struct glyph *g = &glyphs[i];
+        if (g->font == font_id && g->c == c) {
+            g->last_used = glyph_tick;
+            return g;
+        }
+        if (g->last_used < lru->last_used)
+            lru = g;
+    }
+    read_glyph(lru->data, c, &lru->width, &lru->size);
+    //Glyphs that could not be read are not cached, so the read is retried
+    lru->font = lru->width ? font_id : 0;
+    lru->c = c;
+    lru->last_used = glyph_tick;
+    return lru;
+}
+#endif
+
+void char_read(u8 *fontbuf, u32 c, u8 *width)
+{
+#if FONT_CACHE_SIZE
+    if (font && c <= 0xffff) {
+        struct glyph *g = get_glyph(c);
+        memcpy(fontbuf, g->data, g->size);
+        *width = g->width;
+        return;
+    }
+#endif
+    u8 size;
+    read_glyph(fontbuf, c, width, &size);
 }
 
 u8 get_width(u32 c)
 {
+#if FONT_CACHE_SIZE
+    if (font && c <= 0xffff)
+        return get_glyph(c)->width;
+#endif
     u32 begin;
     u32 end;
 
-    u8 row_bytes = ((font.height - 1) / 8) + 1;
+    if (! font || ! open_file(font))
+        return 0;
+    u8 row_bytes = ((font->height - 1) / 8) + 1;
     get_char_range(c, &begin, &end);
     return (end - begin) / row_bytes;
 }
 
 u8 get_height()
 {
-    return font.height;
+    return font ? font->height : 0;
 }
 
 void close_font()
 {
-    if(font.fh) {
-        fclose(font.fh);
-        font.fh = NULL;
+    if(font_fh) {
+        fclose(font_fh);
+        font_fh = NULL;
+        font_fh_def = NULL;
     }
+    font = NULL;
 }
 
-u8 open_font(const char* fontname)
+static u8 load_font(struct font_def *def, const char* fontname)
 {
-    char filename[20];
-    close_font();
-
-    sprintf(filename, "media/%s.fon", fontname);
-    finit(&FontFH, "media");
-    font.fh = fopen2(&FontFH, filename, "rb");
-    if (! font.fh) {
-        printf("Couldn't open font file: %s\n", filename);
+    strlcpy(def->name, fontname, sizeof(def->name));
+    font_fh_def = NULL;  //Always reopen, the file position must be at the start
+    if (! open_file(def))
         return 0;
-    }
-    setbuf(font.fh, 0);
-    if(fread(&font.height, 1, 1, font.fh) != 1) {
+    if(fread(&def->height, 1, 1, font_fh) != 1) {
         printf("Failed to read height from font\n");
-        fclose(font.fh);
-        font.fh = NULL;
         return 0;
     }
 
     int range_idx = 0;
     u8 buf[4];
     while(1) {
-        if (fread(buf, 4, 1, font.fh) != 1) {
+        if (range_idx == 2 * (RANGE_TABLE_SIZE + 1) || fread(buf, 4, 1, font_fh) != 1) {
             printf("Failed to parse font range table\n");
-            fclose(font.fh);
-            font.fh = NULL;
             return 0;
         }
         u16 start_c = buf[0] | (buf[1] << 8);
         u16 end_c = buf[2] | (buf[3] << 8);
-        font.range[range_idx++] = start_c;
-        font.range[range_idx++] = end_c;
+        def->range[range_idx++] = start_c;
+        def->range[range_idx++] = end_c;
         if (start_c == 0 && end_c == 0)
             break;
     }
     return 1;
 }
+
+u8 open_font(const char* fontname)
+{
+    struct font_def *def = &fonts[0];
+#if FONT_CACHE_SIZE
+    //The file of the previous font is kept open until a glyph misses the cache
+    font = NULL;
+    for (int i = 0; i < NUM_FONT_DEFS; i++) {
+        if (fonts[i].name[0] && strcmp(fonts[i].name, fontname) == 0) {
+            font = &fonts[i];
+            return 1;
+        }
+    }
+    //Replace the oldest font and its glyphs
+    def = &fonts[next_font_def];
+    next_font_def = (next_font_def + 1) % NUM_FONT_DEFS;
+    flush_glyphs(def - fonts + 1);
+#else
+    close_font();
+#endif
+    if (! load_font(def, fontname)) {
+        close_font();
+        def->name[0] = '\0';
+        return 0;
+    }
+    font = def;
+    return 1;
+}
+
+/* Drops every cached font header and glyph (i.e. after the font files were
+ * changed over USB).  The current font is reloaded from its file */
+void FONT_Flush()
+{
+    char name[FONT_NAME_LEN];
+    name[0] = '\0';
+    if (font)
+        strlcpy(name, font->name, sizeof(name));
+    close_font();
+    memset(fonts, 0, sizeof(fonts));
+#if FONT_CACHE_SIZE
+    memset(glyphs, 0, sizeof(glyphs));
+    glyph_tick = 0;
+    next_font_def = 0;
+#endif
+    if (name[0])
+        open_font(name);
+}
+
+#define TESTNAME font
+#include "tests.h"
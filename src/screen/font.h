@@ -16,6 +16,7 @@
 #define __FONT_H__
 
 #define CHAR_BUF_SIZE 80
+#define FONT_NAME_LEN 9
 
 extern void char_read(u8 *font, u32 c, u8 *width);
 extern u8 get_width(u32 c);
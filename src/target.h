@@ -79,6 +79,7 @@ enum DrawDir {
     DRAW_SWNE,
 };
 void LCD_DrawPixel(unsigned int color);
+void LCD_DrawPixels(const u16 *colors, unsigned count);  //Color displays only
 void LCD_DrawMappedPixel(unsigned int color);
 void LCD_DrawPixelXY(unsigned int x, unsigned int y, unsigned int color);
 void LCD_DrawMappedPixelXY(unsigned int x, unsigned int y, unsigned int color);
@@ -134,6 +135,7 @@ enum MsecCallback {
 
 void CLOCK_Init(void);
 u32 CLOCK_getms(void);
+u16 CLOCK_getus(void);  // free running, wraps every 65.536ms
 void CLOCK_StartTimer(unsigned us, u16 (*cb)(void));
 void CLOCK_RunOnce(void (*cb)(void));
 void CLOCK_StopTimer();
@@ -142,6 +144,8 @@ void CLOCK_ClearMsecCallback(int cb);
 void CLOCK_StartWatchdog();
 void CLOCK_ResetWatchdog();
 void CLOCK_RunMixer();
+void CLOCK_ScheduleMixer(u16 us);  // Have channels ready 'us' from now
+u16 CLOCK_MixerRuntime();  // Estimated time from mixer request to channels ready
 void CLOCK_StartMixer();
 typedef enum {
     MIX_TIMER,
@@ -178,6 +182,7 @@ extern void CHAN_SetButtonCfg(const char *str);
 s32 ADC_ReadRawInput(int channel);
 s32 SWITCH_ReadRawInput(int channel);
 s32 ADC_NormalizeChannel(int channel);
+void ADC_UpdateCalibration();
 
 /* SPI Flash */
 void SPIFlash_Init();
@@ -107,6 +107,12 @@ void LCD_DrawPixel(unsigned int color)
     LCD_DATA = color;
 }
 
+void LCD_DrawPixels(const u16 *colors, unsigned count)
+{
+    while (count--)
+        LCD_DATA = *colors++;
+}
+
 void LCD_DrawPixelXY(unsigned int x, unsigned int y, unsigned int color)
 {
     lcd_set_pos(x, y);
@@ -34,3 +34,9 @@ void LCD_DrawPixel(unsigned int color)
         gui.y += gui.dir;
     }
 }
+
+void LCD_DrawPixels(const u16 *colors, unsigned count)
+{
+    while (count--)
+        LCD_DrawPixel(*colors++);
+}
@@ -11,6 +11,9 @@
 #ifndef DEVOFS_CREATE_FILE
     #define DEVOFS_CREATE_FILE 0
 #endif
+#ifndef DEVOFS_INDEX_SIZE
+    #define DEVOFS_INDEX_SIZE 64
+#endif
 
 enum {
     SECTOR_SIZE         = 4096,
@@ -44,6 +47,101 @@ static FATFS *_fs, *_mountfs;
 static int _spiread(void * buf, int addr, int len);
 static int _get_addr(int addr, int offset);
 
+#if DEVOFS_INDEX_SIZE
+/* In-RAM directory index
+ * Maps a hash of (parent_dir, name) to the address of live file/dir headers
+ * so _find_file only needs to read the matching header(s) instead of walking
+ * the whole log.  The table is filled at mount and by df_compact and kept
+ * current when headers are written or deleted.  If there are more live entries
+ * than fit, the first DEVOFS_INDEX_SIZE (in log order, so directories and the
+ * root files come first) are kept and _find_file scans only when a name is not
+ * in the index.  Files found by scanning are added once there is room again.
+ * Addresses fit in 16 bits because SECTOR_COUNT * SECTOR_SIZE is 64kB */
+struct index_entry {
+    u16 key;
+    u16 addr;
+};
+static struct index_entry _index[DEVOFS_INDEX_SIZE];
+static int _index_count;
+static int _index_size = DEVOFS_INDEX_SIZE;
+static u8 _index_complete;  //Every live entry is in the index, so a miss needs no scan
+
+static u16 _index_key(u8 parent_dir, const char *name)
+{
+    u16 key = parent_dir;
+    int i;
+    for (i = 0; i < 11; i++)
+        key = (key << 5) + key + (u8)name[i];
+    return key;
+}
+
+static void _index_reset()
+{
+    _index_count = 0;
+    _index_complete = 1;
+}
+
+static void _index_add(const struct file_header *fh, int addr)
+{
+    if (_index_count == _index_size) {
+        //Out of room, names that are not indexed must be scanned for
+        _index_complete = 0;
+        return;
+    }
+    _index[_index_count].key = _index_key(fh->parent_dir, fh->name);
+    _index[_index_count].addr = addr;
+    _index_count++;
+}
+
+static void _index_remove(int addr)
+{
+    int i;
+    for (i = 0; i < _index_count; i++) {
+        if (_index[i].addr == addr) {
+            _index[i] = _index[--_index_count];
+            return;
+        }
+    }
+}
+
+static void _index_build(int addr)
+{
+    struct file_header fh;
+    _index_reset();
+    _spiread(&fh, addr, sizeof(struct file_header));
+    while(fh.type != FILEOBJ_NONE) {
+        if (! FILE_DELETED(fh))
+            _index_add(&fh, addr);
+        addr = _get_addr(addr, sizeof(struct file_header) + FILE_SIZE(fh));
+        _spiread(&fh, addr, sizeof(struct file_header));
+    }
+}
+
+//Limit the number of indexed entries (0 disables the index).  Takes effect at the next mount or compact
+void _set_index_size(int size)
+{
+    _index_size = (size < 0 || size > DEVOFS_INDEX_SIZE) ? DEVOFS_INDEX_SIZE : size;
+}
+
+int _get_index_count()
+{
+    return _index_count;
+}
+
+int _get_index_complete()
+{
+    return _index_complete;
+}
+#else
+#define _index_reset()
+#define _index_add(fh, addr)
+#define _index_remove(addr)
+#define _index_build(addr)
+void _set_index_size(int size) { (void)size; }
+int _get_index_count() { return 0; }
+int _get_index_complete() { return 0; }
+#endif
+
 static inline int _get_next_sector(int sec) {
     return (sec + 1) % SECTOR_COUNT;
 }
@@ -83,6 +181,7 @@ FRESULT df_compact()
     int buf_len;
     disk_erasep(write_sec);
     _write_sector_id(write_sec, SECTORID_START);
+    _index_reset();
     while(1) {
         // process one file/directory
         head = _mountfs;
@@ -100,6 +199,7 @@ FRESULT df_compact()
             continue;
         }
         read_addr = _get_addr(read_addr, sizeof(struct file_header));
+        _index_add(&fh, write_sec * SECTOR_SIZE + write_off);
         //write header/directory-entry
         memcpy(buf, &fh, sizeof(struct file_header));
         buf_len = sizeof(struct file_header);
@@ -258,6 +358,7 @@ FRESULT df_mount (FATFS* fs)
     //Must initialize file_addr and file_header in case the 1st action on the FS is a write
     fs->file_addr = fs->start_sector * SECTOR_SIZE + 1; //reset current position
     _spiread(&fs->file_header, fs->file_addr, sizeof(struct file_header));
+    _index_build(fs->file_addr);
     return FR_OK;
 }
 
@@ -323,12 +424,30 @@ FRESULT _find_file(FATFS *fs, const char *fullname)
    char name[11];
 
    _format_filename(fullname, name);
+#if DEVOFS_INDEX_SIZE
+   int i;
+   u16 key = _index_key(fs->parent_dir, name);
+   for (i = 0; i < _index_count; i++) {
+       if (_index[i].key != key)
+           continue;
+       _spiread(&fs->file_header, _index[i].addr, sizeof(struct file_header));
+       if (fs->file_header.type != FILEOBJ_NONE && ! FILE_DELETED(fs->file_header)
+           && fs->parent_dir == fs->file_header.parent_dir && memcmp(fs->file_header.name, name, 11) == 0) {
+           fs->file_addr = _index[i].addr;
+           fs->file_cur_pos = -1;
+           return FR_OK;
+       }
+   }
+   if (_index_complete)
+       return FR_NO_PATH;
+#endif
    _spiread(&fs->file_header, fs->file_addr, sizeof(struct file_header));
 
    while(fs->file_header.type != FILEOBJ_NONE) {
        if (! FILE_DELETED(fs->file_header) && fs->parent_dir == fs->file_header.parent_dir && memcmp(fs->file_header.name, name, 11) == 0) {
            //Found matching file
            fs->file_cur_pos = -1;
+           _index_add(&fs->file_header, fs->file_addr);
            return FR_OK;
        }
        fs->file_addr = _get_addr(fs->file_addr, sizeof(struct file_header) + FILE_SIZE(fs->file_header));
@@ -447,6 +566,7 @@ void _create_empty_file(int delete_first)
     if (delete_first) {
         data[0] = FILEOBJ_FILEDEL;
         disk_writep_rand(data, _fs->file_addr / SECTOR_SIZE, _fs->file_addr % SECTOR_SIZE, 1);
+        _index_remove(_fs->file_addr);
         _fs->file_addr = _get_next_write_addr();
     }
 
@@ -478,6 +598,7 @@ void _create_empty_file(int delete_first)
         _fs->file_header.size2 = 0; 
         _fs->file_header.size3 = 0; 
         _spiwrite(&_fs->file_header, _fs->file_addr, sizeof(struct file_header));
+        _index_add(&_fs->file_header, _fs->file_addr);
         //place the maximum allocated filesize as a place-holder
         _fs->file_header.size1 = 0xff & (max_size >> 16);
         _fs->file_header.size2 = 0xff & (max_size >> 8);
@@ -486,6 +607,7 @@ void _create_empty_file(int delete_first)
         _fs->file_cur_pos = 0;
     } else {
         _spiwrite(&_fs->file_header, _fs->file_addr, sizeof(struct file_header));
+        _index_add(&_fs->file_header, _fs->file_addr);
     }
 }
 
@@ -500,6 +622,7 @@ FRESULT df_unlink(const char *name)
         u8 data[2];
         data[0] = _fs->file_header.type |= FILEOBJ_DELMASK;
         disk_writep_rand(data, _fs->file_addr / SECTOR_SIZE, _fs->file_addr % SECTOR_SIZE, 1);
+        _index_remove(_fs->file_addr);
         return FR_OK;
     }
     return FR_NO_FILE;
@@ -7,6 +7,10 @@
 extern char image_file[1024];
 extern int _get_next_write_addr();
 extern int _get_free_space();
+extern void _set_index_size(int size);
+extern int _get_index_count();
+extern int _get_index_complete();
+extern unsigned read_count;
 
 MODULE = DevoFS		PACKAGE = DevoFS		
 
@@ -172,6 +176,14 @@ close()
     OUTPUT:
         RETVAL
 
+int
+unlink(path)
+        char *path
+    CODE:
+        RETVAL = df_unlink(path);
+    OUTPUT:
+        RETVAL
+
 int
 compact()
     CODE:
@@ -201,6 +213,34 @@ _get_free_space()
     OUTPUT:
         RETVAL
 
+void
+_set_index_size(size)
+        int size
+    CODE:
+        _set_index_size(size);
+
+int
+_get_index_count()
+    CODE:
+        RETVAL = _get_index_count();
+    OUTPUT:
+        RETVAL
+
+int
+_get_index_complete()
+    CODE:
+        RETVAL = _get_index_complete();
+    OUTPUT:
+        RETVAL
+
+unsigned
+_get_read_count()
+    CODE:
+        RETVAL = read_count;
+        read_count = 0;
+    OUTPUT:
+        RETVAL
+
 MODULE = DevoFS PACKAGE = FATFSPtr PREFIX = fatfs_
 
 void
@@ -19,6 +19,7 @@
 #include <string.h>
 
 char image_file[1024];
+unsigned read_count;   /* Number of disk_readp calls, used by the benchmarks */
 #define dbgprintf if(0) printf
 /*-----------------------------------------------------------------------*/
 /* Initialize Disk Drive                                                 */
@@ -46,6 +47,7 @@ DRESULT disk_readp (
 )
 {
 	dbgprintf("Reading sector: %d, offset: %d size: %d\n", (int)sector, (int)sofs, (int)count);
+	read_count++;
 	fseek(fh, sector * 4096 + sofs, SEEK_SET);
 	int res = fread(dest, count, 1, fh);
         int max = count > 64 ? 64 : count;
@@ -15,7 +15,7 @@ use Digest::MD5;
 use Fcntl;
 use Data::Dumper;
 
-use Test::More tests => 213;
+use Test::More tests => 244;
 BEGIN { use_ok('DevoFS') };
 
 #########################
@@ -43,6 +43,8 @@ change_filesize();
 file_sector_align();
 write_around_the_horn();
 multiple_file_descriptors();
+directory_index();
+index_fallback();
 
 sub msg
 {
@@ -335,3 +337,56 @@ sub multiple_file_descriptors {
     is(Digest::MD5::md5_hex($data2), $files{"media/config.ini"}{MD5}, msg("Read 2 data verified"));
     is(Digest::MD5::md5_hex($data3), $files{"models/model10.ini"}{MD5}, msg("Read 3 data verified"));
 }
+
+sub _count_entries {
+    my %dirs;
+    foreach my $file (keys %files) {
+        my @path = split(/\//, $file);
+        pop @path;
+        $dirs{join("/", @path[0..$_])} = 1 for (0 .. $#path);
+    }
+    return scalar(keys %files) + scalar(keys %dirs);
+}
+
+sub directory_index {
+    _reset_fs();
+    my $entries = _count_entries();
+    is(DevoFS::_get_index_count(), $entries, msg("Index built at mount"));
+    is(DevoFS::_get_index_complete(), 1, msg("All entries are indexed"));
+    my $len = 0;
+    DevoFS::open("protocol/devo.mod", O_CREAT);
+    DevoFS::write($files{"protocol/devo.mod"}{DATA}, 4096, $len);
+    DevoFS::close();
+    is(DevoFS::_get_index_count(), $entries, msg("Index updated on rewrite"));
+    is(DevoFS::unlink("models/model10.ini"), 0, msg("Unlinked file"));
+    delete $files{"models/model10.ini"};
+    $entries--;
+    is(DevoFS::_get_index_count(), $entries, msg("Index updated on unlink"));
+    isnt(DevoFS::open("models/model10.ini", 0), 0, msg("Unlinked file is not found"));
+    _compare_fs(\%files, "before compact");
+    DevoFS::compact();
+    is(DevoFS::_get_index_count(), $entries, msg("Index rebuilt on compact"));
+    _compare_fs(\%files, "after compact");
+}
+
+sub index_fallback {
+    # An index that is too small keeps what fits and scans for the rest
+    DevoFS::_set_index_size(6);
+    _reset_fs();
+    my $entries = _count_entries();
+    is(DevoFS::_get_index_count(), 6, msg("Index filled to capacity"));
+    is(DevoFS::_get_index_complete(), 0, msg("Index is partial"));
+    _compare_fs(\%files, "partial index");
+    foreach my $file ("media/config.ini", "media/sound.ini", "models/default.ini", "models/model10.ini") {
+        is(DevoFS::unlink($file), 0, msg("Unlinked $file"));
+        delete $files{$file};
+        $entries--;
+    }
+    _compare_fs(\%files, "after unlink");
+    # Compact drops the deleted entries so the rest fit again
+    DevoFS::compact();
+    is(DevoFS::_get_index_count(), $entries, msg("Index rebuilt after compact"));
+    is(DevoFS::_get_index_complete(), 1, msg("Index is complete after compact"));
+    _compare_fs(\%files, "after compact");
+    DevoFS::_set_index_size(-1);
+}
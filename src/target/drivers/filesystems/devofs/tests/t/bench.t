@@ -0,0 +1,88 @@
+#!/usr/bin/env perl
+
+# Open latency versus file count, with and without the directory index
+# Run with 'make test' or 'perl -Mblib t/bench.t'.  Results are printed as
+# diagnostics: disk reads and wall-clock time per df_open
+
+use strict;
+use warnings;
+
+use ExtUtils::testlib;
+use FindBin;
+use File::Temp;
+use File::Path;
+use Time::HiRes;
+
+use Test::More tests => 13;
+BEGIN { use_ok('DevoFS') };
+
+my $tmpdir = File::Temp::tempdir(CLEANUP => 1);
+my $REPEAT = 20;
+my $fat;
+
+diag(sprintf("%6s %8s %12s %12s %12s %12s", "files", "indexed", "reads/open", "us/open", "scan reads", "scan us"));
+foreach my $count (8, 16, 32, 48, 96, 160) {
+    my @names = build_image($count);
+    my($scan_reads, $scan_us) = bench_open(0, @names);
+    my($reads, $us, $complete) = bench_open(-1, @names);
+    diag(sprintf("%6d %8s %12.1f %12.1f %12.1f %12.1f", $count, $complete ? "all" : "partial", $reads, $us, $scan_reads, $scan_us));
+    # Once the index is full, names that did not fit are still found by scanning
+    ok($reads < $scan_reads, "$count files - index reduces reads per open");
+    ok(check_reads(@names), "$count files - file contents match");
+}
+DevoFS::_set_index_size(-1);
+
+# Build a filesystem with $count model files
+sub build_image {
+    my($count) = @_;
+    my $dir = "$tmpdir/fs$count";
+    File::Path::make_path("$dir/models", "$dir/media");
+    _write_file("$dir/tx.ini", "[general]\n");
+    _write_file("$dir/media/config.ini", "[general]\n");
+    my @names;
+    foreach my $i (1 .. $count) {
+        _write_file("$dir/models/model$i.ini", "name=Model$i\n" . ("x" x 200));
+        push @names, "models/model$i.ini";
+    }
+    system("python $FindBin::Bin/../../buildfs.py --dir $dir --fs $dir.img -c > /dev/null") == 0
+        or die "Failed to build $dir.img\n";
+    return @names;
+}
+
+sub _write_file {
+    my($file, $data) = @_;
+    open my $fh, ">", $file or die "Failed to write $file\n";
+    print $fh $data;
+    close $fh;
+}
+
+# Average disk reads and time to open each file, with the given index size
+sub bench_open {
+    my($index_size, @names) = @_;
+    DevoFS::_set_index_size($index_size);
+    $fat = DevoFS::mount($tmpdir . "/fs" . scalar(@names) . ".img");
+    die "Failed to mount image\n" if (! $fat);
+    my $complete = DevoFS::_get_index_complete();
+    DevoFS::_get_read_count();
+    my $start = Time::HiRes::time();
+    foreach (1 .. $REPEAT) {
+        foreach my $name (@names) {
+            DevoFS::open($name, 0) == 0 or die "Failed to open $name\n";
+        }
+    }
+    my $elapsed = Time::HiRes::time() - $start;
+    my $opens = $REPEAT * scalar(@names);
+    return (DevoFS::_get_read_count() / $opens, 1e6 * $elapsed / $opens, $complete);
+}
+
+sub check_reads {
+    my(@names) = @_;
+    foreach my $i (1 .. scalar(@names)) {
+        my $data = "";
+        my $len = 0;
+        return 0 if (DevoFS::open($names[$i - 1], 0) != 0);
+        DevoFS::read($data, 4096, $len);
+        return 0 if ($data ne "name=Model$i\n" . ("x" x 200));
+    }
+    return 1;
+}
@@ -19,10 +19,14 @@
 #include "target/drivers/mcu/stm32/adc.h"
 #include "target/drivers/mcu/stm32/dma.h"
 #include "target/drivers/mcu/stm32/rcc.h"
+#include "target/drivers/mcu/stm32/nvic.h"
+#include "adc_filter.h"
 
 #define NUM_ADC_CHANNELS (INP_HAS_CALIBRATION + 2)  // Inputs + Temprature + Voltage
 #define WINDOW_SIZE 10
 #define SAMPLE_COUNT NUM_ADC_CHANNELS * WINDOW_SIZE * ADC_OVERSAMPLE_WINDOW_COUNT
+#define HALF_SCANS (WINDOW_SIZE * ADC_OVERSAMPLE_WINDOW_COUNT / 2)  // Samples per channel in half the buffer
+ctassert((WINDOW_SIZE % 2) == 0, adc_window_size_not_even);
 
 #define CHAN_INVERT -1
 #define CHAN_NONINV  1
@@ -30,6 +34,8 @@
 unsigned ADC_Read(unsigned channel);
 volatile u16 adc_array_raw[NUM_ADC_CHANNELS];
 static volatile u16 adc_array_oversample[SAMPLE_COUNT];
+static struct ADCFilter adc_filter[NUM_ADC_CHANNELS];
+static struct CalibCoef adc_calib[INP_HAS_CALIBRATION];
 
 #if 0
     // These are the valid ADC pins for an STM32
@@ -106,6 +112,11 @@ void ADC_Init(void)
     adc_disable_temperature_sensor();
     printf("RNG Seed: %08x\n", (int)rand32());
 
+    for (unsigned i = 0; i < NUM_ADC_CHANNELS; i++)
+        ADCFILTER_Init(&adc_filter[i], ADC_FILTER_BOX);
+    //The battery voltage only needs to follow slow changes
+    ADCFILTER_Init(&adc_filter[NUM_ADC_CHANNELS-1], ADC_FILTER_EXP);
+
     /* The following is based on code from here: http://code.google.com/p/rayaairbot */
     /* Enable DMA clock */
     rcc_periph_clock_enable(get_rcc_from_port(ADC_DMA.dma));
@@ -138,8 +149,11 @@ void ADC_Init(void)
     DMA_disable_double_buffer_mode(ADC_DMA);
     /* continuous operation */
     dma_enable_circular_mode(ADC_DMA.dma, ADC_DMA.stream);
-    /* we want an interrupt after the adc is finished */
-    // dma_enable_transfer_complete_interrupt(ADC_DMA.dma, ADC_DMA.stream);
+    /* interrupt when each half of the buffer is filled to update the filters */
+    dma_enable_half_transfer_interrupt(ADC_DMA.dma, ADC_DMA.stream);
+    dma_enable_transfer_complete_interrupt(ADC_DMA.dma, ADC_DMA.stream);
+    nvic_set_priority(get_nvic_dma_irq(ADC_DMA), 65);  // Medium priority, below the mixer
+    nvic_enable_irq(get_nvic_dma_irq(ADC_DMA));
 
     /* dma ready to go. waiting til the peripheral gives the first data */
     DMA_enable_stream(ADC_DMA);
@@ -176,18 +190,24 @@ void ADC_StartCapture()
     ADC_start_conversion(ADC_CFG.adc);
 }
 
+// Called from the ADC DMA interrupt once 'half' of adc_array_oversample is filled
+void ADC_UpdateFilters(unsigned half)
+{
+    const volatile u16 *samples = &adc_array_oversample[half * (SAMPLE_COUNT / 2)];
+    for (int i = 0; i < NUM_ADC_CHANNELS; i++)
+        ADCFILTER_Update(&adc_filter[i], half, samples + i, NUM_ADC_CHANNELS, HALF_SCANS);
+}
+
+void ADC_SetFilter(int channel, enum ADCFilterType type)
+{
+    if (channel > 0 && channel <= NUM_ADC_CHANNELS)
+        ADCFILTER_Init(&adc_filter[channel-1], type);
+}
+
 void ADC_Filter()
 {
-    for (int i = 0; i < NUM_ADC_CHANNELS; i++) {
-        u32 result = 0;
-        int idx = i;
-        for(int j = 0; j < WINDOW_SIZE * ADC_OVERSAMPLE_WINDOW_COUNT; j++) {
-            result += adc_array_oversample[idx];
-            idx += NUM_ADC_CHANNELS;
-        }
-        result /= ADC_OVERSAMPLE_WINDOW_COUNT * WINDOW_SIZE;
-        adc_array_raw[i] = result;
-    }
+    for (int i = 0; i < NUM_ADC_CHANNELS; i++)
+        adc_array_raw[i] = ADCFILTER_Value(&adc_filter[i]);
 }
 
 s32 ADC_ReadRawInput(int channel)
@@ -197,35 +217,18 @@ s32 ADC_ReadRawInput(int channel)
     return 0;
 }
 
-s32 ADC_NormalizeChannel(int channel)
+void ADC_UpdateCalibration()
 {
-    s32 value = ADC_ReadRawInput(channel);
-    s32 max = Transmitter.calibration[channel - 1].max;
-    s32 min = Transmitter.calibration[channel - 1].min;
-    s32 zero = Transmitter.calibration[channel - 1].zero;
-    if (!zero) {
-        // If this input doesn't have a zero, calculate from max/min
-        zero = ((u32)max + min) / 2;
-    }
-    // Derate min and max by 1% to ensure we can get all the way to 100%
-    max = (max - zero) * 99 / 100;
-    min = (min - zero) * 99 / 100;
-    if (value >= zero) {
-        value = (value - zero) * CHAN_MAX_VALUE / max;
-    } else {
-        value = (value - zero) * CHAN_MIN_VALUE / min;
-    }
-    // Bound output
-    if (value > CHAN_MAX_VALUE)
-        value = CHAN_MAX_VALUE;
-    if (value < CHAN_MIN_VALUE)
-        value = CHAN_MIN_VALUE;
-
     #define ADC_CHAN(x, y, z) (z)
     const s8 chan_inverted[NUM_ADC_CHANNELS] = ADC_CHANNELS;
     #undef ADC_CHAN
-    value = value * chan_inverted[channel - 1];
-    return value;
+    for (int i = 0; i < INP_HAS_CALIBRATION; i++)
+        CALIB_Build(&adc_calib[i], &Transmitter.calibration[i], chan_inverted[i]);
+}
+
+s32 ADC_NormalizeChannel(int channel)
+{
+    return CALIB_Apply(&adc_calib[channel - 1], ADC_ReadRawInput(channel));
 }
 
 void ADC_ScanChannels()
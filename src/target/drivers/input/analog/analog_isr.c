@@ -0,0 +1,30 @@
+/*
+    This project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Deviation is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "common.h"
+#include "target/drivers/mcu/stm32/dma.h"
+
+void ADC_UpdateFilters(unsigned half);
+
+void __attribute__((__used__)) _ADC_DMA_ISR(void)
+{
+    if (dma_get_interrupt_flag(ADC_DMA.dma, ADC_DMA.stream, DMA_HTIF)) {
+        dma_clear_interrupt_flags(ADC_DMA.dma, ADC_DMA.stream, DMA_HTIF);
+        ADC_UpdateFilters(0);
+    }
+    if (dma_get_interrupt_flag(ADC_DMA.dma, ADC_DMA.stream, DMA_TCIF)) {
+        dma_clear_interrupt_flags(ADC_DMA.dma, ADC_DMA.stream, DMA_TCIF);
+        ADC_UpdateFilters(1);
+    }
+}
@@ -37,6 +37,8 @@
 s32 ADC_ReadRawInput(int channel)
 {
     s32 step = (CHAN_MAX_VALUE - CHAN_MIN_VALUE) / 10;
+    if (gui.scripted & (1 << channel))
+        return gui.analog[channel];
     switch (channel) {
         case 0:            return 0;
         case INP_THROTTLE: return CHAN_MIN_VALUE + step * gui.throttle;
@@ -74,6 +76,24 @@ s32 SWITCH_ReadRawInput(int channel)
     return 0;
 }
 
+// Moves the switch so that 'input' is the active position
+int EMU_SetSwitch(int input)
+{
+    #undef TWO_WAY
+    #undef THREE_WAY
+    #define TWO_WAY(inp, p1, dir) \
+        case inp ## 0:  KEY_ ## inp = 0; return 1; \
+        case inp ## 1:  KEY_ ## inp = 1; return 1;
+    #define THREE_WAY(inp, p1, p2, dir) \
+        case inp ## 0:  KEY_ ## inp = 0; return 1; \
+        case inp ## 1:  KEY_ ## inp = 1; return 1; \
+        case inp ## 2:  KEY_ ## inp = 2; return 1;
+    switch (input) {
+        SWITCHES
+    }
+    return 0;
+}
+
 void CHAN_SetSwitchCfg(const char *str)
 {
     (void)str;
@@ -13,10 +13,15 @@
  along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
 #include "common.h"
 #include "rtc.h"
+#include "fltk.h"
 #include <time.h>
 
+//UTC at 2012-01-01 00:00:00
+#define DEVO_EPOCH 1325376000L
+
 //Time since 01.01.2012, 0:00:00
 long delta;
 #if 0
@@ -33,27 +38,140 @@ long get_gmtoff(time_t tt) {
     return tz;
 }
 #endif
+static time_t now_sec()
+{
+    if (EMUCLOCK_Enabled())
+        return DEVO_EPOCH + EMUCLOCK_GetMs() / 1000;
+    return time(NULL);
+}
+
 // initialize RTC
 void RTC_Init()
 {
-   //UTC at 2012-01-01 00:00:00
-   #define DEVO_EPOCH 1325376000L
    delta = DEVO_EPOCH;
 }
 
 // set date value (deviation epoch = seconds since 1.1.2012, 00:00:00)
 void RTC_SetValue(u32 value)
 {
-    delta = time(NULL) - value;
+    delta = now_sec() - value;
     //_RTC_SetDayStart(value);
 }
 
 // get date value (deviation epoch = seconds since 1.1.2012, 00:00:00)
 u32 RTC_GetValue()
 {
-    return time(NULL) - delta;
+    return now_sec() - delta;
 }
 
 void CLOCK_RunOnce(void (*cb)(void)) {
     cb();
 }
+
+/* Virtual time.  When EMU_SCRIPT names an input script, the emulator runs
+ * headless and time only moves when the firmware waits: PWR_Sleep() jumps
+ * straight to the next due event and runs it, and usleep() just adds to the
+ * clock.  A run is deterministic and goes as fast as the host allows */
+#define SPIN_LIMIT 1000  // Clock reads without sleeping that count as a busy-wait
+#define SPIN_US    10    // Time spent per busy-wait inside an event
+
+static struct {
+    u64 due;
+    void (*cb)(void);
+} events[EMUCLOCK_EVENTS];
+static u32 pending;  // Bitmask of scheduled events
+static u8 enabled;
+static u8 running;   // Set while an event callback runs
+static u64 now_us;
+static unsigned spins;
+
+int EMUCLOCK_Init()
+{
+    const char *file = getenv("EMU_SCRIPT");
+    if (! file)
+        return 0;
+    enabled = 1;
+    if (! EMUSCRIPT_Init(file)) {
+        printf("Couldn't open %s\n", file);
+        exit(1);
+    }
+    return 1;
+}
+
+int EMUCLOCK_Enabled()
+{
+    return enabled;
+}
+
+void EMUCLOCK_Start(int event, u32 us, void (*cb)(void))
+{
+    events[event].due = now_us + us;
+    events[event].cb = cb;
+    pending |= 1 << event;
+}
+
+// Reschedules the event relative to its last due time, so periodic events
+// don't drift.  Does nothing if the callback already restarted the event
+void EMUCLOCK_Repeat(int event, u32 us)
+{
+    if (pending & (1 << event))
+        return;
+    events[event].due += us;
+    pending |= 1 << event;
+}
+
+void EMUCLOCK_Stop(int event)
+{
+    pending &= ~(1 << event);
+}
+
+static void run_next()
+{
+    int next = -1;
+    for (int i = 0; i < EMUCLOCK_EVENTS; i++) {
+        if ((pending & (1 << i)) && (next < 0 || events[i].due < events[next].due))
+            next = i;
+    }
+    if (next < 0)
+        return;
+    if (events[next].due > now_us)
+        now_us = events[next].due;
+    pending &= ~(1 << next);
+    running++;
+    events[next].cb();
+    running--;
+}
+
+void EMUCLOCK_Sleep()
+{
+    spins = 0;
+    run_next();
+}
+
+void EMUCLOCK_Delay(u32 us)
+{
+    now_us += us;
+}
+
+static void spin()
+{
+    if (++spins < SPIN_LIMIT)
+        return;
+    spins = 0;
+    if (running)
+        now_us += SPIN_US;
+    else
+        run_next();
+}
+
+u32 EMUCLOCK_GetMs()
+{
+    spin();
+    return now_us / 1000;
+}
+
+u16 EMUCLOCK_GetUs()
+{
+    spin();
+    return now_us;
+}
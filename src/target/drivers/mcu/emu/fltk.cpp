@@ -47,6 +47,7 @@ extern "C" {
 #include "common.h"
 #include "fltk.h"
 #include "mixer.h"
+#include "profile.h"
 #include "config/tx.h"
 #include "buttonmap.h"
 }
@@ -369,6 +370,15 @@ extern void _lcd_init();
 void LCD_Init()
 {
   int i;
+  if (EMUCLOCK_Enabled()) {
+      //Headless: draw into gui.image only
+      memset(&gui, 0, sizeof(gui));
+      gui.init = 1;
+#ifdef HAS_LCD_INIT
+      _lcd_init();
+#endif
+      return;
+  }
   Fl::visual(FL_RGB);
   // 85 is for 4 rows' height
   int lcdScreenWidth = SCREEN_X;
@@ -452,8 +462,10 @@ void LCD_DrawStart(unsigned int x0, unsigned int y0, unsigned int x1, unsigned i
         gui.dir = -1;
     }
 #ifndef HAS_EVENT_LOOP
-    Fl::check();
-    Fl::flush();
+    if (! EMUCLOCK_Enabled()) {
+        Fl::check();
+        Fl::flush();
+    }
 #endif
 }
 
@@ -483,7 +495,8 @@ u32 ScanButtons()
 
 int PWR_CheckPowerSwitch()
 {
-    Fl::check();
+    if (! EMUCLOCK_Enabled())
+        Fl::check();
     return gui.powerdown;
 }
 
@@ -524,6 +537,7 @@ void ALARMhandler()
             CLOCK_getms() >= msec_cbtime[TIMER_ENABLE])
             //msecs == msec_cbtime[TIMER_ENABLE])
     {
+        PROFILE_BEGIN(PROFILE_PROTOCOL);
 #ifdef TIMING_DEBUG
         debug_timing(4, 0);
 #endif
@@ -531,6 +545,7 @@ void ALARMhandler()
 #ifdef TIMING_DEBUG
         debug_timing(4, 1);
 #endif
+        PROFILE_END(PROFILE_PROTOCOL);
         if (us > 0) {
             msec_cbtime[TIMER_ENABLE] += us;
         }
@@ -539,7 +554,9 @@ void ALARMhandler()
             CLOCK_getms() >= msec_cbtime[MEDIUM_PRIORITY])
             // msecs == msec_cbtime[MEDIUM_PRIORITY])
     {
+        PROFILE_BEGIN(PROFILE_MIXER);
         MIXER_CalcChannels();
+        PROFILE_END(PROFILE_MIXER);
         priority_ready |= 1 << MEDIUM_PRIORITY;
         msec_cbtime[MEDIUM_PRIORITY] += MEDIUM_PRIORITY_MSEC;
     }
@@ -552,6 +569,31 @@ void ALARMhandler()
     }
 }
 
+static void virtual_timer()
+{
+    PROFILE_BEGIN(PROFILE_PROTOCOL);
+    u16 us = timer_callback();
+    PROFILE_END(PROFILE_PROTOCOL);
+    if (us > 0)
+        EMUCLOCK_Repeat(TIMER_ENABLE, us);
+}
+
+static void virtual_mixer()
+{
+    PROFILE_BEGIN(PROFILE_MIXER);
+    MIXER_CalcChannels();
+    PROFILE_END(PROFILE_MIXER);
+    EMUSCRIPT_LogChannels();
+    priority_ready |= 1 << MEDIUM_PRIORITY;
+    EMUCLOCK_Repeat(MEDIUM_PRIORITY, MEDIUM_PRIORITY_MSEC * 1000);
+}
+
+static void virtual_low_priority()
+{
+    priority_ready |= 1 << LOW_PRIORITY;
+    EMUCLOCK_Repeat(LOW_PRIORITY, LOW_PRIORITY_MSEC * 1000);
+}
+
 #ifndef WIN32
 void _ALARMhandler(int sig) {
     (void)sig;
@@ -561,11 +603,11 @@ void _ALARMhandler(int sig) {
 void CLOCK_Init()
 {
     singlethread = getenv("SINGLETHREAD") != NULL;
+    timer_callback = NULL;
 
-    if (singlethread)
+    if (singlethread || EMUCLOCK_Init())
         return;
 
-    timer_callback = NULL;
     signal(SIGALRM, _ALARMhandler);
 #if 1  //Mac OSX doesn't support posix timers, but does support itimers
     struct itimerval in;
@@ -613,8 +655,10 @@ void CALLBACK TimerProc(void* lpParametar, BOOLEAN TimerOrWaitFired)
 
 void CLOCK_Init()
 {
-    mainThread = OpenThread(THREAD_ALL_ACCESS, FALSE, GetCurrentThreadId());
     timer_callback = NULL;
+    if (EMUCLOCK_Init())
+        return;
+    mainThread = OpenThread(THREAD_ALL_ACCESS, FALSE, GetCurrentThreadId());
     HANDLE m_timerHandle;
     BOOL success = CreateTimerQueueTimer(&m_timerHandle, NULL, TimerProc,
                                          NULL, 100, 1, WT_EXECUTEINTIMERTHREAD);
@@ -627,6 +671,10 @@ void CLOCK_Init()
 void CLOCK_StartTimer(unsigned us, u16 (*cb)(void))
 {
     timer_callback = cb;
+    if (EMUCLOCK_Enabled()) {
+        EMUCLOCK_Start(TIMER_ENABLE, us, virtual_timer);
+        return;
+    }
     msec_cbtime[TIMER_ENABLE] = CLOCK_getms() + us;
             // msecs + us;
     timer_enable |= 1 << TIMER_ENABLE;
@@ -634,24 +682,34 @@ void CLOCK_StartTimer(unsigned us, u16 (*cb)(void))
 
 void CLOCK_StopTimer()
 {
+    EMUCLOCK_Stop(TIMER_ENABLE);
     timer_enable &= ~(1 << TIMER_ENABLE);
 }
 void CLOCK_SetMsecCallback(int cb, u32 msec)
 {
+    if (EMUCLOCK_Enabled()) {
+        EMUCLOCK_Start(cb, msec * 1000, cb == MEDIUM_PRIORITY ? virtual_mixer : virtual_low_priority);
+        return;
+    }
     msec_cbtime[cb] = CLOCK_getms() + msec;
             //msecs + msec;
     timer_enable |= 1 << cb;
 }
 void CLOCK_ClearMsecCallback(int cb)
 {
+    EMUCLOCK_Stop(cb);
     timer_enable &= ~(1 << cb);
 }
 void CLOCK_RunMixer() {}
+void CLOCK_ScheduleMixer(u16 us) { (void)us; }
+u16 CLOCK_MixerRuntime() { return 1; }  // Mixer runs from ALARMhandler. Must not be 0 as it is used as a timer delay
 void CLOCK_StartMixer() {}
 volatile mixsync_t mixer_sync;
 
 u32 CLOCK_getms()
 {
+    if (EMUCLOCK_Enabled())
+        return EMUCLOCK_GetMs();
     struct timeval tp;
     u32 t;
     gettimeofday(&tp, NULL);
@@ -659,13 +717,26 @@ u32 CLOCK_getms()
     return t;
 }
 
+u16 CLOCK_getus()
+{
+    if (EMUCLOCK_Enabled())
+        return EMUCLOCK_GetUs();
+    struct timeval tp;
+    gettimeofday(&tp, NULL);
+    return tp.tv_sec * 1000000 + tp.tv_usec;
+}
+
 void PWR_Sleep() {
+    if (EMUCLOCK_Enabled()) {
+        EMUCLOCK_Sleep();
+        return;
+    }
     Fl::wait(0.1);
     if (singlethread)
         ALARMhandler();
 }
 void LCD_ForceUpdate() {
-    if (changed) {
+    if (changed && ! EMUCLOCK_Enabled()) {
         changed = false;
         image->redraw();
         Fl::check();
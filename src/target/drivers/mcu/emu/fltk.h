@@ -55,6 +55,8 @@ struct Gui {
 
     u8  powerdown;
     u8  mouse;
+    u32 scripted;  // analog inputs set by the script
+    s32 analog[INP_HAS_CALIBRATION + 1];
     u16 mousex, mousey;
     Fl_Output *raw[INP_LAST-1];
     Fl_Output *final[12];
@@ -68,5 +70,27 @@ struct Gui {
 
 extern struct Gui gui;
 void set_stick_positions();
+int EMU_SetSwitch(int input);
+
+/* Virtual time (clock.c).  The events are the msec callbacks followed by
+ * the ones below */
+enum {
+    EMUCLOCK_SOUND = NUM_MSEC_CALLBACKS,
+    EMUCLOCK_SCRIPT,
+    EMUCLOCK_EVENTS,
+};
+int  EMUCLOCK_Init();
+int  EMUCLOCK_Enabled();
+void EMUCLOCK_Start(int event, u32 us, void (*cb)(void));
+void EMUCLOCK_Repeat(int event, u32 us);
+void EMUCLOCK_Stop(int event);
+void EMUCLOCK_Sleep();
+void EMUCLOCK_Delay(u32 us);
+u32  EMUCLOCK_GetMs();
+u16  EMUCLOCK_GetUs();
+
+/* Scripted input and channel trace (script.c) */
+int  EMUSCRIPT_Init(const char *filename);
+void EMUSCRIPT_LogChannels();
 
 #endif
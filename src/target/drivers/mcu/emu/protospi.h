@@ -3,10 +3,17 @@
 
 u8 PROTOSPI_read3wire();
 u8 PROTOSPI_xfer(u8 byte);
-#define PROTOSPI_pin_set(io) if (0) {}
-#define PROTOSPI_pin_clear(io) if (0) {}
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void));
+#define PROTOSPI_wait() if (0) {}
+void EMURF_SetPin(struct mcu_pin pin, int value);
+#define PROTOSPI_pin_set(io) EMURF_SetPin(io, 1)
+#define PROTOSPI_pin_clear(io) EMURF_SetPin(io, 0)
 #define _NOP() if(0) {}
 
+//The AVR programming pins don't exist in the emulator
+#undef AVR_RESET_PIN
+#define AVR_RESET_PIN ((struct mcu_pin){0, 0})
+
 #pragma weak A7105_Reset
 #pragma weak CC2500_Reset
 #pragma weak CYRF_Reset
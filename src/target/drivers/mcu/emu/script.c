@@ -0,0 +1,152 @@
+/*
+    This project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Deviation is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "common.h"
+#include "mixer.h"
+#include "config/model.h"
+#include "fltk.h"
+
+/* Input script for the virtual time mode.  Each line is a time in msec
+ * followed by a command:
+ *   <time> <stick or aux> <percent>   e.g. '1500 THR -100'
+ *   <time> <switch position>          e.g. '2000 GEAR1'
+ *   <time> button <name> <0|1>        e.g. '2500 button ENTER 1'
+ *   <time> power                      press the power switch
+ *   <time> quit                       exit without saving
+ * Times are absolute and must not decrease.  Lines starting with '#' are
+ * comments.  If EMU_CHANNEL_LOG is set, the channel outputs are written to
+ * it every time they change */
+static FILE *script_fh;
+static FILE *channel_fh;
+static char line[128];
+static u32 line_time;
+static int line_num;
+static s32 last_channels[NUM_OUT_CHANNELS];
+
+static int find_input(const char *name, int first, int last)
+{
+    char str[20];
+    for (int i = first; i <= last; i++) {
+        if (strcasecmp(INPUT_SourceNameReal(str, i), name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int find_button(const char *name)
+{
+    for (int i = 1; i <= NUM_TX_BUTTONS; i++) {
+        if (strcasecmp(INPUT_ButtonName(i), name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void run_command(char *cmd)
+{
+    char *arg = strtok(NULL, " \t\r\n");
+    char *arg2 = strtok(NULL, " \t\r\n");
+    int idx;
+    if (strcasecmp(cmd, "quit") == 0) {
+        if (channel_fh)
+            fclose(channel_fh);
+        exit(0);
+    } else if (strcasecmp(cmd, "power") == 0) {
+        gui.powerdown = 1;
+    } else if (strcasecmp(cmd, "button") == 0) {
+        if (arg && arg2 && (idx = find_button(arg)) > 0) {
+            if (atoi(arg2))
+                gui.buttons |= CHAN_ButtonMask(idx);
+            else
+                gui.buttons &= ~CHAN_ButtonMask(idx);
+            return;
+        }
+        printf("Script line %d: Unknown button\n", line_num);
+    } else if ((idx = find_input(cmd, 1, INP_HAS_CALIBRATION)) > 0) {
+        if (! arg) {
+            printf("Script line %d: Missing value for %s\n", line_num, cmd);
+            return;
+        }
+        s32 pct = atoi(arg);
+        gui.analog[idx] = CHAN_MIN_VALUE + (CHAN_MAX_VALUE - CHAN_MIN_VALUE) * (pct + 100) / 200;
+        gui.scripted |= 1 << idx;
+    } else if ((idx = find_input(cmd, INP_HAS_CALIBRATION + 1, NUM_TX_INPUTS)) > 0) {
+        if (! EMU_SetSwitch(idx))
+            printf("Script line %d: %s is not a switch\n", line_num, cmd);
+    } else {
+        printf("Script line %d: Unknown command '%s'\n", line_num, cmd);
+    }
+}
+
+// Reads the next command line into line_time and line.  Returns 0 at the end
+static int read_line()
+{
+    while (fgets(line, sizeof(line), script_fh)) {
+        line_num++;
+        char *ptr = line;
+        while (*ptr == ' ' || *ptr == '\t')
+            ptr++;
+        if (*ptr == '#' || *ptr == '\r' || *ptr == '\n' || *ptr == '\0')
+            continue;
+        line_time = strtoul(ptr, NULL, 10);
+        return 1;
+    }
+    return 0;
+}
+
+static void run_script()
+{
+    u32 now = EMUCLOCK_GetMs();
+    do {
+        strtok(line, " \t\r\n");  // Time
+        char *cmd = strtok(NULL, " \t\r\n");
+        if (cmd)
+            run_command(cmd);
+        if (! read_line())
+            return;
+    } while (line_time <= now);
+    EMUCLOCK_Start(EMUCLOCK_SCRIPT, (line_time - now) * 1000, run_script);
+}
+
+int EMUSCRIPT_Init(const char *filename)
+{
+    script_fh = fopen(filename, "r");
+    if (! script_fh)
+        return 0;
+    const char *file = getenv("EMU_CHANNEL_LOG");
+    if (file) {
+        channel_fh = fopen(file, "w");
+        if (! channel_fh)
+            printf("Couldn't open %s\n", file);
+    }
+    if (read_line())
+        EMUCLOCK_Start(EMUCLOCK_SCRIPT, line_time * 1000, run_script);
+    return 1;
+}
+
+void EMUSCRIPT_LogChannels()
+{
+    int num_channels = Model.num_channels;
+    if (! channel_fh)
+        return;
+    if (memcmp(last_channels, (const s32 *)Channels, num_channels * sizeof(s32)) == 0)
+        return;
+    memcpy(last_channels, (const s32 *)Channels, num_channels * sizeof(s32));
+    fprintf(channel_fh, "%u", (unsigned)EMUCLOCK_GetMs());
+    for (int i = 0; i < num_channels; i++)
+        fprintf(channel_fh, " %d", (int)Channels[i]);
+    fprintf(channel_fh, "\n");
+}
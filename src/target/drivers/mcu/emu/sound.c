@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <math.h>
 #include "common.h"
+#include "fltk.h"
 
 #define SAMPLE_RATE   (44100)
 #define FRAMES_PER_BUFFER  (64)
@@ -35,21 +36,42 @@
 #endif
 
 #define TABLE_SIZE   (250)
+
+/* In virtual time the notes are timed by the virtual clock instead of the
+ * sound card, so music sequences take the same time on every run */
+static u16 (*virtual_next_note)();
+
+static void virtual_note_done()
+{
+    u16 msec = virtual_next_note ? virtual_next_note() : 0;
+    if (msec)
+        EMUCLOCK_Repeat(EMUCLOCK_SOUND, msec * 1000);
+}
+
+static int virtual_sound(unsigned msec, u16(*next_note_cb)())
+{
+    if (! EMUCLOCK_Enabled())
+        return 0;
+    virtual_next_note = next_note_cb;
+    EMUCLOCK_Start(EMUCLOCK_SOUND, msec * 1000, virtual_note_done);
+    return 1;
+}
+
 #ifdef NO_SOUND
 void SOUND_SetFrequency(unsigned freq, unsigned volume) {(void)freq; (void)volume;}
 void SOUND_Init() {}
 void SOUND_Start(unsigned msec, u16(*next_note_cb)(), u8 vibrate) {
-    (void)msec;
-    (void)next_note_cb;
     (void)vibrate;
+    if (virtual_sound(msec, next_note_cb))
+        return;
     printf("beep\n");
 }
 void SOUND_StartWithoutVibrating(unsigned msec, u16(*next_note_cb)()) {
-    (void)msec;
-    (void)next_note_cb;
-    printf("beep\n");
+    SOUND_Start(msec, next_note_cb, 0);
+}
+void SOUND_Stop() {
+    EMUCLOCK_Stop(EMUCLOCK_SOUND);
 }
-void SOUND_Stop() {}
 #else
 
 #include "portaudio.h"
@@ -124,6 +146,8 @@ void SOUND_Init()
 {
     PaError err;
     memset(&paData, 0, sizeof(paData));
+    if (EMUCLOCK_Enabled())
+        return;
     err = Pa_Initialize();
     if( err != paNoError ) {
         printf("Sound initialization failed.  Disabling sound\n");
@@ -152,6 +176,8 @@ void SOUND_StartWithoutVibrating(unsigned msec, u16(*next_note_cb)())
 void SOUND_Start(unsigned msec, u16(*next_note_cb)(), u8 vibrate) {
     (void)vibrate;
     PaError err;
+    if (virtual_sound(msec, next_note_cb))
+        return;
     if (! paData.enable)
         return;
     SOUND_Stop();
@@ -182,6 +208,9 @@ void SOUND_Start(unsigned msec, u16(*next_note_cb)(), u8 vibrate) {
 
 void SOUND_Stop()
 {
+    EMUCLOCK_Stop(EMUCLOCK_SOUND);
+    if (! paData.enable)
+        return;
     Pa_StopStream( paData.stream );
 }
 #endif
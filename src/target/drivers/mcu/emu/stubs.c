@@ -25,7 +25,10 @@
 
 #undef usleep
 void _usleep(u32 usec) {
-    usleep(usec);
+    if (EMUCLOCK_Enabled())
+        EMUCLOCK_Delay(usec);
+    else
+        usleep(usec);
 }
 void TxName(u8 *var, int len) {
     const u8 model[] = EMU_STRING;
@@ -50,6 +53,7 @@ void Initialize_ButtonMatrix() {}
 void PWR_Init(void) {}
 unsigned  PWR_ReadVoltage() { return (DEFAULT_BATTERY_ALARM + 1000); }
 void ADC_Init() {}
+void ADC_UpdateCalibration() {}
 void SWITCH_Init() {}
 
 void CLOCK_StartWatchdog() {}
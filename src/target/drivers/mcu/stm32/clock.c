@@ -115,6 +115,13 @@ void CLOCK_Init()
     /* Disable CCP1 interrupt. */
     timer_disable_irq(SYSCLK_TIM.tim, TIM_DIER_CC1IE);
 
+    /* CCP2 triggers mixer runs scheduled by CLOCK_ScheduleMixer */
+    timer_disable_oc_clear(SYSCLK_TIM.tim, TIM_OC2);
+    timer_disable_oc_preload(SYSCLK_TIM.tim, TIM_OC2);
+    timer_set_oc_slow_mode(SYSCLK_TIM.tim, TIM_OC2);
+    timer_set_oc_mode(SYSCLK_TIM.tim, TIM_OC2, TIM_OCM_FROZEN);
+    timer_disable_irq(SYSCLK_TIM.tim, TIM_DIER_CC2IE);
+
     timer_enable_counter(SYSCLK_TIM.tim);
 
     /* Enable EXTI1 interrupt for medium priority callback. */
@@ -174,7 +181,7 @@ void CLOCK_ResetWatchdog()
     wdg_time = msecs;
 }
 void CLOCK_StopTimer() {
-    timer_disable_irq(SYSCLK_TIM.tim, TIM_DIER_CC1IE);
+    timer_disable_irq(SYSCLK_TIM.tim, TIM_DIER_CC1IE | TIM_DIER_CC2IE);
     timer_callback = NULL;
 }
 
@@ -184,6 +191,11 @@ u32 CLOCK_getms()
     return msecs;
 }
 
+u16 CLOCK_getus()
+{
+    return timer_get_counter(SYSCLK_TIM.tim);
+}
+
 void CLOCK_SetMsecCallback(int cb, u32 msec)
 {
     msec_cbtime[cb] = msecs + msec;
@@ -197,11 +209,54 @@ void CLOCK_ClearMsecCallback(int cb)
 
 // Run Mixer one time.  Used by protocols that trigger mixer calc in protocol code
 volatile mixsync_t mixer_sync;
+volatile u16 mixer_start;
 void CLOCK_RunMixer(void) {
+    mixer_start = timer_get_counter(SYSCLK_TIM.tim);
     mixer_sync = MIX_NOT_DONE;
     nvic_set_pending_irq(NVIC_EXTI1_IRQ);
 }
 
+// Run Mixer so that channels are ready 'us' microseconds from now.  The start time is
+// derived from the measured mixer run-time, so there is no need for a separate protocol
+// state to start the mixer.
+void CLOCK_ScheduleMixer(u16 us)
+{
+    u16 runtime = CLOCK_MixerRuntime();
+    if (us <= runtime) {
+        CLOCK_RunMixer();
+        return;
+    }
+    mixer_sync = MIX_NOT_DONE;
+    timer_set_oc_value(SYSCLK_TIM.tim, TIM_OC2, timer_get_counter(SYSCLK_TIM.tim) + us - runtime);
+    timer_clear_flag(SYSCLK_TIM.tim, TIM_SR_CC2IF);
+    timer_enable_irq(SYSCLK_TIM.tim, TIM_DIER_CC2IE);
+}
+
+/* The mixer run-time is measured from the time the run is requested until the channels
+ * are done, so it includes the latency of the medium priority interrupt.  The estimate
+ * is the worst case seen, which slowly decays towards the average once the mixer gets
+ * faster (i.e. after a model change).  It starts from a conservative guess so the
+ * first scheduled runs are not started too late */
+#define MIXER_RUNTIME_MARGIN 20  // us
+#define MIXER_RUNTIME_MAX  2000  // us
+#define MIXER_RUNTIME_INIT 1000  // us, assumed until the first runs are measured
+static u16 mixer_avg = MIXER_RUNTIME_INIT;    // 1/8 weighted moving average
+static u16 mixer_worst = MIXER_RUNTIME_INIT;
+void CLOCK_MixerDone(u16 us)
+{
+    mixer_avg = mixer_avg + ((s32)us - mixer_avg) / 8;
+    if (us >= mixer_worst)
+        mixer_worst = us;
+    else
+        mixer_worst -= (mixer_worst - mixer_avg + 31) / 32;
+}
+
+u16 CLOCK_MixerRuntime()
+{
+    u16 runtime = mixer_worst + MIXER_RUNTIME_MARGIN;
+    return runtime < MIXER_RUNTIME_MAX ? runtime : MIXER_RUNTIME_MAX;
+}
+
 // Run Mixer on medium priority interval.  Default behavior - no protocol code required.
 void CLOCK_StartMixer() {
     mixer_sync = MIX_TIMER;
@@ -19,6 +19,7 @@
 #include "common.h"
 #include "target/tx/devo/common/devo.h"
 #include "target/drivers/mcu/stm32/tim.h"
+#include "profile.h"
 
 extern volatile u32 msecs;
 extern volatile u32 wdg_time;
@@ -26,10 +27,21 @@ extern volatile u32 wdg_time;
 extern u16 (*timer_callback)(void);
 extern volatile u8 msec_callbacks;
 extern volatile u32 msec_cbtime[NUM_MSEC_CALLBACKS];
+extern volatile u16 mixer_start;
+void CLOCK_MixerDone(u16 us);
 
 void __attribute__((__used__)) SYSCLK_TIMER_ISR()
 {
+    if ((TIM_DIER(SYSCLK_TIM.tim) & TIM_DIER_CC2IE) && timer_get_flag(SYSCLK_TIM.tim, TIM_SR_CC2IF)) {
+        //Mixer run scheduled by CLOCK_ScheduleMixer
+        timer_clear_flag(SYSCLK_TIM.tim, TIM_SR_CC2IF);
+        timer_disable_irq(SYSCLK_TIM.tim, TIM_DIER_CC2IE);
+        CLOCK_RunMixer();
+        if (! timer_get_flag(SYSCLK_TIM.tim, TIM_SR_CC1IF))
+            return;
+    }
     if(timer_callback) {
+        PROFILE_BEGIN(PROFILE_PROTOCOL);
 #ifdef TIMING_DEBUG
         debug_timing(4, 0);
 #endif
@@ -37,6 +49,7 @@ void __attribute__((__used__)) SYSCLK_TIMER_ISR()
 #ifdef TIMING_DEBUG
         debug_timing(4, 1);
 #endif
+        PROFILE_END(PROFILE_PROTOCOL);
         timer_clear_flag(SYSCLK_TIM.tim, TIM_SR_CC1IF);
         if (us) {
             timer_set_oc_value(SYSCLK_TIM.tim, TIM_OCx(SYSCLK_TIM.ch), us + TIM_CCR1(SYSCLK_TIM.tim));
@@ -50,9 +63,14 @@ void __attribute__((__used__)) exti1_isr()
 {
     // medium_priority_cb();  Currently not used. If needed,
     // use exti3 for mixer updates.
+    PROFILE_BEGIN(PROFILE_MIXER);
     ADC_Filter();
     MIXER_CalcChannels();
-    if (mixer_sync == MIX_NOT_DONE) mixer_sync = MIX_DONE;
+    PROFILE_END(PROFILE_MIXER);
+    if (mixer_sync == MIX_NOT_DONE) {
+        mixer_sync = MIX_DONE;
+        CLOCK_MixerDone(timer_get_counter(SYSCLK_TIM.tim) - mixer_start);
+    }
 }
 
 extern void (*func_callback)(void);
@@ -70,6 +88,7 @@ void __attribute__((__used__)) sys_tick_handler(void)
         nvic_set_pending_irq(NVIC_EXTI2_IRQ);
         return;
     }
+    PROFILE_BEGIN(PROFILE_SYSTICK);
     if(msec_callbacks & (1 << MEDIUM_PRIORITY)) {
         //medium priority tasks execute in interrupt and main loop context
         if (msecs == msec_cbtime[MEDIUM_PRIORITY]) {
@@ -99,4 +118,5 @@ void __attribute__((__used__)) sys_tick_handler(void)
                 msec_cbtime[TIMER_SOUND] = msecs + ms;
         }
     }
+    PROFILE_END(PROFILE_SYSTICK);
 }
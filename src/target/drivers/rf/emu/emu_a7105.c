@@ -0,0 +1,149 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "protocol/interface.h"
+#include "emu_rf.h"
+
+#ifdef PROTO_HAS_A7105
+/* Bytes with bit 7 set are strobes, and the following byte starts a new
+ * command.  Otherwise bit 6 selects a read and the following bytes all go to
+ * the same register.  Register 0x00 reads back TRER (bit 0) while a packet
+ * is being received */
+#define MODE_TRER 0x01
+
+static struct {
+    u8 regs[0x33];
+    u8 id[4];
+    u8 tx_fifo[EMURF_MAX_PACKET];
+    u8 rx_fifo[EMURF_MAX_PACKET];
+    u8 tx_len;
+    u8 rx_len;
+    u8 rx_pos;
+    u8 mode;
+    u8 header;
+    u8 pos;
+} a7105;
+
+static void a7105_reset()
+{
+    memset(&a7105, 0, sizeof(a7105));
+    a7105.regs[A7105_03_FIFOI] = 0x3f;
+    a7105.regs[A7105_10_PLL_II] = 0x9e;
+}
+
+static void transmit()
+{
+    struct EmuRFPacket pkt;
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.module = A7105;
+    pkt.channel = a7105.regs[A7105_0F_PLL_I];
+    pkt.len = a7105.regs[A7105_03_FIFOI] + 1;
+    if (pkt.len > a7105.tx_len)
+        pkt.len = a7105.tx_len;
+    memcpy(pkt.data, a7105.tx_fifo, pkt.len);
+    pkt.id_len = sizeof(a7105.id);
+    memcpy(pkt.id, a7105.id, sizeof(a7105.id));
+    EMURF_LogTx(&pkt);
+    a7105.mode = 0;
+}
+
+static void receive()
+{
+    unsigned len = EMURF_Receive(A7105, a7105.rx_fifo, sizeof(a7105.rx_fifo));
+    if (len) {
+        a7105.rx_len = len;
+        a7105.rx_pos = 0;
+        a7105.mode = 0;
+    } else {
+        a7105.mode = MODE_TRER;
+    }
+}
+
+static void strobe(u8 cmd)
+{
+    switch (cmd) {
+        case A7105_TX:        transmit(); break;
+        case A7105_RX:        receive(); break;
+        case A7105_RST_WRPTR: a7105.tx_len = 0; break;
+        case A7105_RST_RDPTR: a7105.rx_pos = 0; break;
+        default:              a7105.mode = 0; break;
+    }
+}
+
+static void write_reg(u8 addr, u8 data, u8 idx)
+{
+    switch (addr) {
+    case A7105_00_MODE:
+        a7105_reset();
+        break;
+    case A7105_02_CALC:
+        //Calibration completes immediately
+        break;
+    case A7105_05_FIFO_DATA:
+        if (a7105.tx_len < sizeof(a7105.tx_fifo))
+            a7105.tx_fifo[a7105.tx_len++] = data;
+        break;
+    case A7105_06_ID_DATA:
+        a7105.id[idx % sizeof(a7105.id)] = data;
+        break;
+    default:
+        if (addr < sizeof(a7105.regs))
+            a7105.regs[addr] = data;
+        break;
+    }
+}
+
+static u8 read_reg(u8 addr, u8 idx)
+{
+    switch (addr) {
+    case A7105_00_MODE:
+        return a7105.mode;
+    case A7105_05_FIFO_DATA:
+        return a7105.rx_pos < a7105.rx_len ? a7105.rx_fifo[a7105.rx_pos++] : 0;
+    case A7105_06_ID_DATA:
+        return a7105.id[idx % sizeof(a7105.id)];
+    default:
+        return addr < sizeof(a7105.regs) ? a7105.regs[addr] : 0;
+    }
+}
+
+static void a7105_select(int active)
+{
+    if (active)
+        a7105.pos = 0;
+}
+
+static u8 a7105_xfer(u8 byte)
+{
+    if (a7105.pos == 0) {
+        if (byte & 0x80) {
+            strobe(byte & 0xf0);
+        } else {
+            a7105.header = byte;
+            a7105.pos = 1;
+        }
+        return 0;
+    }
+    u8 idx = a7105.pos++ - 1;
+    u8 addr = a7105.header & 0x3f;
+    if (a7105.header & 0x40)
+        return read_reg(addr, idx);
+    write_reg(addr, byte, idx);
+    return 0;
+}
+
+const struct EmuRFChip EMURF_A7105 = {a7105_reset, a7105_select, a7105_xfer};
+#endif //PROTO_HAS_A7105
@@ -0,0 +1,175 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "protocol/interface.h"
+#include "emu_rf.h"
+
+#ifdef PROTO_HAS_CC2500
+/* The header byte holds the read and burst bits and the address.  Addresses
+ * 0x30-0x3d are command strobes, or status registers when read in burst mode.
+ * Every header byte returns the chip status byte */
+#define MARCSTATE_IDLE   0x01
+#define MARCSTATE_RX     0x0d
+#define MARCSTATE_FSTXON 0x12
+#define MARCSTATE_TX     0x13
+
+static struct {
+    u8 regs[0x30];
+    u8 patable[8];
+    u8 tx_fifo[EMURF_MAX_PACKET];
+    u8 rx_fifo[EMURF_MAX_PACKET + 2];
+    u8 tx_len;
+    u8 rx_len;
+    u8 rx_pos;
+    u8 state;
+    u8 header;
+    u8 pos;
+} cc;
+
+static void cc_reset()
+{
+    memset(&cc, 0, sizeof(cc));
+    cc.regs[CC2500_04_SYNC1] = 0xd3;
+    cc.regs[CC2500_05_SYNC0] = 0x91;
+    cc.regs[CC2500_06_PKTLEN] = 0xff;
+    cc.regs[CC2500_07_PKTCTRL1] = 0x04;
+    cc.regs[CC2500_08_PKTCTRL0] = 0x45;
+    cc.state = MARCSTATE_IDLE;
+}
+
+static void receive()
+{
+    cc.state = MARCSTATE_RX;
+    if (! EMURF_Pending(CC2500))
+        return;
+    cc.rx_len = EMURF_Receive(CC2500, cc.rx_fifo, EMURF_MAX_PACKET);
+    cc.rx_pos = 0;
+    if (cc.regs[CC2500_07_PKTCTRL1] & 0x04) {
+        //APPEND_STATUS: RSSI, then CRC_OK and LQI
+        cc.rx_fifo[cc.rx_len++] = 0x00;
+        cc.rx_fifo[cc.rx_len++] = 0x80;
+    }
+    cc.state = MARCSTATE_IDLE;
+}
+
+static void transmit()
+{
+    struct EmuRFPacket pkt;
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.module = CC2500;
+    pkt.channel = cc.regs[CC2500_0A_CHANNR];
+    pkt.len = cc.tx_len;
+    memcpy(pkt.data, cc.tx_fifo, cc.tx_len);
+    pkt.id_len = 2;
+    pkt.id[0] = cc.regs[CC2500_04_SYNC1];
+    pkt.id[1] = cc.regs[CC2500_05_SYNC0];
+    EMURF_LogTx(&pkt);
+    cc.tx_len = 0;
+    //MCSM1.TXOFF_MODE
+    switch (cc.regs[CC2500_17_MCSM1] & 0x03) {
+        case 0: cc.state = MARCSTATE_IDLE; break;
+        case 1: cc.state = MARCSTATE_FSTXON; break;
+        case 2: cc.state = MARCSTATE_TX; break;
+        case 3: receive(); break;
+    }
+}
+
+static void strobe(u8 cmd)
+{
+    switch (cmd) {
+        case CC2500_SRES:    cc_reset(); break;
+        case CC2500_SFSTXON: cc.state = MARCSTATE_FSTXON; break;
+        case CC2500_SRX:     receive(); break;
+        case CC2500_STX:     transmit(); break;
+        case CC2500_SFRX:    cc.rx_len = cc.rx_pos = 0; break;
+        case CC2500_SFTX:    cc.tx_len = 0; break;
+        case CC2500_SNOP:    break;
+        default:             cc.state = MARCSTATE_IDLE; break;
+    }
+}
+
+static u8 read_status(u8 addr)
+{
+    switch (addr) {
+        case 0x30: return 0x80;  //PARTNUM
+        case 0x31: return 0x03;  //VERSION
+        case 0x33: return 0x7f;  //LQI
+        case 0x35: return cc.state;
+        case 0x3a: return cc.tx_len;
+        case 0x3b: return cc.rx_len - cc.rx_pos;
+        default:   return 0x00;
+    }
+}
+
+static u8 status_byte(int read)
+{
+    u8 state;
+    switch (cc.state) {
+        case MARCSTATE_RX:     state = CC2500_STATE_RX; break;
+        case MARCSTATE_TX:     state = CC2500_STATE_TX; break;
+        case MARCSTATE_FSTXON: state = CC2500_STATE_FSTXON; break;
+        default:               state = CC2500_STATE_IDLE; break;
+    }
+    unsigned bytes = read ? cc.rx_len - cc.rx_pos : EMURF_MAX_PACKET - cc.tx_len;
+    return state | (bytes > 15 ? 15 : bytes);
+}
+
+static void cc_select(int active)
+{
+    if (active)
+        cc.pos = 0;
+}
+
+static u8 cc_xfer(u8 byte)
+{
+    if (cc.pos++ == 0) {
+        cc.header = byte;
+        u8 addr = byte & 0x3f;
+        if (addr >= 0x30 && addr <= 0x3d && (byte & CC2500_READ_BURST) != CC2500_READ_BURST)
+            strobe(addr);
+        return status_byte(byte & CC2500_READ_SINGLE);
+    }
+    u8 read = cc.header & CC2500_READ_SINGLE;
+    u8 burst = cc.header & CC2500_WRITE_BURST;
+    u8 idx = cc.pos - 2;
+    u8 addr = cc.header & 0x3f;
+    if (addr == CC2500_3F_FIFO) {
+        if (read)
+            return cc.rx_pos < cc.rx_len ? cc.rx_fifo[cc.rx_pos++] : 0;
+        if (cc.tx_len < sizeof(cc.tx_fifo))
+            cc.tx_fifo[cc.tx_len++] = byte;
+        return status_byte(0);
+    }
+    if (addr == CC2500_3E_PATABLE) {
+        if (read)
+            return cc.patable[idx % sizeof(cc.patable)];
+        cc.patable[idx % sizeof(cc.patable)] = byte;
+        return status_byte(0);
+    }
+    if (addr >= 0x30)
+        return read ? read_status(addr) : status_byte(0);
+    if (burst)
+        addr += idx;
+    if (addr >= sizeof(cc.regs))
+        return 0;
+    if (read)
+        return cc.regs[addr];
+    cc.regs[addr] = byte;
+    return status_byte(0);
+}
+
+const struct EmuRFChip EMURF_CC2500 = {cc_reset, cc_select, cc_xfer};
+#endif //PROTO_HAS_CC2500
@@ -0,0 +1,186 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "protocol/interface.h"
+#include "emu_rf.h"
+
+#ifdef PROTO_HAS_CYRF6936
+/* The first byte of a transfer is the address, with bit 7 set for writes and
+ * bit 6 for auto-increment.  Register files (buffers, SOP and data codes,
+ * preamble and mfg id) take all following bytes.  Transmission and reception
+ * complete immediately */
+#define CYRF_WRITE 0x80
+#define CYRF_INC   0x40
+
+static const u8 mfg_id[6] = {0x45, 0x6d, 0x75, 0x52, 0x46, 0x01};
+
+static struct {
+    u8 regs[0x40];
+    u8 sop[8];
+    u8 data_code[16];
+    u8 preamble[3];
+    u8 tx_fifo[EMURF_MAX_PACKET];
+    u8 rx_fifo[EMURF_MAX_PACKET];
+    u8 tx_len;
+    u8 rx_len;
+    u8 rx_pos;
+    u8 addr;
+    u8 write;
+    u8 inc;
+    u8 pos;     // Byte index within the transfer, 0 is the address
+} cyrf;
+
+static void cyrf_reset()
+{
+    memset(&cyrf, 0, sizeof(cyrf));
+    cyrf.regs[CYRF_01_TX_LENGTH] = 0x10;
+    cyrf.regs[CYRF_03_TX_CFG] = 0x05;
+    cyrf.regs[CYRF_06_RX_CFG] = 0x12;
+    cyrf.regs[CYRF_0F_XACT_CFG] = 0x04;
+    cyrf.regs[CYRF_10_FRAMING_CFG] = 0xa5;
+    cyrf.regs[CYRF_14_EOP_CTRL] = 0xa4;
+}
+
+static void transmit()
+{
+    struct EmuRFPacket pkt;
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.module = CYRF6936;
+    pkt.channel = cyrf.regs[CYRF_00_CHANNEL];
+    pkt.len = cyrf.regs[CYRF_01_TX_LENGTH];
+    if (pkt.len > cyrf.tx_len)
+        pkt.len = cyrf.tx_len;
+    memcpy(pkt.data, cyrf.tx_fifo, pkt.len);
+    pkt.id_len = sizeof(cyrf.sop);
+    memcpy(pkt.id, cyrf.sop, sizeof(cyrf.sop));
+    pkt.crc_seed = cyrf.regs[CYRF_15_CRC_SEED_LSB] | (cyrf.regs[CYRF_16_CRC_SEED_MSB] << 8);
+    EMURF_LogTx(&pkt);
+    cyrf.regs[CYRF_04_TX_IRQ_STATUS] |= 0x02;  //TXC
+}
+
+static void receive()
+{
+    cyrf.rx_len = EMURF_Receive(CYRF6936, cyrf.rx_fifo, sizeof(cyrf.rx_fifo));
+    cyrf.rx_pos = 0;
+    if (cyrf.rx_len) {
+        cyrf.regs[CYRF_07_RX_IRQ_STATUS] = 0x02;  //RXC
+        cyrf.regs[CYRF_08_RX_STATUS] = 0x00;
+        cyrf.regs[CYRF_09_RX_COUNT] = cyrf.rx_len;
+        cyrf.regs[CYRF_05_RX_CTRL] &= ~0x80;
+    } else {
+        cyrf.regs[CYRF_07_RX_IRQ_STATUS] = 0x00;
+        cyrf.regs[CYRF_09_RX_COUNT] = 0;
+    }
+}
+
+static void write_reg(u8 addr, u8 data, u8 idx)
+{
+    switch (addr) {
+    case CYRF_02_TX_CTRL:
+        if (data & 0x40)
+            cyrf.tx_len = 0;
+        cyrf.regs[addr] = data & ~0xc0;
+        cyrf.regs[CYRF_04_TX_IRQ_STATUS] = 0x00;
+        if (data & 0x80)
+            transmit();
+        break;
+    case CYRF_05_RX_CTRL:
+        cyrf.regs[addr] = data;
+        if (data & 0x80)
+            receive();
+        break;
+    case CYRF_0F_XACT_CFG:
+        //Forcing the end state completes immediately
+        cyrf.regs[addr] = data & ~0x20;
+        break;
+    case CYRF_04_TX_IRQ_STATUS:
+    case CYRF_07_RX_IRQ_STATUS:
+    case CYRF_08_RX_STATUS:
+    case CYRF_09_RX_COUNT:
+    case CYRF_13_RSSI:
+        break;
+    case CYRF_20_TX_BUFFER:
+        if (cyrf.tx_len < sizeof(cyrf.tx_fifo))
+            cyrf.tx_fifo[cyrf.tx_len++] = data;
+        break;
+    case CYRF_22_SOP_CODE:
+        cyrf.sop[idx % sizeof(cyrf.sop)] = data;
+        break;
+    case CYRF_23_DATA_CODE:
+        cyrf.data_code[idx % sizeof(cyrf.data_code)] = data;
+        break;
+    case CYRF_24_PREAMBLE:
+        cyrf.preamble[idx % sizeof(cyrf.preamble)] = data;
+        break;
+    default:
+        if (addr < sizeof(cyrf.regs))
+            cyrf.regs[addr] = data;
+        break;
+    }
+}
+
+static u8 read_reg(u8 addr, u8 idx)
+{
+    u8 value;
+    switch (addr) {
+    case CYRF_04_TX_IRQ_STATUS:
+    case CYRF_07_RX_IRQ_STATUS:
+        //The completion bits are cleared by reading
+        value = cyrf.regs[addr];
+        cyrf.regs[addr] &= ~0x03;
+        return value;
+    case CYRF_21_RX_BUFFER:
+        return cyrf.rx_pos < cyrf.rx_len ? cyrf.rx_fifo[cyrf.rx_pos++] : 0;
+    case CYRF_22_SOP_CODE:
+        return cyrf.sop[idx % sizeof(cyrf.sop)];
+    case CYRF_23_DATA_CODE:
+        return cyrf.data_code[idx % sizeof(cyrf.data_code)];
+    case CYRF_24_PREAMBLE:
+        return cyrf.preamble[idx % sizeof(cyrf.preamble)];
+    case CYRF_25_MFG_ID:
+        return cyrf.regs[addr] == 0xff ? mfg_id[idx % sizeof(mfg_id)] : 0xff;
+    default:
+        return addr < sizeof(cyrf.regs) ? cyrf.regs[addr] : 0;
+    }
+}
+
+static void cyrf_select(int active)
+{
+    if (active)
+        cyrf.pos = 0;
+}
+
+static u8 cyrf_xfer(u8 byte)
+{
+    if (cyrf.pos++ == 0) {
+        cyrf.write = byte & CYRF_WRITE;
+        cyrf.inc = byte & CYRF_INC;
+        cyrf.addr = byte & 0x3f;
+        return 0;
+    }
+    u8 idx = cyrf.pos - 2;
+    u8 addr = cyrf.inc ? cyrf.addr + idx : cyrf.addr;
+    if (cyrf.inc)
+        idx = 0;
+    if (cyrf.write) {
+        write_reg(addr, byte, idx);
+        return 0;
+    }
+    return read_reg(addr, idx);
+}
+
+const struct EmuRFChip EMURF_CYRF6936 = {cyrf_reset, cyrf_select, cyrf_xfer};
+#endif //PROTO_HAS_CYRF6936
@@ -0,0 +1,171 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "protocol/interface.h"
+#include "emu_rf.h"
+
+#ifdef PROTO_HAS_NRF24L01
+/* Every command returns the STATUS register on its first byte.  CE is
+ * assumed to be high, so a payload is sent as soon as it has been written
+ * in TX mode, and queued packets are received while in RX mode.  Commands
+ * take effect when CSN goes high */
+#define W_REGISTER    0x20
+#define REGISTER_MASK 0x1f
+#define CONFIG_PRIM_RX (1 << NRF24L01_00_PRIM_RX)
+#define CONFIG_PWR_UP  (1 << NRF24L01_00_PWR_UP)
+#define STATUS_RX_DR   (1 << NRF24L01_07_RX_DR)
+#define STATUS_TX_DS   (1 << NRF24L01_07_TX_DS)
+#define STATUS_RX_P_NO 0x0e
+
+static struct {
+    u8 regs[0x20];
+    u8 addr[3][5];  // RX_ADDR_P0, RX_ADDR_P1, TX_ADDR
+    u8 tx_payload[32];
+    u8 rx_payload[32];
+    u8 tx_len;
+    u8 rx_len;
+    u8 rx_pos;
+    u8 cmd;
+    u8 pos;
+} nrf;
+
+static void nrf_reset()
+{
+    memset(&nrf, 0, sizeof(nrf));
+    nrf.regs[NRF24L01_00_CONFIG] = 0x08;
+    nrf.regs[NRF24L01_01_EN_AA] = 0x3f;
+    nrf.regs[NRF24L01_02_EN_RXADDR] = 0x03;
+    nrf.regs[NRF24L01_03_SETUP_AW] = 0x03;
+    nrf.regs[NRF24L01_05_RF_CH] = 0x02;
+    nrf.regs[NRF24L01_07_STATUS] = STATUS_RX_P_NO;
+    memset(nrf.addr, 0xe7, sizeof(nrf.addr));
+}
+
+static u8 *addr_reg(u8 reg)
+{
+    switch (reg) {
+        case NRF24L01_0A_RX_ADDR_P0: return nrf.addr[0];
+        case NRF24L01_0B_RX_ADDR_P1: return nrf.addr[1];
+        case NRF24L01_10_TX_ADDR:    return nrf.addr[2];
+        default: return NULL;
+    }
+}
+
+static u8 fifo_status()
+{
+    return (nrf.tx_len ? 0 : 1 << NRF24L01_17_TX_EMPTY) | (nrf.rx_len ? 0 : 1 << NRF24L01_17_RX_EMPTY);
+}
+
+static void update()
+{
+    u8 config = nrf.regs[NRF24L01_00_CONFIG];
+    if (! (config & CONFIG_PWR_UP))
+        return;
+    if (! (config & CONFIG_PRIM_RX) && nrf.tx_len) {
+        struct EmuRFPacket pkt;
+        memset(&pkt, 0, sizeof(pkt));
+        pkt.module = NRF24L01;
+        pkt.channel = nrf.regs[NRF24L01_05_RF_CH];
+        pkt.len = nrf.tx_len;
+        memcpy(pkt.data, nrf.tx_payload, nrf.tx_len);
+        pkt.id_len = (nrf.regs[NRF24L01_03_SETUP_AW] & 0x03) + 2;
+        memcpy(pkt.id, nrf.addr[2], pkt.id_len);
+        EMURF_LogTx(&pkt);
+        nrf.tx_len = 0;
+        nrf.regs[NRF24L01_07_STATUS] |= STATUS_TX_DS;
+    }
+    if ((config & CONFIG_PRIM_RX) && ! nrf.rx_len && EMURF_Pending(NRF24L01)) {
+        nrf.rx_len = EMURF_Receive(NRF24L01, nrf.rx_payload, sizeof(nrf.rx_payload));
+        nrf.rx_pos = 0;
+        //Pipe 0
+        nrf.regs[NRF24L01_07_STATUS] = (nrf.regs[NRF24L01_07_STATUS] & ~STATUS_RX_P_NO) | STATUS_RX_DR;
+    }
+    if (! nrf.rx_len)
+        nrf.regs[NRF24L01_07_STATUS] |= STATUS_RX_P_NO;
+}
+
+static void write_reg(u8 reg, u8 data, u8 idx)
+{
+    u8 *addr = addr_reg(reg);
+    if (addr) {
+        if (idx < 5)
+            addr[idx] = data;
+    } else if (idx) {
+        //Only the address registers are more than one byte
+    } else if (reg == NRF24L01_07_STATUS) {
+        nrf.regs[reg] &= ~(data & 0x70);
+    } else if (reg != NRF24L01_17_FIFO_STATUS) {
+        nrf.regs[reg] = data;
+    }
+}
+
+static u8 read_reg(u8 reg, u8 idx)
+{
+    u8 *addr = addr_reg(reg);
+    if (addr)
+        return idx < 5 ? addr[idx] : 0;
+    if (reg == NRF24L01_17_FIFO_STATUS)
+        return fifo_status();
+    return nrf.regs[reg];
+}
+
+static void nrf_select(int active)
+{
+    nrf.pos = 0;
+    if (active)
+        return;
+    if (nrf.cmd == NRF24L01_61_RX_PAYLOAD && nrf.rx_pos)
+        nrf.rx_len = 0;
+    update();
+}
+
+static u8 nrf_xfer(u8 byte)
+{
+    if (nrf.pos++ == 0) {
+        nrf.cmd = byte;
+        if (byte == NRF24L01_E1_FLUSH_TX)
+            nrf.tx_len = 0;
+        else if (byte == NRF24L01_E2_FLUSH_RX)
+            nrf.rx_len = 0;
+        else if (byte == NRF24L01_A0_TX_PAYLOAD || byte == NRF24L01_B0_TX_PYLD_NOACK)
+            nrf.tx_len = 0;
+        return nrf.regs[NRF24L01_07_STATUS] | (nrf.tx_len == sizeof(nrf.tx_payload));
+    }
+    u8 idx = nrf.pos - 2;
+    u8 cmd = nrf.cmd;
+    if (cmd < W_REGISTER)
+        return read_reg(cmd & REGISTER_MASK, idx);
+    if (cmd < W_REGISTER + 0x20) {
+        write_reg(cmd & REGISTER_MASK, byte, idx);
+        return 0;
+    }
+    switch (cmd) {
+    case NRF24L01_61_RX_PAYLOAD:
+        return nrf.rx_pos < nrf.rx_len ? nrf.rx_payload[nrf.rx_pos++] : 0;
+    case NRF24L01_60_R_RX_PL_WID:
+        return nrf.rx_len;
+    case NRF24L01_A0_TX_PAYLOAD:
+    case NRF24L01_B0_TX_PYLD_NOACK:
+        if (nrf.tx_len < sizeof(nrf.tx_payload))
+            nrf.tx_payload[nrf.tx_len++] = byte;
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+const struct EmuRFChip EMURF_NRF24L01 = {nrf_reset, nrf_select, nrf_xfer};
+#endif //PROTO_HAS_NRF24L01
@@ -0,0 +1,244 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include "common.h"
+#include "config/tx.h"
+#include "emu_rf.h"
+
+#define RX_QUEUE_SIZE 8
+#define SCRIPT_SIZE   32
+
+struct rx_packet {
+    u8 module;
+    u8 len;
+    u8 data[EMURF_MAX_PACKET];
+};
+
+static const struct EmuRFChip * const chips[TX_MODULE_LAST] = {
+#ifdef PROTO_HAS_CYRF6936
+    [CYRF6936] = &EMURF_CYRF6936,
+#endif
+#ifdef PROTO_HAS_A7105
+    [A7105]    = &EMURF_A7105,
+#endif
+#ifdef PROTO_HAS_CC2500
+    [CC2500]   = &EMURF_CC2500,
+#endif
+#ifdef PROTO_HAS_NRF24L01
+    [NRF24L01] = &EMURF_NRF24L01,
+#endif
+};
+
+static int selected = -1;
+
+static struct EmuRFPacket txlog[EMURF_LOG_SIZE];
+static u32 txlog_count;
+static FILE *txlog_fh;
+
+/* Injected packets are received first.  Once there are none left for a chip,
+ * the packets of the script are received in a loop */
+static struct rx_packet rx_queue[RX_QUEUE_SIZE];
+static u8 rx_queue_len;
+static struct rx_packet script[SCRIPT_SIZE];
+static u8 script_len;
+static u8 script_pos[TX_MODULE_LAST];
+
+static u32 now_us()
+{
+    return CLOCK_getms() * 1000;
+}
+
+void EMURF_Init()
+{
+    for (int i = 0; i < TX_MODULE_LAST; i++) {
+        if (chips[i])
+            chips[i]->reset();
+    }
+    const char *file = getenv("EMU_RF_SCRIPT");
+    if (file)
+        EMURF_LoadScript(file);
+    file = getenv("EMU_RF_LOG");
+    if (file) {
+        txlog_fh = fopen(file, "w");
+        if (! txlog_fh)
+            printf("Couldn't open %s\n", file);
+    }
+}
+
+void EMURF_SetPin(struct mcu_pin pin, int value)
+{
+    for (int i = 0; i < TX_MODULE_LAST; i++) {
+        struct mcu_pin *en = &Transmitter.module_enable[i];
+        if (! chips[i] || ! en->port || en->port != pin.port || en->pin != pin.pin)
+            continue;
+        if (value) {
+            if (selected == i) {
+                chips[i]->select(0);
+                selected = -1;
+            }
+        } else if (selected != i) {
+            if (selected >= 0)
+                chips[selected]->select(0);
+            selected = i;
+            chips[i]->select(1);
+        }
+        return;
+    }
+}
+
+u8 EMURF_Xfer(u8 byte)
+{
+    //Without a selected chip, the bus just loops back
+    if (selected < 0)
+        return byte;
+    return chips[selected]->xfer(byte);
+}
+
+void EMURF_Reset(enum Radio module)
+{
+    if (chips[module])
+        chips[module]->reset();
+}
+
+int EMURF_Inject(enum Radio module, const u8 *data, unsigned len)
+{
+    if (rx_queue_len == RX_QUEUE_SIZE || len > EMURF_MAX_PACKET)
+        return 0;
+    struct rx_packet *pkt = &rx_queue[rx_queue_len++];
+    pkt->module = module;
+    pkt->len = len;
+    memcpy(pkt->data, data, len);
+    return 1;
+}
+
+static int get_module(const char *str)
+{
+    for (int i = 0; i < TX_MODULE_LAST; i++) {
+        if (MODULE_NAME[i] && strcasecmp(str, MODULE_NAME[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/* Each line of the script is a module name followed by the bytes of a packet
+ * in hex, as they are read from the RX FIFO.  Lines starting with '#' are
+ * comments */
+int EMURF_LoadScript(const char *filename)
+{
+    char line[256];
+    FILE *fh = fopen(filename, "r");
+    if (! fh) {
+        printf("Couldn't open %s\n", filename);
+        return 0;
+    }
+    script_len = 0;
+    memset(script_pos, 0, sizeof(script_pos));
+    while (script_len < SCRIPT_SIZE && fgets(line, sizeof(line), fh)) {
+        char *ptr;
+        char *name = strtok(line, " \t\r\n");
+        if (! name || name[0] == '#')
+            continue;
+        int module = get_module(name);
+        if (module < 0) {
+            printf("Unknown module '%s' in %s\n", name, filename);
+            continue;
+        }
+        struct rx_packet *pkt = &script[script_len];
+        pkt->module = module;
+        pkt->len = 0;
+        while (pkt->len < EMURF_MAX_PACKET && (ptr = strtok(NULL, " \t\r\n")))
+            pkt->data[pkt->len++] = strtol(ptr, NULL, 16);
+        if (pkt->len)
+            script_len++;
+    }
+    fclose(fh);
+    return script_len;
+}
+
+static struct rx_packet *next_packet(enum Radio module, int remove)
+{
+    for (int i = 0; i < rx_queue_len; i++) {
+        if (rx_queue[i].module != module)
+            continue;
+        if (remove) {
+            static struct rx_packet pkt;
+            pkt = rx_queue[i];
+            memmove(&rx_queue[i], &rx_queue[i + 1], (rx_queue_len - i - 1) * sizeof(struct rx_packet));
+            rx_queue_len--;
+            return &pkt;
+        }
+        return &rx_queue[i];
+    }
+    for (int i = 0; i < script_len; i++) {
+        struct rx_packet *pkt = &script[(script_pos[module] + i) % script_len];
+        if (pkt->module != module)
+            continue;
+        if (remove)
+            script_pos[module] = (pkt - script + 1) % script_len;
+        return pkt;
+    }
+    return NULL;
+}
+
+int EMURF_Pending(enum Radio module)
+{
+    return next_packet(module, 0) != NULL;
+}
+
+// Copies the next packet for the module to data and returns its length
+unsigned EMURF_Receive(enum Radio module, u8 *data, unsigned max)
+{
+    struct rx_packet *pkt = next_packet(module, 1);
+    if (! pkt)
+        return 0;
+    unsigned len = pkt->len < max ? pkt->len : max;
+    memcpy(data, pkt->data, len);
+    return len;
+}
+
+// Adds a sent packet to the log.  The time is filled in here
+void EMURF_LogTx(struct EmuRFPacket *pkt)
+{
+    pkt->time = now_us();
+    txlog[txlog_count++ % EMURF_LOG_SIZE] = *pkt;
+    if (txlog_fh) {
+        fprintf(txlog_fh, "%u %s %d:", (unsigned)pkt->time, MODULE_NAME[pkt->module], pkt->channel);
+        for (int i = 0; i < pkt->len; i++)
+            fprintf(txlog_fh, " %02x", pkt->data[i]);
+        fprintf(txlog_fh, "\n");
+    }
+}
+
+unsigned EMURF_LogCount()
+{
+    return txlog_count < EMURF_LOG_SIZE ? txlog_count : EMURF_LOG_SIZE;
+}
+
+// Returns the idx'th oldest packet still in the log
+const struct EmuRFPacket *EMURF_LogPacket(unsigned idx)
+{
+    if (idx >= EMURF_LogCount())
+        return NULL;
+    return &txlog[(txlog_count - EMURF_LogCount() + idx) % EMURF_LOG_SIZE];
+}
+
+void EMURF_ClearLog()
+{
+    txlog_count = 0;
+}
+
+#define TESTNAME emu_rf
+#include <tests.h>
@@ -0,0 +1,50 @@
+#ifndef _EMU_RF_H_
+#define _EMU_RF_H_
+
+/* Register level models of the RF chips for the emulator and the unit tests.
+ * The chip selected by the module enable pins receives the protocol SPI
+ * traffic.  Sent packets are stored in a log, and packets queued with
+ * EMURF_Inject() are received the next time the chip enters receive mode */
+
+#define EMURF_MAX_PACKET 64
+#define EMURF_LOG_SIZE   64
+
+struct EmuRFPacket {
+    u32 time;           // usec
+    u8 module;
+    u8 channel;
+    u8 len;
+    u8 id_len;
+    u16 crc_seed;
+    u8 id[8];           // SOP code, sync word or address
+    u8 data[EMURF_MAX_PACKET];
+};
+
+struct EmuRFChip {
+    void (*reset)();
+    void (*select)(int active);
+    u8 (*xfer)(u8 byte);
+};
+
+extern const struct EmuRFChip EMURF_CYRF6936;
+extern const struct EmuRFChip EMURF_A7105;
+extern const struct EmuRFChip EMURF_CC2500;
+extern const struct EmuRFChip EMURF_NRF24L01;
+
+void EMURF_Init();
+void EMURF_SetPin(struct mcu_pin pin, int value);
+u8 EMURF_Xfer(u8 byte);
+void EMURF_Reset(enum Radio module);
+
+int EMURF_Inject(enum Radio module, const u8 *data, unsigned len);
+int EMURF_LoadScript(const char *filename);
+unsigned EMURF_LogCount();
+const struct EmuRFPacket *EMURF_LogPacket(unsigned idx);
+void EMURF_ClearLog();
+
+/* Used by the chip models */
+void EMURF_LogTx(struct EmuRFPacket *pkt);
+unsigned EMURF_Receive(enum Radio module, u8 *data, unsigned max);
+int EMURF_Pending(enum Radio module);
+
+#endif // _EMU_RF_H_
@@ -14,6 +14,7 @@
         .dma = DMA1,                       \
         .stream = DMA_CHANNEL1,            \
         })
+    #define _ADC_DMA_ISR                  dma1_channel1_isr
 #endif
 
 #ifndef USART_DMA
@@ -114,6 +115,15 @@
     #define PROTO_RST_PIN ((struct mcu_pin){GPIOB, GPIO11})
 #endif  // PROTO_SPI
 
+#ifndef PROTO_SPI_DMA
+    // SPI2_TX.  SPI2_RX (DMA1 channel 4) is used by the UART
+    #define PROTO_SPI_DMA ((struct dma_config) { \
+        .dma = DMA1,                       \
+        .stream = DMA_CHANNEL5,            \
+        })
+    #define _PROTO_SPI_DMA_ISR            dma1_channel5_isr
+#endif  // PROTO_SPI_DMA
+
 #ifndef TOUCH_SPI
     #define TOUCH_SPI ((struct spi_csn) { \
         .spi = SPI1,           \
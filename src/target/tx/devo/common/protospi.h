@@ -5,6 +5,8 @@
 #include <libopencm3/stm32/spi.h>
 
 u8 PROTOSPI_read3wire();
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void));
+void PROTOSPI_wait();
 
 #define PROTOSPI_pin_set(io) GPIO_pin_set(io)
 #define PROTOSPI_pin_clear(io) GPIO_pin_clear(io)
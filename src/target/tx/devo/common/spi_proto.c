@@ -26,11 +26,25 @@
 #include <stdlib.h>
 #include "target/drivers/mcu/stm32/spi.h"
 #include "target/drivers/mcu/stm32/rcc.h"
+#include "target/drivers/mcu/stm32/dma.h"
+#include "target/drivers/mcu/stm32/nvic.h"
 
 #ifndef HAS_4IN1_FLASH
     #define HAS_4IN1_FLASH 0
 #endif
 
+/* Bursts that only write (payloads and FIFOs) are sent by DMA and the chip
+ * select is released from the DMA interrupt, so the protocol can go on
+ * building its next packet.  Reads are done byte by byte since the RX DMA
+ * channel is used by the UART.  When the bus is shared with the flash, the
+ * main loop could use it mid-transfer, so DMA is not used */
+#define USE_PROTO_DMA (PROTO_SPI.spi != FLASH_SPI.spi)
+#define PROTO_DMA_BUF_SIZE 64
+
+static u8 dma_buf[PROTO_DMA_BUF_SIZE];
+volatile u8 proto_dma_busy;
+void (*volatile proto_dma_done)(void);
+
 #if HAS_MULTIMOD_SUPPORT
 int SPI_ConfigSwitch(unsigned csn_high, unsigned csn_low)
 {
@@ -105,6 +119,12 @@ void SPI_ProtoInit()
             SPISwitch_Init();
         }
     }
+    if (USE_PROTO_DMA) {
+        rcc_periph_clock_enable(get_rcc_from_port(PROTO_SPI_DMA.dma));
+        //Must preempt the protocol timer, which waits for the transfer to end
+        nvic_set_priority(get_nvic_dma_irq(PROTO_SPI_DMA), 2);
+        nvic_enable_irq(get_nvic_dma_irq(PROTO_SPI_DMA));
+    }
 
 #if HAS_MULTIMOD_SUPPORT
     if(Transmitter.module_enable[MULTIMOD].port) {
@@ -126,6 +146,49 @@ void SPI_ProtoInit()
     }
 }
 
+/* Sends len bytes from tx (zeros if NULL), storing the received bytes in rx
+ * unless it is NULL.  done_cb is called once the last byte has been sent.
+ * Write-only bursts with a callback return before the transfer is done, and
+ * tx may be reused immediately.  Use PROTOSPI_wait() to wait for the end */
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void))
+{
+    PROTOSPI_wait();
+    if (! USE_PROTO_DMA || ! tx || rx || ! done_cb || ! len || len > PROTO_DMA_BUF_SIZE) {
+        for (unsigned i = 0; i < len; i++) {
+            u8 data = spi_xfer(PROTO_SPI.spi, tx ? tx[i] : 0);
+            if (rx)
+                rx[i] = data;
+        }
+        if (done_cb)
+            done_cb();
+        return;
+    }
+    memcpy(dma_buf, tx, len);
+    proto_dma_done = done_cb;
+    proto_dma_busy = 1;
+
+    DMA_stream_reset(PROTO_SPI_DMA);
+    dma_set_peripheral_address(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream, (u32) &SPI_DR(PROTO_SPI.spi));
+    dma_set_memory_address(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream, (u32) dma_buf);
+    dma_set_number_of_data(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream, len);
+    dma_set_read_from_memory(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream);
+    dma_enable_memory_increment_mode(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream);
+    dma_set_peripheral_size(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream, DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream, DMA_SxCR_MSIZE_8BIT);
+    dma_set_priority(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream, DMA_CCR_PL_HIGH);
+    dma_enable_transfer_complete_interrupt(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream);
+    DMA_channel_select(PROTO_SPI_DMA);
+
+    DMA_enable_stream(PROTO_SPI_DMA);
+    spi_enable_tx_dma(PROTO_SPI.spi);
+}
+
+void PROTOSPI_wait()
+{
+    while (proto_dma_busy)
+        ;
+}
+
 void SPI_AVRProgramInit()
 {
     rcc_set_ppre1(RCC_CFGR_PPRE1_HCLK_DIV16);  // 72 / 16 = 4.5MHz
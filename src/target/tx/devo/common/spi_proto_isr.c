@@ -0,0 +1,45 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/stm32/spi.h>
+#include <libopencm3/stm32/dma.h>
+
+#include "common.h"
+#include "target/drivers/mcu/stm32/dma.h"
+
+extern volatile u8 proto_dma_busy;
+extern void (*volatile proto_dma_done)(void);
+
+void __attribute__((__used__)) _PROTO_SPI_DMA_ISR(void)
+{
+    DMA_IFCR(PROTO_SPI_DMA.dma) |= DMA_IFCR_CTCIF(PROTO_SPI_DMA.stream);
+    dma_disable_transfer_complete_interrupt(PROTO_SPI_DMA.dma, PROTO_SPI_DMA.stream);
+    DMA_disable_stream(PROTO_SPI_DMA);
+
+    // The last bytes are still being shifted out
+    while (! (SPI_SR(PROTO_SPI.spi) & SPI_SR_TXE))
+        ;
+    while (SPI_SR(PROTO_SPI.spi) & SPI_SR_BSY)
+        ;
+    spi_disable_tx_dma(PROTO_SPI.spi);
+    // Drop the bytes received during the burst and clear the overrun flag
+    volatile u8 x = SPI_DR(PROTO_SPI.spi);
+    x = SPI_SR(PROTO_SPI.spi);
+    (void)x;
+
+    if (proto_dma_done)
+        proto_dma_done();
+    proto_dma_busy = 0;
+}
@@ -26,6 +26,7 @@
 #define HAS_EXTENDED_AUDIO  1
 #define HAS_AUDIO_UART      0
 #define HAS_MUSIC_CONFIG    1
+#define FONT_CACHE_SIZE     16
 
 #if BUILD_TYPE == 0
   #define SUPPORT_CRSF_CONFIG 1
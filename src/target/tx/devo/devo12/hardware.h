@@ -51,6 +51,7 @@
     .dma = DMA2,                       \
     .stream = DMA_CHANNEL5,            \
     })
+#define _ADC_DMA_ISR                dma2_channel4_5_isr
 
 // PWM overrides
 #define PWM_TIMER ((struct tim_config) { \
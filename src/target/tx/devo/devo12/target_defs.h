@@ -31,6 +31,9 @@
 #define HAS_EXTENDED_AUDIO  1
 #define HAS_AUDIO_UART      0
 #define HAS_MUSIC_CONFIG    1
+#define CRC_TABLES_IN_RAM   1
+#define FONT_CACHE_SIZE     32
+#define BACKGROUND_CACHE_SIZE 8192
 
 #if BUILD_TYPE == 0
   #define SUPPORT_CRSF_CONFIG 1
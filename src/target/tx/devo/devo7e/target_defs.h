@@ -51,6 +51,7 @@
 #define NUM_TRIMS 6
 #define MAX_POINTS 13
 #define NUM_MIXERS ((NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS) * 4)
+#define CURVE_TABLES 4
 
 #define INP_HAS_CALIBRATION 4
 
@@ -95,6 +95,7 @@
     .stream = DMA_STREAM0,             \
     .channel = DMA_SxCR_CHSEL_0,       \
     })
+#define _ADC_DMA_ISR                dma2_stream0_isr
 
 // Backlight
 #define BACKLIGHT_TIM ((struct tim_config) { \
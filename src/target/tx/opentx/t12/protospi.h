@@ -6,6 +6,8 @@
 
 u8 PROTOSPI_read3wire();
 u8 PROTOSPI_xfer(u8 byte);
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void));
+#define PROTOSPI_wait() if (0) {}
 #define PROTOSPI_pin_set(io) GPIO_pin_set(io)
 #define PROTOSPI_pin_clear(io) GPIO_pin_clear(io)
 #define PROTOSPI_pin_get(io) GPIO_pin_get(io)
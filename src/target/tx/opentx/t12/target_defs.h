@@ -46,6 +46,9 @@
 #define HAS_OLED_DISPLAY    0
 #define HAS_HARD_POWER_OFF  0
 #define HAS_PWR_SWITCH_INVERTED 1
+#define CRC_TABLES_IN_RAM   1
+#define CRC_SLICE_BY_4      1
+#define FONT_CACHE_SIZE     64
 
 #define SUPPORT_STACKDUMP       0
 
@@ -5,6 +5,17 @@
 int SPI_ProtoGetPinConfig(int module, int state) {(void)module; (void)state; return 0;}
 u8 PROTOSPI_read3wire() { return 0x00; }
 u8 PROTOSPI_xfer(u8 byte) { return byte; }
+
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void))
+{
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = PROTOSPI_xfer(tx ? tx[i] : 0);
+        if (rx)
+            rx[i] = data;
+    }
+    if (done_cb)
+        done_cb();
+}
 void SPI_ProtoInit() {}
 int MCU_SetPin(struct mcu_pin *port, const char *name) {return 0;}
 void MCU_InitModules() {}
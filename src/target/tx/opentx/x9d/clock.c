@@ -185,6 +185,11 @@ u32 CLOCK_getms()
     return msecs;
 }
 
+u16 CLOCK_getus()
+{
+    return timer_get_counter(TIM5);
+}
+
 void CLOCK_SetMsecCallback(int cb, u32 msec)
 {
     msec_cbtime[cb] = msecs + msec;
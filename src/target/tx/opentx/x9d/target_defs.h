@@ -24,6 +24,9 @@
 #define HAS_EXTRA_SWITCHES  0
 #define HAS_EXTRA_BUTTONS  0
 #define HAS_MULTIMOD_SUPPORT 1
+#define CRC_TABLES_IN_RAM  1
+#define CRC_SLICE_BY_4     1
+#define FONT_CACHE_SIZE    64
 
 #define MIN_BRIGHTNESS 0
 #define DEFAULT_BATTERY_ALARM 6000
@@ -0,0 +1,212 @@
+/*
+    This project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Deviation is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Host-side mixer benchmark
+ *   make TARGET=benchmark
+ *   ./benchmark.elf [-n iterations] [model ...]
+ * Each 'model' is either a model number (models/modelN.ini) or the name of a
+ * file in the template directory.  All templates are used if no model is given.
+ * Paths are relative to the benchmark filesystem (filesystem/benchmark).
+ */
+// System headers must come before common.h which redefines usleep
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "common.h"
+#include "mixer.h"
+#include "config/model.h"
+#include "config/tx.h"
+
+extern void TEST_CHAN_SetChannelValue(int channel, s32 value);
+
+static const char * const step_name[MIXERSTEP_LAST] = {
+    "inputs", "mixers", "cyclic", "limits",
+};
+
+static int measure_steps;
+static u64 step_start;
+static u64 step_ns[MIXERSTEP_LAST];
+
+static u64 now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void BENCH_MixerStep(enum MixerStep step)
+{
+    if (! measure_steps)
+        return;
+    u64 now = now_ns();
+    step_ns[step] += now - step_start;
+    step_start = now;
+}
+
+#ifdef __linux__
+static int open_instruction_counter()
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static u64 read_counter(int fd)
+{
+    u64 count = 0;
+    if (fd < 0 || read(fd, &count, sizeof(count)) != sizeof(count))
+        return 0;
+    return count;
+}
+#define COUNTER_START(fd) do { if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); } } while(0)
+#define COUNTER_STOP(fd)  do { if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); } while(0)
+#else
+static int open_instruction_counter() { return -1; }
+static u64 read_counter(int fd) { (void)fd; return 0; }
+#define COUNTER_START(fd)
+#define COUNTER_STOP(fd)
+#endif
+
+static void print_tenths(const char *label, u64 value, unsigned iterations, const char *unit)
+{
+    u64 tenths = value * 10 / iterations;
+    printf("%s: %u.%u %s/iter", label, (unsigned)(tenths / 10), (unsigned)(tenths % 10), unit);
+}
+
+// Move all sticks through their range so that curves and muxes see varying inputs
+static void move_sticks(unsigned iter)
+{
+    s32 pos = (s32)(iter % 200) * 100 - 10000;
+    TEST_CHAN_SetChannelValue(INP_THROTTLE, pos);
+    TEST_CHAN_SetChannelValue(INP_AILERON, -pos);
+    TEST_CHAN_SetChannelValue(INP_ELEVATOR, pos / 2);
+    TEST_CHAN_SetChannelValue(INP_RUDDER, -pos / 2);
+}
+
+static void run(unsigned iterations)
+{
+    int fd = open_instruction_counter();
+    unsigned mixers = 0;
+    while (mixers < NUM_MIXERS && MIXER_SRC(Model.mixers[mixers].src))
+        mixers++;
+
+    //Pass 1: Overall timing without the per-step overhead
+    measure_steps = 0;
+    MIXER_CalcChannels();
+    COUNTER_START(fd);
+    u64 start = now_ns();
+    for (unsigned i = 0; i < iterations; i++) {
+        if ((i & 0x3f) == 0)
+            move_sticks(i >> 6);
+        MIXER_CalcChannels();
+    }
+    u64 total = now_ns() - start;
+    COUNTER_STOP(fd);
+    u64 instructions = read_counter(fd);
+
+    //Pass 2: Per-step breakdown
+    memset(step_ns, 0, sizeof(step_ns));
+    measure_steps = 1;
+    for (unsigned i = 0; i < iterations; i++) {
+        if ((i & 0x3f) == 0)
+            move_sticks(i >> 6);
+        step_start = now_ns();
+        MIXER_CalcChannels();
+    }
+    measure_steps = 0;
+    u64 step_total = 0;
+    for (int i = 0; i < MIXERSTEP_LAST; i++)
+        step_total += step_ns[i];
+
+    // The firmware printf has no floating point support, so print tenths by hand
+    printf("  mixers: %u  iterations: %u\n", mixers, iterations);
+    print_tenths("  total", total, iterations, "ns");
+    if (fd >= 0)
+        print_tenths(" ", instructions, iterations, "instructions");
+    printf("\n");
+    for (int i = 0; i < MIXERSTEP_LAST; i++) {
+        printf("  %s", step_name[i]);
+        print_tenths("", step_ns[i], iterations, "ns");
+        printf(" (%u%%)\n", step_total ? (unsigned)(100 * step_ns[i] / step_total) : 0);
+    }
+    if (fd >= 0)
+        close(fd);
+}
+
+static int load_model(const char *name)
+{
+    if (exact_atoi(name) > 0 || strcmp(name, "0") == 0) {
+        return CONFIG_ReadModel(atoi(name));
+    }
+    return CONFIG_ReadTemplate(name);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned iterations = 1000000;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:")) != -1) {
+        switch (opt) {
+        case 'n': iterations = strtoul(optarg, NULL, 0); break;
+        default:
+            printf("Usage: %s [-n iterations] [model number | template name] ...\n", argv[0]);
+            return 1;
+        }
+    }
+    if (chdir(FILESYSTEM_DIR)) {
+        printf("Could not find filesystem: %s\n", FILESYSTEM_DIR);
+        return 1;
+    }
+    CRC_Init();
+    CONFIG_LoadTx();
+    MIXER_Init();
+
+    if (optind < argc) {
+        for (int i = optind; i < argc; i++) {
+            printf("%s:\n", argv[i]);
+            if (! load_model(argv[i])) {
+                printf("  Failed to load model\n");
+                continue;
+            }
+            run(iterations);
+        }
+        return 0;
+    }
+    DIR *dir = opendir("template");
+    struct dirent *entry;
+    while (dir && (entry = readdir(dir))) {
+        if (! strstr(entry->d_name, ".ini"))
+            continue;
+        printf("%s:\n", entry->d_name);
+        if (load_model(entry->d_name))
+            run(iterations);
+    }
+    if (dir)
+        closedir(dir);
+    return 0;
+}
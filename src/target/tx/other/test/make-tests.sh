@@ -15,6 +15,8 @@ echo '
 
 #include "CuTest.h"
 
+extern void CRC_Init();
+
 '
 
 cat $FILES | grep '^void Test' |
@@ -51,6 +53,7 @@ echo \
 int main(void)
 {
     chdir(FILESYSTEM_DIR);
+    CRC_Init();
     return RunAllTests();
 }
 
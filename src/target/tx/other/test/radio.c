@@ -17,6 +17,7 @@
 #include "protocol/interface.h"
 #include "config/model.h"
 #include "config/tx.h"
+#include "target/drivers/rf/emu/emu_rf.h"
 
 #include <stdlib.h>
 
@@ -32,6 +33,7 @@ void MCU_InitModules() {
     Transmitter.module_enable[CYRF6936].port = GPIOB;
     Transmitter.module_enable[CYRF6936].pin  = 1 << 12;
     Transmitter.module_poweramp = 1;
+    EMURF_Init();
 };
 int MCU_SetPin(struct mcu_pin *port, const char *name) {
     switch(name[0]) {
@@ -123,19 +125,30 @@ int SPI_ProtoGetPinConfig(int module, int state) {
     return 0;
 }
 
-u8 PROTOSPI_read3wire() { return 0x00; }
+u8 PROTOSPI_read3wire() { return EMURF_Xfer(0x00); }
 
-u8 PROTOSPI_xfer(u8 byte) { return byte; }
+u8 PROTOSPI_xfer(u8 byte) { return EMURF_Xfer(byte); }
+
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void))
+{
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = PROTOSPI_xfer(tx ? tx[i] : 0);
+        if (rx)
+            rx[i] = data;
+    }
+    if (done_cb)
+        done_cb();
+}
 
 #ifdef PROTO_HAS_A7105
-int A7105_Reset() { return 1; }
+int A7105_Reset() { EMURF_Reset(A7105); return 1; }
 #endif
 
 #ifdef PROTO_HAS_CC2500
-int CC2500_Reset() { return 1;}
+int CC2500_Reset() { EMURF_Reset(CC2500); return 1; }
 #endif //PROTO_HAS_CC2500
 /* CYRF */
-int CYRF_Reset() {return 1;}
+int CYRF_Reset() { EMURF_Reset(CYRF6936); return 1; }
 
 void SPI_AVRProgramInit() {}
 void PWM_Initialize() {}
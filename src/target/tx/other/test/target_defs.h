@@ -2,4 +2,6 @@
 #include "target/drivers/mcu/emu/common_emu.h"
 #include "target/tx/devo/devo8/target_defs.h"
 
+#define CRC_SLICE_BY_4 1
+
 #define BUTTON_MAP { 'A', 'Q', 'D', 'E', 'S', 'W', 'F', 'R', 'G', 'T', 'H', 'Y', FL_Left, FL_Right, FL_Down, FL_Up, 13/*FL_Enter*/, FL_Escape, 0 }
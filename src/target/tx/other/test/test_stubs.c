@@ -89,12 +89,18 @@ u32 CLOCK_getms()
     return 100000;
 }
 
+u16 CLOCK_getus()
+{
+    return 0;
+}
+
 void PWR_Sleep()
 {
 }
 
 void _usleep(u32 usec) {
-    usleep(usec);
+    //usleep is defined as _usleep, and the tests don't need to wait
+    (void)usec;
 }
 void TxName(u8 *var, int len) {
     const u8 model[] = "EMU_STRING";
@@ -119,11 +125,14 @@ void Initialize_ButtonMatrix() {}
 void PWR_Init(void) {}
 unsigned  PWR_ReadVoltage() { return (DEFAULT_BATTERY_ALARM + 1000); }
 void ADC_Init() {}
+void ADC_UpdateCalibration() {}
 void SWITCH_Init() {}
 
 void CLOCK_StartWatchdog() {}
 void CLOCK_ResetWatchdog() {}
 void CLOCK_RunMixer() {}
+void CLOCK_ScheduleMixer(u16 us) { (void)us; }
+u16 CLOCK_MixerRuntime() { return 0; }
 void CLOCK_StartMixer() {}
 volatile mixsync_t mixer_sync;
 
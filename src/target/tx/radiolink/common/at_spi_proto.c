@@ -23,6 +23,7 @@
 //#include <stdlib.h>
 #include "target/drivers/mcu/stm32/spi.h"
 #include "target/drivers/mcu/stm32/rcc.h"
+#include "protospi.h"
 
 void SPI_ProtoInit()
 {
@@ -33,6 +34,17 @@ void SPI_ProtoInit()
     GPIO_pin_set(PROTO_SPI.csn);
 }
 
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void))
+{
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = PROTOSPI_xfer(tx ? tx[i] : 0);
+        if (rx)
+            rx[i] = data;
+    }
+    if (done_cb)
+        done_cb();
+}
+
 void MCU_InitModules()
 {
 }
@@ -43,6 +43,7 @@
     .dma = DMA1,                       \
     .stream = DMA_CHANNEL1,            \
     })
+#define _ADC_DMA_ISR                dma1_channel1_isr
 
 #define UART_CFG ((struct uart_config) {   \
     .uart = USART1,                         \
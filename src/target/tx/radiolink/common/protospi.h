@@ -5,6 +5,8 @@
 #include <libopencm3/stm32/spi.h>
 
 u8 PROTOSPI_read3wire();
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void));
+#define PROTOSPI_wait() if (0) {}
 
 #define PROTOSPI_pin_set(io) gpio_set(io.port, io.pin)
 #define PROTOSPI_pin_clear(io) gpio_clear(io.port, io.pin)
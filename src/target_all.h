@@ -2,6 +2,18 @@
 #define SUPPORT_MULTI_LANGUAGE 1
 #endif
 
+#ifndef TR_CALLSITE_CACHE
+#define TR_CALLSITE_CACHE 64  //String literals whose translation is remembered, must be a power of 2
+#endif
+
+#ifndef TR_STRING_CACHE
+#define TR_STRING_CACHE 8  //Translations kept in RAM with SUPPORT_DYNAMIC_LOCSTR
+#endif
+
+#ifndef TR_STRING_LEN
+#define TR_STRING_LEN 40  //Longer translations are not kept in the cache
+#endif
+
 #ifndef SUPPORT_XN297DUMP
 #define SUPPORT_XN297DUMP 1
 #endif
@@ -9,3 +21,55 @@
 #ifndef SUPPORT_CRSF_CONFIG
 #define SUPPORT_CRSF_CONFIG 0
 #endif
+
+#ifndef SUPPORT_MODEL_CACHE
+#define SUPPORT_MODEL_CACHE 1
+#endif
+
+#ifndef FONT_CACHE_SIZE
+#define FONT_CACHE_SIZE 0  //Number of glyphs kept in RAM
+#endif
+
+#ifndef BACKGROUND_CACHE_SIZE
+#define BACKGROUND_CACHE_SIZE 0  //Bytes of RAM for background regions under dynamic objects
+#endif
+
+#ifndef INPUT_EVENT_QUEUE
+#define INPUT_EVENT_QUEUE 16  //Input events between mixer and main loop, must be a power of 2
+#endif
+
+#ifndef DATALOG_BUFFER_SIZE
+#define DATALOG_BUFFER_SIZE 512  //Samples are written to datalog.bin once this fills up
+#endif
+
+#ifndef SOUND_TABLE_SIZE
+#define SOUND_TABLE_SIZE 128  //Notes from sound.ini kept in RAM
+#endif
+
+#ifndef CRC_TABLES_IN_RAM
+#define CRC_TABLES_IN_RAM 0
+#endif
+
+#ifndef CRC_SLICE_BY_4
+#define CRC_SLICE_BY_4 0
+#endif
+
+#ifndef SUPPORT_ISR_PROFILE
+    #if DEBUG_WINDOW_SIZE || defined EMULATOR
+        #define SUPPORT_ISR_PROFILE 1
+    #else
+        #define SUPPORT_ISR_PROFILE 0
+    #endif
+#endif
+
+#ifndef SUPPORT_TRACE
+    #if DEBUG_WINDOW_SIZE || defined EMULATOR
+        #define SUPPORT_TRACE 1
+    #else
+        #define SUPPORT_TRACE 0
+    #endif
+#endif
+
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 1024  //Bytes per interrupt, must be a power of 2
+#endif
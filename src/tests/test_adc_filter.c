@@ -0,0 +1,94 @@
+#include "CuTest.h"
+
+#define CHANNELS 3
+#define SCANS    5
+
+static void fill(u16 *buf, unsigned chan, u16 value)
+{
+    for (int i = 0; i < SCANS; i++)
+        buf[i * CHANNELS + chan] = value;
+}
+
+void TestAdcFilterBox(CuTest *t)
+{
+    struct ADCFilter f;
+    u16 buf[CHANNELS * SCANS];
+    memset(buf, 0, sizeof(buf));
+    ADCFILTER_Init(&f, ADC_FILTER_BOX);
+
+    // Only the filled half is used until both halves have data
+    fill(buf, 1, 1000);
+    buf[1] = 1010;
+    ADCFILTER_Update(&f, 0, buf + 1, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1002, ADCFILTER_Value(&f));
+
+    fill(buf, 1, 2000);
+    ADCFILTER_Update(&f, 1, buf + 1, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1501, ADCFILTER_Value(&f));
+
+    // Replacing a half drops its previous samples from the sum
+    ADCFILTER_Update(&f, 0, buf + 1, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 2000, ADCFILTER_Value(&f));
+}
+
+void TestAdcFilterExponential(CuTest *t)
+{
+    struct ADCFilter f;
+    u16 buf[CHANNELS * SCANS];
+    ADCFILTER_Init(&f, ADC_FILTER_EXP);
+
+    fill(buf, 0, 1000);
+    ADCFILTER_Update(&f, 0, buf, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1000, ADCFILTER_Value(&f));
+
+    // Moves 1/4 of the way to the new mean for each half buffer
+    fill(buf, 0, 1400);
+    ADCFILTER_Update(&f, 1, buf, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1100, ADCFILTER_Value(&f));
+    ADCFILTER_Update(&f, 0, buf, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1175, ADCFILTER_Value(&f));
+
+    // Converges in both directions
+    for (int i = 0; i < 100; i++)
+        ADCFILTER_Update(&f, i & 1, buf, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1400, ADCFILTER_Value(&f));
+    fill(buf, 0, 0);
+    for (int i = 0; i < 100; i++)
+        ADCFILTER_Update(&f, i & 1, buf, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 0, ADCFILTER_Value(&f));
+}
+
+void TestAdcFilterMedian(CuTest *t)
+{
+    struct ADCFilter f;
+    u16 buf[CHANNELS * SCANS];
+    ADCFILTER_Init(&f, ADC_FILTER_MEDIAN3);
+
+    fill(buf, 2, 1000);
+    ADCFILTER_Update(&f, 0, buf + 2, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1000, ADCFILTER_Value(&f));
+
+    // A single spike is rejected
+    fill(buf, 2, 4000);
+    ADCFILTER_Update(&f, 1, buf + 2, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1000, ADCFILTER_Value(&f));
+    fill(buf, 2, 1100);
+    ADCFILTER_Update(&f, 0, buf + 2, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1100, ADCFILTER_Value(&f));
+    ADCFILTER_Update(&f, 1, buf + 2, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1100, ADCFILTER_Value(&f));
+
+    // A real step is followed after two half buffers
+    fill(buf, 2, 3000);
+    ADCFILTER_Update(&f, 0, buf + 2, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 1100, ADCFILTER_Value(&f));
+    ADCFILTER_Update(&f, 1, buf + 2, CHANNELS, SCANS);
+    CuAssertIntEquals(t, 3000, ADCFILTER_Value(&f));
+
+    CuAssertIntEquals(t, 2, median3(1, 2, 3));
+    CuAssertIntEquals(t, 2, median3(3, 1, 2));
+    CuAssertIntEquals(t, 2, median3(2, 3, 1));
+    CuAssertIntEquals(t, 2, median3(3, 2, 1));
+    CuAssertIntEquals(t, 2, median3(1, 3, 2));
+    CuAssertIntEquals(t, 2, median3(2, 2, 5));
+}
@@ -0,0 +1,100 @@
+#include "CuTest.h"
+
+// Hand coded SBUS/CRSF packing previously used by the protocols
+static void ref_pack11(u8 *packet, const u16 *channels)
+{
+    for (int i = 0; i < 2; i++, packet += 11, channels += 8) {
+        packet[0]  = (u8) ((channels[0] & 0x07FF));
+        packet[1]  = (u8) ((channels[0] & 0x07FF)>>8  | (channels[1] & 0x07FF)<<3);
+        packet[2]  = (u8) ((channels[1] & 0x07FF)>>5  | (channels[2] & 0x07FF)<<6);
+        packet[3]  = (u8) ((channels[2] & 0x07FF)>>2);
+        packet[4]  = (u8) ((channels[2] & 0x07FF)>>10 | (channels[3] & 0x07FF)<<1);
+        packet[5]  = (u8) ((channels[3] & 0x07FF)>>7  | (channels[4] & 0x07FF)<<4);
+        packet[6]  = (u8) ((channels[4] & 0x07FF)>>4  | (channels[5] & 0x07FF)<<7);
+        packet[7]  = (u8) ((channels[5] & 0x07FF)>>1);
+        packet[8]  = (u8) ((channels[5] & 0x07FF)>>9  | (channels[6] & 0x07FF)<<2);
+        packet[9]  = (u8) ((channels[6] & 0x07FF)>>6  | (channels[7] & 0x07FF)<<5);
+        packet[10] = (u8) ((channels[7] & 0x07FF)>>3);
+    }
+}
+
+void TestChanframePack(CuTest *t)
+{
+    u16 values[16];
+    u8 expected[24];
+    u8 packet[24];
+    u32 seed = 0x1234;
+
+    for (int loop = 0; loop < 100; loop++) {
+        for (int i = 0; i < 16; i++)
+            values[i] = rand32_r(&seed, 0);
+        ref_pack11(expected, values);
+        memset(packet, 0xaa, sizeof(packet));
+        CHANFRAME_PackLE(packet, values, 16, 11);
+        CuAssertTrue(t, memcmp(expected, packet, 22) == 0);
+        CuAssertIntEquals(t, 0xaa, packet[22]);
+
+        //FrSky X / PXX 12 bit pairs
+        for (int i = 0; i < 8; i += 2) {
+            u16 chan_0 = values[i] & 0xfff, chan_1 = values[i + 1] & 0xfff;
+            expected[i / 2 * 3]     = chan_0;
+            expected[i / 2 * 3 + 1] = (((chan_0 >> 8) & 0x0F) | (chan_1 << 4));
+            expected[i / 2 * 3 + 2] = chan_1 >> 4;
+        }
+        CHANFRAME_PackLE(packet, values, 8, 12);
+        CuAssertTrue(t, memcmp(expected, packet, 12) == 0);
+
+        //SUMD 16 bit big-endian
+        for (int i = 0; i < 12; i++) {
+            expected[2 * i] = values[i] >> 8;
+            expected[2 * i + 1] = values[i];
+        }
+        CHANFRAME_PackBE(packet, values, 12, 16);
+        CuAssertTrue(t, memcmp(expected, packet, 24) == 0);
+    }
+
+    //Partial bytes are aligned to the start of the last byte
+    values[0] = 0x7ff;
+    values[1] = 0x001;
+    CHANFRAME_PackLE(packet, values, 2, 11);
+    CuAssertIntEquals(t, 0xff, packet[0]);
+    CuAssertIntEquals(t, 0x0f, packet[1]);
+    CuAssertIntEquals(t, 0x00, packet[2]);
+    CHANFRAME_PackBE(packet, values, 2, 11);
+    CuAssertIntEquals(t, 0xff, packet[0]);
+    CuAssertIntEquals(t, 0xe0, packet[1]);
+    CuAssertIntEquals(t, 0x04, packet[2]);
+}
+
+void TestChanframeScale(CuTest *t)
+{
+    static const s32 scales[][2] = {
+        {800, CHAN_MAX_VALUE}, {3200, CHAN_MAX_VALUE}, {751, CHAN_MAX_VALUE}, {15 * 100, 2 * CHAN_MAX_VALUE},
+    };
+    for (unsigned i = 0; i < sizeof(scales) / sizeof(scales[0]); i++) {
+        u32 mult = CHANFRAME_SCALE(scales[i][0], scales[i][1]);
+        for (s32 value = -32768; value <= 32767; value++) {
+            if (CHANFRAME_ScaleValue(value, mult) != value * scales[i][0] / scales[i][1]) {
+                CuAssertIntEquals(t, value * scales[i][0] / scales[i][1], CHANFRAME_ScaleValue(value, mult));
+            }
+        }
+    }
+
+    u16 channels[16];
+    u8 num_channels = Model.num_channels;
+    Model.num_channels = 4;
+    Channels[0] = CHAN_MAX_VALUE;
+    Channels[1] = CHAN_MIN_VALUE;
+    Channels[2] = 0;
+    Channels[3] = -1;
+    Channels[4] = CHAN_MAX_VALUE;
+    CHANFRAME_Scale(channels, 16, CHANFRAME_SCALE(800, CHAN_MAX_VALUE), 992);
+    CuAssertIntEquals(t, 1792, channels[0]);
+    CuAssertIntEquals(t, 192, channels[1]);
+    CuAssertIntEquals(t, 992, channels[2]);
+    CuAssertIntEquals(t, 992, channels[3]);
+    CuAssertIntEquals(t, 992, channels[4]);
+    CuAssertIntEquals(t, 992, channels[15]);
+    Model.num_channels = num_channels;
+    memset((void *)Channels, 0, sizeof(Channels));
+}
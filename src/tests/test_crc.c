@@ -0,0 +1,85 @@
+#include "CuTest.h"
+
+// Bit-serial reference implementations
+static u16 ref_crc16(u16 crc, const u8 *data, unsigned len)
+{
+    while (len--)
+        crc = CRC16_UpdateBits(crc, *data++, 8);
+    return crc;
+}
+
+static u16 ref_crc16_reflected(u16 crc, const u8 *data, unsigned len)
+{
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+    }
+    return crc;
+}
+
+// Nibble table implementation previously used by frskyx
+static u16 ref_crc16_frskyx(u16 crc, const u8 *data, unsigned len)
+{
+    static const u16 crc_short[] = {
+        0x0000,0x1189,0x2312,0x329b,0x4624,0x57ad,0x6536,0x74bf,
+        0x8c48,0x9dc1,0xaf5a,0xbed3,0xca6c,0xdbe5,0xe97e,0xf8f7,
+    };
+    while (len--) {
+        u8 val = (u8)(crc >> 8) ^ *data++;
+        crc = (crc << 8) ^ crc_short[val & 0x0f] ^ (0x1081 * (val >> 4));
+    }
+    return crc;
+}
+
+static u8 ref_crc8(u8 crc, const u8 *data, unsigned len)
+{
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x80) ? (crc << 1) ^ 0xd5 : crc << 1;
+    }
+    return crc;
+}
+
+static u32 ref_crc32(u32 crc, const u8 *data, unsigned len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+    return ~crc;
+}
+
+void TestCrcCheckValues(CuTest *t)
+{
+    const u8 *check = (const u8 *)"123456789";
+    CuAssertIntEquals(t, 0x29b1, CRC16_Update(0xffff, check, 9));           // CRC-16/CCITT-FALSE
+    CuAssertIntEquals(t, 0x906e, (u16)~CRC16_UpdateReflected(0xffff, check, 9)); // CRC-16/X-25
+    CuAssertIntEquals(t, 0xbc, CRC8_Update(0, check, 9));                   // CRC-8/DVB-S2
+    CuAssertIntEquals(t, 0xcbf43926, CRC32_Update(0, check, 9));            // CRC-32
+    CuAssertIntEquals(t, 0xcbf43926, Crc(check, 9));
+    // CRC32_Update can be continued
+    CuAssertIntEquals(t, 0xcbf43926, CRC32_Update(CRC32_Update(0, check, 5), check + 5, 4));
+}
+
+void TestCrcReference(CuTest *t)
+{
+    u8 data[64];
+    u32 seed = 0x1234;
+    for (unsigned i = 0; i < sizeof(data); i++)
+        data[i] = rand32_r(&seed, 8);
+    // Check all lengths and alignments to cover the slice-by-4 tails
+    for (unsigned start = 0; start < 4; start++) {
+        for (unsigned len = 0; len + start <= sizeof(data); len++) {
+            const u8 *d = data + start;
+            CuAssertIntEquals(t, ref_crc16(0xb5d2, d, len), CRC16_Update(0xb5d2, d, len));
+            CuAssertIntEquals(t, ref_crc16_reflected(0xffff, d, len), CRC16_UpdateReflected(0xffff, d, len));
+            CuAssertIntEquals(t, ref_crc16_frskyx(0, d, len), CRC16_UpdateFrSkyX(0, d, len));
+            CuAssertIntEquals(t, ref_crc8(0, d, len), CRC8_Update(0, d, len));
+            CuAssertIntEquals(t, ref_crc32(0, d, len), CRC32_Update(0, d, len));
+        }
+    }
+}
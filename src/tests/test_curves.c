@@ -0,0 +1,79 @@
+#include "CuTest.h"
+
+// Reference implementations using a linear search over all segments
+static s32 ref_interpolate(struct Curve *curve, s32 value)
+{
+    int num_points = (CURVE_TYPE(curve) - CURVE_3POINT) * 2 + 3;
+    s32 step = 2 * 10000 / (num_points - 1) ;
+    for (int i = 0; i < num_points - 1; i++) {
+        s32 x = -10000 + i * step;
+        s32 pos1 = PCT_TO_RANGE(x / 100);
+        s32 pos2 = PCT_TO_RANGE((x + step) / 100);
+        if(value >= pos1 && value <= pos2) {
+            s32 tmp = (value - pos1) * (curve->points[i + 1] - curve->points[i]) / (pos2 - pos1) + curve->points[i];
+            return PCT_TO_RANGE(tmp);
+        }
+    }
+    return PCT_TO_RANGE(curve->points[num_points - 1]);
+}
+
+static s32 ref_hermite_spline(struct Curve *curve, s32 value)
+{
+    int num_points = (CURVE_TYPE(curve) - CURVE_3POINT) * 2 + 3;
+    s32 step = PCT_TO_RANGE(2 * 100) / (num_points - 1) ;
+    for (int i = 0; i < num_points -1; i++) {
+        s32 p0x = PCT_TO_RANGE(-100) + i * step;
+        s32 p3x = (i == num_points - 2) ? PCT_TO_RANGE(100) : p0x + step;
+        if(value >= p0x && value <= p3x) {
+            s32 p0y = PCT_TO_RANGE(curve->points[i]);
+            s32 p3y = PCT_TO_RANGE(curve->points[i+1]);
+            s32 m0 = compute_tangent(curve, num_points, i);
+            s32 m3 = compute_tangent(curve, num_points, i+1);
+            s32 h = p3x - p0x;
+            s32 t = (MMULT * (value - p0x)) / h;
+            s32 t2 = t * t / MMULT;
+            s32 t3 = t2 * t / MMULT;
+            s32 h00 = 2*t3 - 3*t2 + MMULT;
+            s32 h10 = t3 - 2*t2 + t;
+            s32 h01 = -2*t3 + 3*t2;
+            s32 h11 = t3 - t2;
+            return (p0y * h00 + h * (m0 * h10 / MMULT) + p3y * h01 + h * (m3 * h11 / MMULT)) / MMULT;
+        }
+    }
+    return 0;
+}
+
+void TestCurveSegments(CuTest *t)
+{
+    struct Curve curve;
+    for (int type = CURVE_3POINT; type <= CURVE_13POINT; type++) {
+        memset(&curve, 0, sizeof(curve));
+        CURVE_SET_TYPE(&curve, type);
+        for (unsigned i = 0; i < CURVE_NumPoints(&curve); i++)
+            curve.points[i] = (i * 37) % 201 - 100;
+        for (s32 x = CHAN_MIN_VALUE; x <= CHAN_MAX_VALUE; x++) {
+            CURVE_SET_SMOOTHING(&curve, 0);
+            CuAssertIntEquals(t, ref_interpolate(&curve, x), CURVE_Evaluate(x, &curve));
+            CURVE_SET_SMOOTHING(&curve, 1);
+            CuAssertIntEquals(t, ref_hermite_spline(&curve, x), CURVE_Evaluate(x, &curve));
+        }
+    }
+}
+
+void TestCurveTables(CuTest *t)
+{
+    struct Curve curve = { .type = CURVE_9POINT, .points = {-100, -90, -40, 0, 10, 20, 80, 75, 100} };
+    CURVE_ResetTables();
+    CuAssertIntEquals(t, -1, CURVE_CreateTable(&curve));  // not smoothed
+    CURVE_SET_SMOOTHING(&curve, 1);
+    int table = CURVE_CreateTable(&curve);
+    CuAssertIntEquals(t, 0, table);
+    for (s32 x = CHAN_MIN_VALUE; x <= CHAN_MAX_VALUE; x += 7)
+        CuAssertIntEquals(t, CURVE_Evaluate(x, &curve), CURVE_EvaluateTable(x, &curve, table));
+
+    for (int i = 1; i < CURVE_TABLES; i++)
+        CuAssertIntEquals(t, i, CURVE_CreateTable(&curve));
+    CuAssertIntEquals(t, -1, CURVE_CreateTable(&curve));  // no tables left
+    CURVE_ResetTables();
+    CuAssertIntEquals(t, 0, CURVE_CreateTable(&curve));
+}
@@ -0,0 +1,121 @@
+#include "CuTest.h"
+
+static void read_log(u8 *data, int len)
+{
+    FILE *f = fopen("datalog.bin", "rb");
+    fread(data, len, 1, f);
+    fclose(f);
+}
+
+void TestDatalogBuffered(CuTest *t)
+{
+    u8 data[64];
+    struct datalog saved = Model.datalog;
+    FILE *f = fopen("datalog.bin", "w");
+    for (int i = 0; i < 4096; i++)
+        fputc(0, f);
+    fclose(f);
+    fh = NULL;
+    memset(&Model.datalog, 0, sizeof(Model.datalog));
+    DATALOG_ApplyMask(DLOG_TIMERS, 1);
+    DATALOG_ApplyMask(DLOG_GPSLOC, 1);
+    DATALOG_Init();
+    CuAssertPtrNotNull(t, fh);
+    CuAssertIntEquals(t, 2 + 8, data_size);
+
+    //Samples stay in RAM until flushed
+    _write_header();
+    DATALOG_Write();
+    DATALOG_Write();
+    CuAssertIntEquals(t, DATALOG_HEADER_SIZE + 2 * (1 + data_size), used);
+    CuAssertIntEquals(t, 4096 - INDEX_SIZE - used, DATALOG_Remaining());
+    read_log(data, sizeof(data));
+    CuAssertIntEquals(t, 0, data[0]);
+
+    DATALOG_Flush();
+    CuAssertIntEquals(t, 0, used);
+    CuAssertIntEquals(t, DATALOG_HEADER_SIZE + 2 * (1 + data_size), dlog_pos);
+    read_log(data, sizeof(data));
+    CuAssertIntEquals(t, DATALOG_VERSION, data[0]);
+    CuAssertIntEquals(t, 0xff, data[DATALOG_HEADER_SIZE]);
+    CuAssertIntEquals(t, 0xff, data[DATALOG_HEADER_SIZE + 1 + data_size]);
+    CuAssertIntEquals(t, 0, data[dlog_pos]);
+
+    //The end of the log is found again after a restart
+    u32 pos = dlog_pos;
+    fclose(fh);
+    fh = NULL;
+    DATALOG_Init();
+    CuAssertIntEquals(t, pos, dlog_pos);
+    CuAssertIntEquals(t, 1, dindex.num_sessions);
+    CuAssertIntEquals(t, 0, dindex.session[0]);
+    fclose(fh);
+    fh = NULL;
+    Model.datalog = saved;
+    remove("datalog.bin");
+}
+
+static void restart()
+{
+    fclose(fh);
+    fh = NULL;
+    memset(&dindex, 0, sizeof(dindex));
+    DATALOG_Init();
+}
+
+void TestDatalogIndex(CuTest *t)
+{
+    struct datalog saved = Model.datalog;
+    FILE *f = fopen("datalog.bin", "w");
+    for (int i = 0; i < 4096; i++)
+        fputc(0, f);
+    fclose(f);
+    fh = NULL;
+    memset(&Model.datalog, 0, sizeof(Model.datalog));
+    DATALOG_ApplyMask(DLOG_TIMERS, 1);
+    DATALOG_Init();
+    CuAssertPtrNotNull(t, fh);
+    CuAssertIntEquals(t, 4096 - INDEX_SIZE, dlog_size);
+    CuAssertIntEquals(t, INDEX_MAGIC, dindex.magic);
+
+    //Three sessions, each flushed separately
+    for (int i = 0; i < 3; i++) {
+        _write_header();
+        for (int j = 0; j <= i; j++)
+            DATALOG_Write();
+        DATALOG_Flush();
+    }
+    u32 end = dlog_pos;
+    u32 seq = dindex.seq;
+    restart();
+    CuAssertIntEquals(t, end, dlog_pos);
+    CuAssertIntEquals(t, seq, dindex.seq);
+    CuAssertIntEquals(t, 3, dindex.num_sessions);
+    CuAssertIntEquals(t, DATALOG_HEADER_SIZE + 1 + data_size, dindex.session[1]);
+
+    //A torn index write falls back to the other copy and scans the last session
+    _write_header();
+    DATALOG_Write();
+    DATALOG_Flush();
+    end = dlog_pos;
+    u8 junk[4] = {0x55, 0x55, 0x55, 0x55};
+    fseek(fh, dlog_size + (dindex.seq & 1) * sizeof(dindex) + 8, SEEK_SET);
+    fwrite(junk, sizeof(junk), 1, fh);
+    restart();
+    CuAssertIntEquals(t, end, dlog_pos);
+    CuAssertIntEquals(t, 4, dindex.num_sessions);
+
+    //Without an index the whole log is scanned
+    u8 zero[INDEX_SIZE] = {0};
+    fseek(fh, dlog_size, SEEK_SET);
+    fwrite(zero, sizeof(zero), 1, fh);
+    restart();
+    CuAssertIntEquals(t, end, dlog_pos);
+    CuAssertIntEquals(t, 4, dindex.num_sessions);
+    CuAssertIntEquals(t, INDEX_MAGIC, dindex.magic);
+
+    fclose(fh);
+    fh = NULL;
+    Model.datalog = saved;
+    remove("datalog.bin");
+}
@@ -0,0 +1,54 @@
+#include "CuTest.h"
+#include "config/tx.h"
+#include "target/drivers/rf/emu/emu_rf.h"
+
+void TestDsm2Telemetry(CuTest *t)
+{
+    // TM1000 flight log: fades A/B/L/R, frame loss, holds and receiver volts
+    const u8 flog[16] = {0x7f, 0x00, 0x00, 0x05, 0x00, 0x06, 0x00, 0x07, 0x00, 0x08,
+                         0x00, 0x20, 0x00, 0x01, 0x02, 0x1c};
+    struct mcu_pin saved = Transmitter.module_enable[CYRF6936];
+    Transmitter.module_enable[CYRF6936] = (struct mcu_pin){0xBBBBBBBB, 1 << 12};
+    Model.protocol = PROTOCOL_DSM2;
+    Model.num_channels = 7;
+    Model.fixed_id = 0;
+    memset(Model.proto_opts, 0, sizeof(Model.proto_opts));
+    Model.proto_opts[PROTOOPTS_TELEMETRY] = TELEM_ON;
+    memset(&Telemetry, 0, sizeof(Telemetry));
+
+    DSM2_Cmds(PROTOCMD_INIT);
+    EMURF_ClearLog();
+    CuAssertIntEquals(t, 1, EMURF_Inject(CYRF6936, flog, sizeof(flog)));
+
+    // Channel select, then write and check on both channels
+    while (state != DSM2_CH2_READ_A)
+        dsm2_cb();
+    CuAssertIntEquals(t, 2, EMURF_LogCount());
+    const struct EmuRFPacket *pkt = EMURF_LogPacket(0);
+    CuAssertIntEquals(t, channels[0], pkt->channel);
+    CuAssertIntEquals(t, 16, pkt->len);
+    CuAssertIntEquals(t, 0xff ^ cyrfmfg_id[2], pkt->data[0]);
+    CuAssertIntEquals(t, 0xff ^ cyrfmfg_id[3], pkt->data[1]);
+    CuAssertIntEquals(t, channels[1], EMURF_LogPacket(1)->channel);
+
+    // The telemetry packet is read after the second write
+    dsm2_cb();
+    CuAssertIntEquals(t, 5, Telemetry.value[TELEM_DSM_FLOG_FADESA]);
+    CuAssertIntEquals(t, 6, Telemetry.value[TELEM_DSM_FLOG_FADESB]);
+    CuAssertIntEquals(t, 7, Telemetry.value[TELEM_DSM_FLOG_FADESL]);
+    CuAssertIntEquals(t, 8, Telemetry.value[TELEM_DSM_FLOG_FADESR]);
+    CuAssertIntEquals(t, 32, Telemetry.value[TELEM_DSM_FLOG_FRAMELOSS]);
+    CuAssertIntEquals(t, 1, Telemetry.value[TELEM_DSM_FLOG_HOLDS]);
+    CuAssertIntEquals(t, 0x021c, Telemetry.value[TELEM_DSM_FLOG_VOLT1]);
+    CuAssertTrue(t, TELEMETRY_IsUpdated(TELEM_DSM_FLOG_VOLT1));
+
+    // With fewer than 8 channels there is a second read, which finds no packet
+    Telemetry.value[TELEM_DSM_FLOG_HOLDS] = 0;
+    CuAssertIntEquals(t, DSM2_CH2_READ_B, state);
+    dsm2_cb();
+    CuAssertIntEquals(t, 0, Telemetry.value[TELEM_DSM_FLOG_HOLDS]);
+    CuAssertIntEquals(t, DSM2_CH1_WRITE_A, state);
+
+    DSM2_Cmds(PROTOCMD_DEINIT);
+    Transmitter.module_enable[CYRF6936] = saved;
+}
@@ -0,0 +1,110 @@
+#include "CuTest.h"
+#include "protocol/interface.h"
+
+static const struct mcu_pin test_pins[TX_MODULE_LAST] = {
+    [A7105]    = {0xAAAAAAAA, 1 << 3},
+    [CC2500]   = {0xAAAAAAAA, 1 << 4},
+    [NRF24L01] = {0xAAAAAAAA, 1 << 5},
+};
+
+static void enable_module(enum Radio module, struct mcu_pin *saved)
+{
+    *saved = Transmitter.module_enable[module];
+    Transmitter.module_enable[module] = test_pins[module];
+    EMURF_Reset(module);
+    EMURF_ClearLog();
+}
+
+void TestEmuRFCC2500(CuTest *t)
+{
+    struct mcu_pin saved;
+    u8 tx[5] = {0x05, 0x11, 0x22, 0x33, 0x44};
+    u8 rx[8];
+    enable_module(CC2500, &saved);
+
+    CC2500_WriteReg(CC2500_0A_CHANNR, 42);
+    CC2500_WriteData(tx, sizeof(tx));
+    CuAssertIntEquals(t, 1, EMURF_LogCount());
+    const struct EmuRFPacket *pkt = EMURF_LogPacket(0);
+    CuAssertIntEquals(t, CC2500, pkt->module);
+    CuAssertIntEquals(t, 42, pkt->channel);
+    CuAssertIntEquals(t, sizeof(tx), pkt->len);
+    CuAssertTrue(t, memcmp(tx, pkt->data, sizeof(tx)) == 0);
+
+    // The status bytes are appended to received packets
+    CuAssertIntEquals(t, 0, CC2500_ReadReg(CC2500_3B_RXBYTES));
+    CuAssertIntEquals(t, 1, EMURF_Inject(CC2500, tx, sizeof(tx)));
+    CC2500_Strobe(CC2500_SRX);
+    CuAssertIntEquals(t, sizeof(tx) + 2, CC2500_ReadReg(CC2500_3B_RXBYTES));
+    CC2500_ReadData(rx, sizeof(tx) + 2);
+    CuAssertTrue(t, memcmp(tx, rx, sizeof(tx)) == 0);
+    CuAssertIntEquals(t, 0x80, rx[sizeof(tx) + 1] & 0x80);
+    CuAssertIntEquals(t, 0, CC2500_ReadReg(CC2500_3B_RXBYTES));
+
+    Transmitter.module_enable[CC2500] = saved;
+}
+
+void TestEmuRFNRF24L01(CuTest *t)
+{
+    struct mcu_pin saved;
+    const u8 addr[5] = {0x01, 0x02, 0x03, 0x04, 0x05};
+    u8 tx[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    u8 rx[8];
+    enable_module(NRF24L01, &saved);
+
+    NRF24L01_WriteReg(NRF24L01_05_RF_CH, 10);
+    NRF24L01_WriteRegisterMulti(NRF24L01_10_TX_ADDR, addr, sizeof(addr));
+    NRF24L01_WriteReg(NRF24L01_00_CONFIG, (1 << NRF24L01_00_EN_CRC) | (1 << NRF24L01_00_PWR_UP));
+    NRF24L01_WritePayload(tx, sizeof(tx));
+    CuAssertIntEquals(t, 1, EMURF_LogCount());
+    const struct EmuRFPacket *pkt = EMURF_LogPacket(0);
+    CuAssertIntEquals(t, 10, pkt->channel);
+    CuAssertIntEquals(t, 5, pkt->id_len);
+    CuAssertTrue(t, memcmp(addr, pkt->id, sizeof(addr)) == 0);
+    CuAssertTrue(t, memcmp(tx, pkt->data, sizeof(tx)) == 0);
+    CuAssertIntEquals(t, 1 << NRF24L01_07_TX_DS, NRF24L01_ReadReg(NRF24L01_07_STATUS) & 0x70);
+    NRF24L01_WriteReg(NRF24L01_07_STATUS, 0x70);
+    CuAssertIntEquals(t, 0, NRF24L01_ReadReg(NRF24L01_07_STATUS) & 0x70);
+
+    // Packets are received once the chip is in RX mode
+    CuAssertIntEquals(t, 1, EMURF_Inject(NRF24L01, tx, sizeof(tx)));
+    NRF24L01_WriteReg(NRF24L01_00_CONFIG, (1 << NRF24L01_00_EN_CRC) | (1 << NRF24L01_00_PWR_UP)
+                                          | (1 << NRF24L01_00_PRIM_RX));
+    CuAssertIntEquals(t, 1 << NRF24L01_07_RX_DR, NRF24L01_ReadReg(NRF24L01_07_STATUS) & 0x7e);
+    CuAssertIntEquals(t, 0, NRF24L01_ReadReg(NRF24L01_17_FIFO_STATUS) & (1 << NRF24L01_17_RX_EMPTY));
+    NRF24L01_ReadPayload(rx, sizeof(rx));
+    CuAssertTrue(t, memcmp(tx, rx, sizeof(tx)) == 0);
+    CuAssertIntEquals(t, 1 << NRF24L01_17_RX_EMPTY, NRF24L01_ReadReg(NRF24L01_17_FIFO_STATUS) & (1 << NRF24L01_17_RX_EMPTY));
+
+    Transmitter.module_enable[NRF24L01] = saved;
+}
+
+void TestEmuRFA7105(CuTest *t)
+{
+    struct mcu_pin saved;
+    u8 tx[16] = {0x55, 0xaa};
+    u8 rx[16];
+    enable_module(A7105, &saved);
+
+    A7105_WriteID(0x5475c52a);
+    A7105_WriteReg(A7105_03_FIFOI, 0x0f);
+    A7105_WriteReg(A7105_0F_CHANNEL, 0x46);
+    A7105_WriteData(tx, sizeof(tx), 0x46);
+    CuAssertIntEquals(t, 1, EMURF_LogCount());
+    const struct EmuRFPacket *pkt = EMURF_LogPacket(0);
+    CuAssertIntEquals(t, 0x46, pkt->channel);
+    CuAssertIntEquals(t, 16, pkt->len);
+    CuAssertIntEquals(t, 0x54, pkt->id[0]);
+    CuAssertIntEquals(t, 0x2a, pkt->id[3]);
+
+    // TRER stays set until a packet is received
+    A7105_Strobe(A7105_RX);
+    CuAssertIntEquals(t, 1, A7105_ReadReg(A7105_00_MODE) & 0x01);
+    CuAssertIntEquals(t, 1, EMURF_Inject(A7105, tx, sizeof(tx)));
+    A7105_Strobe(A7105_RX);
+    CuAssertIntEquals(t, 0, A7105_ReadReg(A7105_00_MODE) & 0x01);
+    A7105_ReadData(rx, sizeof(rx));
+    CuAssertTrue(t, memcmp(tx, rx, sizeof(tx)) == 0);
+
+    Transmitter.module_enable[A7105] = saved;
+}
@@ -0,0 +1,68 @@
+#include "CuTest.h"
+
+void TestFontGlyphCache(CuTest *t)
+{
+    u8 direct[CHAR_BUF_SIZE], cached[CHAR_BUF_SIZE];
+    u8 width, cached_width, size;
+
+    CuAssertTrue(t, open_font("15normal"));
+    u8 height = get_height();
+    read_glyph(direct, 'A', &width, &size);
+    CuAssertTrue(t, width > 0);
+    char_read(cached, 'A', &cached_width);
+    CuAssertIntEquals(t, width, cached_width);
+    CuAssertTrue(t, memcmp(direct, cached, size) == 0);
+
+#if FONT_CACHE_SIZE
+    // Cached glyphs and fonts are used without the font file
+    CuAssertTrue(t, open_font("10normal"));
+    CuAssertTrue(t, get_width('A') > 0);
+    close_font();
+    CuAssertTrue(t, open_font("15normal"));
+    CuAssertIntEquals(t, height, get_height());
+    memset(cached, 0, sizeof(cached));
+    char_read(cached, 'A', &cached_width);
+    CuAssertPtrEquals(t, NULL, font_fh);
+    CuAssertIntEquals(t, width, cached_width);
+    CuAssertTrue(t, memcmp(direct, cached, size) == 0);
+
+    // A miss reopens the file of the current font
+    CuAssertTrue(t, get_width('B') > 0);
+    CuAssertTrue(t, font_fh != NULL);
+    CuAssertPtrEquals(t, font, font_fh_def);
+
+    // Touching more glyphs than fit evicts 'A', the least recently used
+    u32 c = 0x20;
+    for (int i = 0; i <= FONT_CACHE_SIZE; i++) {
+        if (++c == 'A')
+            c++;
+        CuAssertTrue(t, get_width(c) > 0);
+    }
+    CuAssertTrue(t, c < 0x7f);
+    fclose(font_fh);
+    font_fh = NULL;
+    font_fh_def = NULL;
+    CuAssertTrue(t, get_width(c) > 0);
+    CuAssertPtrEquals(t, NULL, font_fh);
+    memset(cached, 0, sizeof(cached));
+    char_read(cached, 'A', &cached_width);
+    CuAssertTrue(t, font_fh != NULL);
+    CuAssertIntEquals(t, width, cached_width);
+    CuAssertTrue(t, memcmp(direct, cached, size) == 0);
+
+    // Flushing drops every cached font and glyph but keeps the current font
+    FONT_Flush();
+    for (int i = 0; i < FONT_CACHE_SIZE; i++)
+        CuAssertIntEquals(t, 0, glyphs[i].font);
+    for (int i = 1; i < NUM_FONT_DEFS; i++)
+        CuAssertIntEquals(t, 0, fonts[i].name[0]);
+    CuAssertPtrEquals(t, &fonts[0], font);
+    CuAssertStrEquals(t, "15normal", font->name);
+    CuAssertIntEquals(t, height, get_height());
+    memset(cached, 0, sizeof(cached));
+    char_read(cached, 'A', &cached_width);
+    CuAssertIntEquals(t, width, cached_width);
+    CuAssertTrue(t, memcmp(direct, cached, size) == 0);
+#endif
+    LCD_SetFont(0);  //Make the next LCD_SetFont() reopen its font
+}
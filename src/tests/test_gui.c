@@ -23,3 +23,80 @@ void TestLabel(CuTest* t)
     GUI_DrawObject(&label);
     AssertScreenshot(t, "label");
 }
+
+#if BACKGROUND_CACHE_SIZE
+static int bg_region_matches(struct bg_region *r)
+{
+    static u16 buf[BG_POOL_SIZE];
+    if (! LCD_ReadWindowedImageFromFile("media/backgrnd" IMG_EXT, buf, r->w, r->h, r->x, r->y))
+        return 0;
+    return memcmp(buf, r->data, r->w * r->h * sizeof(u16)) == 0;
+}
+
+void TestGuiBackgroundCache(CuTest *t)
+{
+    u16 drawn = Display.background.drawn_background;
+    Display.background.drawn_background = 0;
+
+    _gui_draw_background(10, 40, 60, 16);
+    struct bg_region *r = bg_find(10, 40, 60, 16);
+    CuAssertPtrNotNull(t, r);
+    CuAssertTrue(t, bg_region_matches(r));
+    // Regions inside a cached one are served from it
+    CuAssertPtrEquals(t, r, bg_find(20, 44, 30, 8));
+    CuAssertPtrEquals(t, NULL, bg_find(20, 44, 60, 8));
+    // Full screen redraws are not cached
+    _gui_draw_background(0, 0, LCD_WIDTH, LCD_HEIGHT);
+    CuAssertPtrEquals(t, NULL, bg_find(0, 0, LCD_WIDTH, LCD_HEIGHT));
+
+    // Evicting regions keeps the remaining ones intact
+    for (int i = 0; i < 3 * BG_REGIONS; i++)
+        _gui_draw_background(5 * i, 50 + 3 * i, 20 + 7 * (i % 5), 8 + (i % 3));
+    CuAssertTrue(t, bg_used <= BG_POOL_SIZE);
+    unsigned used = 0;
+    for (int i = 0; i < BG_REGIONS; i++) {
+        if (! bg_regions[i].data)
+            continue;
+        used += bg_regions[i].w * bg_regions[i].h;
+        CuAssertTrue(t, bg_region_matches(&bg_regions[i]));
+    }
+    CuAssertIntEquals(t, bg_used, used);
+    // The most recent region is still cached
+    int last = 3 * BG_REGIONS - 1;
+    CuAssertPtrNotNull(t, bg_find(5 * last, 50 + 3 * last, 20 + 7 * (last % 5), 8 + (last % 3)));
+
+    // Flushing drops every region
+    GUI_FlushBackground();
+    CuAssertIntEquals(t, 0, bg_used);
+    for (int i = 0; i < BG_REGIONS; i++)
+        CuAssertPtrEquals(t, NULL, bg_regions[i].data);
+    CuAssertPtrEquals(t, NULL, bg_find(5 * last, 50 + 3 * last, 20 + 7 * (last % 5), 8 + (last % 3)));
+
+    Display.background.drawn_background = drawn;
+}
+#endif
+
+void TestGuiDirtyRects(CuTest *t)
+{
+    dirty_rect_count = 0;
+    // Side by side boxes of the same height become one
+    queue_background(0, 0, 10, 10);
+    queue_background(10, 0, 10, 10);
+    CuAssertIntEquals(t, 1, dirty_rect_count);
+    CuAssertIntEquals(t, 20, dirty_rects[0].width);
+    // Boxes whose union is not a rectangle are kept apart
+    queue_background(5, 5, 20, 20);
+    CuAssertIntEquals(t, 2, dirty_rect_count);
+    // Contained boxes are dropped
+    queue_background(2, 2, 5, 5);
+    CuAssertIntEquals(t, 2, dirty_rect_count);
+    // Stacked boxes of the same width merge, which then contains the other box
+    queue_background(0, 10, 20, 15);
+    queue_background(0, 25, 25, 5);
+    CuAssertIntEquals(t, 3, dirty_rect_count);
+    queue_background(0, 0, 30, 30);
+    CuAssertIntEquals(t, 1, dirty_rect_count);
+    CuAssertIntEquals(t, 30, dirty_rects[0].width);
+    CuAssertIntEquals(t, 30, dirty_rects[0].height);
+    dirty_rect_count = 0;
+}
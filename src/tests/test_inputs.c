@@ -0,0 +1,113 @@
+#include "CuTest.h"
+
+static int pop_event(struct InputEvent *event)
+{
+    if (event_tail == event_head)
+        return 0;
+    *event = events[event_tail];
+    event_tail = (event_tail + 1) & EVENT_MASK;
+    return 1;
+}
+
+void TestInputEvents(CuTest *t)
+{
+    s32 raw[NUM_SOURCES + 1] = {0};
+    struct InputEvent event = {0};
+    const int sw = INP_HAS_CALIBRATION + 1;
+
+    event_head = event_tail = 0;
+    memset(last_analogs, 0, sizeof(last_analogs));
+    last_switches = 0;
+    for (int i = sw; i <= NUM_INPUTS; i++)
+        raw[i] = CHAN_MIN_VALUE;
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, 0, pop_event(&event));
+
+    //Sticks report moves larger than the threshold
+    raw[1] = CHAN_MAX_VALUE;
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, 1, pop_event(&event));
+    CuAssertIntEquals(t, 1, event.input);
+    CuAssertIntEquals(t, INPUT_EVENT_INCREASE, event.type);
+    CuAssertIntEquals(t, CHAN_MAX_VALUE, event.value);
+    CuAssertIntEquals(t, 0, pop_event(&event));
+    raw[1] = CHAN_MAX_VALUE - ANALOG_THRESHOLD * 128;
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, 0, pop_event(&event));
+    raw[1] = 0;
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, 1, pop_event(&event));
+    CuAssertIntEquals(t, INPUT_EVENT_DECREASE, event.type);
+
+    //Switches report both edges
+    raw[sw] = CHAN_MAX_VALUE;
+    INPUT_QueueChanges(raw);
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, 1, pop_event(&event));
+    CuAssertIntEquals(t, sw, event.input);
+    CuAssertIntEquals(t, INPUT_EVENT_ON, event.type);
+    CuAssertIntEquals(t, 0, pop_event(&event));
+    raw[sw] = CHAN_MIN_VALUE;
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, 1, pop_event(&event));
+    CuAssertIntEquals(t, INPUT_EVENT_OFF, event.type);
+
+    //Changes are kept until there is room in the queue
+    for (int i = 0; i < INPUT_EVENT_QUEUE; i++) {
+        raw[sw] = i & 1 ? CHAN_MIN_VALUE : CHAN_MAX_VALUE;
+        INPUT_QueueChanges(raw);
+    }
+    raw[2] = CHAN_MIN_VALUE;
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, EVENT_MASK, (event_head - event_tail) & EVENT_MASK);
+    INPUT_CheckChanges();
+    CuAssertIntEquals(t, event_head, event_tail);
+    INPUT_QueueChanges(raw);
+    CuAssertIntEquals(t, 1, pop_event(&event));
+    CuAssertIntEquals(t, 2, event.input);
+    CuAssertIntEquals(t, INPUT_EVENT_DECREASE, event.type);
+    //The last switch edge did not fit either
+    CuAssertIntEquals(t, 1, pop_event(&event));
+    CuAssertIntEquals(t, sw, event.input);
+    CuAssertIntEquals(t, INPUT_EVENT_OFF, event.type);
+    CuAssertIntEquals(t, 0, pop_event(&event));
+}
+
+static void count_event(const struct InputEvent *event, void *data)
+{
+    int *count = data;
+    count[event->type]++;
+}
+
+void TestInputHandlers(CuTest *t)
+{
+    s32 raw[NUM_SOURCES + 1] = {0};
+    struct InputHandler edges = {0}, moves = {0};
+    int edge_count[4] = {0}, move_count[4] = {0};
+    const int sw = INP_HAS_CALIBRATION + 1;
+
+    event_head = event_tail = 0;
+    memset(last_analogs, 0, sizeof(last_analogs));
+    last_switches = 0;
+    INPUT_RegisterHandler(&edges, (1 << INPUT_EVENT_ON) | (1 << INPUT_EVENT_OFF), count_event, edge_count);
+    INPUT_RegisterHandler(&moves, (1 << INPUT_EVENT_INCREASE) | (1 << INPUT_EVENT_DECREASE), count_event, move_count);
+    //Registering twice does not duplicate the handler
+    INPUT_RegisterHandler(&edges, (1 << INPUT_EVENT_ON) | (1 << INPUT_EVENT_OFF), count_event, edge_count);
+
+    //Handlers only see the event types they asked for
+    raw[1] = CHAN_MAX_VALUE;
+    raw[sw] = CHAN_MAX_VALUE;
+    INPUT_QueueChanges(raw);
+    INPUT_CheckChanges();
+    CuAssertIntEquals(t, 1, edge_count[INPUT_EVENT_ON]);
+    CuAssertIntEquals(t, 0, edge_count[INPUT_EVENT_INCREASE]);
+    CuAssertIntEquals(t, 1, move_count[INPUT_EVENT_INCREASE]);
+    CuAssertIntEquals(t, 0, move_count[INPUT_EVENT_ON]);
+
+    INPUT_UnregisterHandler(&edges);
+    raw[sw] = CHAN_MIN_VALUE;
+    INPUT_QueueChanges(raw);
+    INPUT_CheckChanges();
+    CuAssertIntEquals(t, 0, edge_count[INPUT_EVENT_OFF]);
+    INPUT_UnregisterHandler(&moves);
+}
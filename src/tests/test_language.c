@@ -43,3 +43,93 @@ void TestV1Language(CuTest *t)
     CuAssertStrEquals(t, "ko", _tr("ok"));
     CuAssertStrEquals(t, "ok1", _tr("ok1"));
 }
+
+static void write_v3(const char *name, const char *key[], const char *value[], int count)
+{
+    u16 hash[8];
+    int order[8];
+    u16 pos = 5 + 4 + 4 * count;  // "Test\n", header, table
+    FILE *fh = fopen(name, "wb");
+    fprintf(fh, "Test\n");
+    fputc(0, fh);
+    fputc(3, fh);
+    fputc(count, fh);
+    fputc(0, fh);
+    for (int i = 0; i < count; i++) {
+        hash[i] = fnv_16_str(key[i]);
+        int j = i;
+        for (; j > 0 && hash[order[j - 1]] > hash[i]; j--)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+    for (int i = 0; i < count; i++) {
+        u16 len = 0;
+        for (int j = 0; j < order[i]; j++)
+            len += strlen(value[j]) + 1;
+        u8 entry[4] = {hash[order[i]] & 0xff, hash[order[i]] >> 8,
+                       (pos + len) & 0xff, (pos + len) >> 8};
+        fwrite(entry, 4, 1, fh);
+    }
+    for (int i = 0; i < count; i++)
+        fwrite(value[i], strlen(value[i]) + 1, 1, fh);
+    fclose(fh);
+}
+
+void TestV3Language(CuTest *t)
+{
+    const char name[] = "language/lang.tst";
+    const char *key[] = {"test", "ok", "Two\nlines"};
+    const char *value[] = {"abcd", "ko", "Zwei\nZeilen"};
+    write_v3(name, key, value, 3);
+
+    ReadLang(name);
+    CuAssertIntEquals(t, 3, table_size);
+    CuAssertTrue(t, lookupmap[0].hash < lookupmap[1].hash);
+    CuAssertTrue(t, lookupmap[1].hash < lookupmap[2].hash);
+    CuAssertStrEquals(t, "abcd", _tr("test"));
+    CuAssertStrEquals(t, "ko", _tr("ok"));
+    CuAssertStrEquals(t, "Zwei\nZeilen", _tr("Two\nlines"));
+    CuAssertStrEquals(t, "ok1", _tr("ok1"));
+    remove(name);
+}
+
+void TestTranslationCallsite(CuTest *t)
+{
+    const char name[] = "language/lang.tst";
+    const char *key[] = {"test", "ok"};
+    const char *value[] = {"abcd", "ko"};
+    const char *value2[] = {"efgh", "nein"};
+    char buf[10] = "test";
+    write_v3(name, key, value, 2);
+    ReadLang(name);
+
+    //Literals are looked up once and then found by address
+    const char *lit = "test";
+    CuAssertStrEquals(t, "abcd", _tr_const(lit));
+    uintptr_t addr = (uintptr_t)lit;
+    struct tr_callsite *site = &callsites[(addr ^ (addr >> 7)) & (TR_CALLSITE_CACHE - 1)];
+    CuAssertPtrEquals(t, (void *)lit, (void *)site->str);
+    site->idx = FindString(fnv_16_str("ok"));
+    CuAssertStrEquals(t, "ko", _tr_const(lit));
+    CuAssertStrEquals(t, "ok1", _tr("ok1"));
+    CuAssertStrEquals(t, "ok1", _tr("ok1"));
+
+    //Other strings are hashed on every call
+    CuAssertStrEquals(t, "abcd", _tr(buf));
+    strcpy(buf, "ok");
+    CuAssertStrEquals(t, "ko", _tr(buf));
+
+    //Loading a language forgets the call sites
+    write_v3(name, key, value2, 2);
+    ReadLang(name);
+    CuAssertStrEquals(t, "efgh", _tr("test"));
+    CuAssertStrEquals(t, "nein", _tr("ok"));
+
+    //Disabled languages return the original string
+    CONFIG_EnableLanguage(0);
+    CuAssertStrEquals(t, "test", _tr("test"));
+    CONFIG_EnableLanguage(1);
+    CuAssertStrEquals(t, "efgh", _tr("test"));
+    remove(name);
+    CONFIG_ReadLang(0);
+}
@@ -156,6 +156,7 @@ void TestCalcChannels(CuTest *t)
     Model.templates[5] = MIXERTEMPLATE_CYC1;
     Model.templates[6] = MIXERTEMPLATE_CYC2;
     Model.templates[7] = MIXERTEMPLATE_CYC3;
+    MIXER_CompileMixers();
     MIXER_CalcChannels();
     s32 expected[NUM_OUT_CHANNELS] = {0, 0, 0, 0, 0, 1000, 800, 600, 0, 0, 0, 0, 0, 0, 0, 0};
     for (int i = 0; i < NUM_OUT_CHANNELS; i++) {
@@ -163,6 +164,83 @@ void TestCalcChannels(CuTest *t)
     }
 }
 
+void TestCompileMixers(CuTest *t)
+{
+    s32 expected[NUM_SOURCES + 1];
+    s32 rawdata[NUM_SOURCES + 1];
+    memset(&Model, 0, sizeof(Model));
+    Transmitter.mode = MODE_2;
+    Model.trims[0] = (struct Trim){ .src = INP_THROTTLE, .step = 10, .value = {5} };
+    Model.trims[1] = (struct Trim){ .src = INP_AILERON, .step = 10, .value = {-20} };
+    for (unsigned i = 0; i < NUM_SOURCES + 1; i++)
+        rawdata[i] = (i * 731) % 20000 - 10000;
+    struct Mixer mixers[] = {
+        { .src = INP_ELEVATOR, .dest = 0, .scalar = 100, .flags = MUX_REPLACE | 0x10 },
+        { .src = 0x80 | INP_AILERON, .dest = 0, .sw = INP_GEAR1, .scalar = 50, .flags = MUX_ADD | 0x10 },
+        { .src = INP_RUDDER, .dest = 1, .sw = 0x80 | INP_GEAR1, .scalar = 75, .offset = 10, .flags = MUX_MULTIPLY },
+        { .src = NUM_INPUTS + 1, .dest = 2, .scalar = 100, .flags = MUX_MAX },
+        { .src = INP_AILERON, .dest = 2, .scalar = -100, .flags = MUX_MIN | 0x10 },
+    };
+    CURVE_SET_TYPE(&mixers[0].curve, CURVE_EXPO);
+    mixers[0].curve.points[0] = 40;
+    mixers[0].curve.points[1] = 40;
+    memcpy(Model.mixers, mixers, sizeof(mixers));
+    MIXER_CompileMixers();
+    CuAssertIntEquals(t, sizeof(mixers) / sizeof(mixers[0]), program.count);
+    CuAssertIntEquals(t, 0, program.op[0].trim);
+    CuAssertIntEquals(t, 1, program.op[1].trim);
+    CuAssertIntEquals(t, -1, program.op[2].trim);
+
+    for (int gear = 0; gear < 2; gear++) {
+        rawdata[INP_GEAR1] = gear ? CHAN_MAX_VALUE : CHAN_MIN_VALUE;
+        memcpy(expected, rawdata, sizeof(rawdata));
+        MIXER_EvalMixers(expected);
+        MIXER_RunProgram(rawdata);
+        for (unsigned i = 0; i < NUM_SOURCES + 1; i++)
+            CuAssertIntEquals(t, expected[i], rawdata[i]);
+    }
+}
+
+void TestCompileAutoMappedModel(CuTest *t)
+{
+    // Channels are stored in EATR order and moved to the DSM2 (TAER) order on load
+    FILE *fh = fopen("models/model3.ini", "w");
+    CuAssertTrue(t, fh != NULL);
+    fprintf(fh, "name=AutoMap\nmixermode=Advanced\nautomap=1\n"
+                "[radio]\nprotocol=DSM2\nnum_channels=4\n"
+                "[channel1]\ntemplate=simple\n[mixer]\nsrc=ELE\ndest=CH1\n"
+                "[channel2]\ntemplate=simple\n[mixer]\nsrc=AIL\ndest=CH2\n"
+                "[channel3]\ntemplate=simple\n[mixer]\nsrc=THR\ndest=CH3\n"
+                "[channel4]\ntemplate=simple\n[mixer]\nsrc=RUD\ndest=CH4\n");
+    fclose(fh);
+
+    struct Model saved;
+    u8 current_model = Transmitter.current_model;
+    struct mcu_pin module = Transmitter.module_enable[CYRF6936];
+    memcpy(&saved, &Model, sizeof(Model));
+    Transmitter.module_enable[CYRF6936] = (struct mcu_pin){0xBBBBBBBB, 1 << 12};
+    // The second load comes from the model cache
+    for (int load = 0; load < 2; load++) {
+        s32 rawdata[NUM_SOURCES + 1] = {0};
+        rawdata[INP_THROTTLE] = 4000;
+        rawdata[INP_AILERON] = -2000;
+        rawdata[INP_ELEVATOR] = 6000;
+        rawdata[INP_RUDDER] = -8000;
+        CONFIG_ReadModel(3);
+        MIXER_RunProgram(rawdata);
+        CuAssertIntEquals(t, 4000, rawdata[NUM_INPUTS + 1]);
+        CuAssertIntEquals(t, -2000, rawdata[NUM_INPUTS + 2]);
+        CuAssertIntEquals(t, 6000, rawdata[NUM_INPUTS + 3]);
+        CuAssertIntEquals(t, -8000, rawdata[NUM_INPUTS + 4]);
+    }
+    remove("models/model3.ini");
+    memcpy(&Model, &saved, sizeof(Model));
+    PROTOCOL_Load(1);
+    MIXER_CompileMixers();
+    Transmitter.module_enable[CYRF6936] = module;
+    Transmitter.current_model = current_model;
+}
+
 void TestGetInputs(CuTest *t)
 {
     CuAssertPtrEquals(t, (void *)raw, (void *)MIXER_GetInputs());
@@ -38,3 +38,116 @@ void TestModelChange(CuTest *t)
 
     CuAssertTrue(t, CONFIG_IsModelChanged());
 }
+
+void TestModelChangeScan(CuTest *t)
+{
+    CONFIG_ReadModel(1);
+    CuAssertTrue(t, ! CONFIG_IsModelChanged());
+    for (unsigned i = 0; i < sizeof(Model); i++)
+        CuAssertTrue(t, ! CONFIG_ScanModelChanges());
+
+    // A change near the end of the model is found by scanning
+    Model.limits[NUM_OUT_CHANNELS - 1].failsafe += 1;
+    unsigned scans = 0;
+    while (! CONFIG_ScanModelChanges() && scans < sizeof(Model))
+        scans++;
+    CuAssertTrue(t, scans < sizeof(Model));
+    CuAssertTrue(t, CONFIG_IsModelChanged());
+
+    // Reverting the change clears the dirty page
+    Model.limits[NUM_OUT_CHANNELS - 1].failsafe -= 1;
+    CuAssertTrue(t, ! CONFIG_IsModelChanged());
+    CuAssertTrue(t, ! CONFIG_ScanModelChanges());
+}
+
+void TestModelCache(CuTest *t)
+{
+    struct Model ValidateModel;
+    u8 auto_map;
+    char file[] = "models/model1.ini";
+
+    CONFIG_ReadModel(1);  // Parses the ini if the cache is stale and updates the cache
+    CONFIG_WriteModelCache(1, file, 0, 0);
+    memcpy(&ValidateModel, &Model, sizeof(Model));
+    memset(&Model, 0, sizeof(Model));
+    CuAssertTrue(t, CONFIG_ReadModelCache(1, file, &auto_map));
+    CuAssertTrue(t, memcmp(&ValidateModel, &Model, sizeof(Model)) == 0);
+
+    // Changing the ini invalidates the cached copy
+    Model.fixed_id += 1;
+    CONFIG_WriteModel(1);
+    CuAssertTrue(t, ! CONFIG_ReadModelCache(1, file, &auto_map));
+    CONFIG_ReadModel(1);
+    CuAssertIntEquals(t, ValidateModel.fixed_id + 1, Model.fixed_id);
+    CuAssertTrue(t, CONFIG_ReadModelCache(1, file, &auto_map));
+    CuAssertIntEquals(t, ValidateModel.fixed_id + 1, Model.fixed_id);
+
+    // Changing the default layout invalidates models that used it
+    char layout[2048];
+    FILE *fh = fopen("layout/default.ini", "r");
+    CuAssertTrue(t, fh != NULL);
+    size_t len = fread(layout, 1, sizeof(layout), fh);
+    fclose(fh);
+    CuAssertTrue(t, len > 0 && len < sizeof(layout));
+    CONFIG_WriteModelCache(1, file, 0, 1);
+    CuAssertTrue(t, CONFIG_ReadModelCache(1, file, &auto_map));
+    fh = fopen("layout/default.ini", "a");
+    fprintf(fh, "\n");
+    fclose(fh);
+    CuAssertTrue(t, ! CONFIG_ReadModelCache(1, file, &auto_map));
+    fh = fopen("layout/default.ini", "w");
+    fwrite(layout, 1, len, fh);
+    fclose(fh);
+    CuAssertTrue(t, CONFIG_ReadModelCache(1, file, &auto_map));
+}
+
+static int is_sorted(const void *table, unsigned count, unsigned size)
+{
+    for (unsigned i = 1; i < count; i++) {
+        const char *prev = *(const char * const *)((const char *)table + (i - 1) * size);
+        const char *cur  = *(const char * const *)((const char *)table + i * size);
+        if (strcasecmp(prev, cur) >= 0)
+            return 0;
+    }
+    return 1;
+}
+
+void TestModelKeyTables(CuTest *t)
+{
+    #define ASSERT_SORTED(x) CuAssertTrue(t, is_sorted(x, sizeof(x) / sizeof(x[0]), sizeof(x[0])))
+    ASSERT_SORTED(_sections);
+    ASSERT_SORTED(_secradio);
+    ASSERT_SORTED(_secmixer);
+    ASSERT_SORTED(_seclimit);
+    ASSERT_SORTED(_sectrim);
+    ASSERT_SORTED(_secswash);
+    ASSERT_SORTED(_sectimer);
+    ASSERT_SORTED(_secppm);
+    #undef ASSERT_SORTED
+
+    CuAssertIntEquals(t, SEC_NONE, find_section(""));
+    CuAssertIntEquals(t, SEC_MIXER, find_section("mixer"));
+    CuAssertIntEquals(t, SEC_CHANNEL, find_section("Channel12"));
+    CuAssertIntEquals(t, SEC_GUI, find_section("gui-320x240"));
+    CuAssertIntEquals(t, SEC_UNKNOWN, find_section("radio1"));
+    CuAssertIntEquals(t, SEC_UNKNOWN, find_section("chan"));
+}
+
+void TestModelSourceIndex(CuTest *t)
+{
+    struct SourceHash index[SOURCE_INDEX_SIZE];
+    char name[12];
+    CONFIG_EnableLanguage(0);  //Models are parsed with the language disabled
+    source_index = index;
+    source_index_built = 0;
+    for (unsigned i = 0; i <= NUM_SOURCES; i++) {
+        INPUT_SourceNameReal(name, i);
+        CuAssertIntEquals(t, i, get_source("", name));
+        name[0] = name[0] >= 'a' ? name[0] - ('a' - 'A') : name[0] + ('a' - 'A');
+        CuAssertIntEquals(t, i, find_source(name));
+    }
+    CuAssertIntEquals(t, 0x80 | (NUM_INPUTS + 1), get_source("", "!Ch1"));
+    CuAssertIntEquals(t, -1, find_source("NoSuchSource"));
+    source_index = NULL;
+    CONFIG_EnableLanguage(1);
+}
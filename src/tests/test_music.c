@@ -32,3 +32,47 @@ void TestMusic(CuTest *t)
         CuAssertTrue(t, abs(get_freq(i) - note_map[i].note) < 8);
     }
 }
+
+void TestMusicTable(CuTest *t)
+{
+    const struct Note *table;
+    u8 volume = Transmitter.volume;
+    Transmitter.volume = 5;
+    sounds_loaded = 0;
+    CuAssertIntEquals(t, 0, MUSIC_GetSound(MUSIC_STARTUP));
+    CuAssertIntEquals(t, 1, sounds_loaded);
+    CuAssertTrue(t, num_notes > 1);
+    CuAssertIntEquals(t, Transmitter.volume * sounds[MUSIC_STARTUP].volume / 10, Volume);
+
+    //Every sound matches what parsing its section of sound.ini gives
+    for (int music = 0; music < MUSIC_TOTAL; music++) {
+        CuAssertIntEquals(t, 0, MUSIC_GetSound(music));
+        CuAssertTrue(t, ! (sounds[music].flags & SOUND_UNCACHED));
+        table = notes;
+        u8 count = num_notes;
+        u8 table_volume = Volume;
+        num_notes = 0;
+        Volume = Transmitter.volume * 10;
+        CuAssertIntEquals(t, 0, CONFIG_IniParse(sound_file(), ini_handler, (void *)sections[music]));
+        CuAssertIntEquals(t, num_notes, count);
+        CuAssertIntEquals(t, Volume, table_volume);
+        CuAssertTrue(t, memcmp(Notes, table, count * sizeof(struct Note)) == 0);
+    }
+
+    //Sections which do not fit in the table are parsed when played
+    sounds_loaded = 0;
+    MUSIC_GetSound(MUSIC_STARTUP);
+    sounds[MUSIC_ALARM1].flags |= SOUND_UNCACHED;
+    CuAssertIntEquals(t, 0, MUSIC_GetSound(MUSIC_ALARM1));
+    CuAssertPtrEquals(t, Notes, (void *)notes);
+    CuAssertIntEquals(t, sounds[MUSIC_ALARM1].count, num_notes);
+
+    //Reloading re-reads sound.ini and rebuilds the table
+    MUSIC_ReloadSounds();
+    CuAssertIntEquals(t, 0, sounds_loaded);
+    CuAssertIntEquals(t, 0, MUSIC_GetSound(MUSIC_ALARM1));
+    CuAssertIntEquals(t, 1, sounds_loaded);
+    CuAssertTrue(t, ! (sounds[MUSIC_ALARM1].flags & SOUND_UNCACHED));
+    sounds_loaded = 0;
+    Transmitter.volume = volume;
+}
@@ -0,0 +1,62 @@
+#include "CuTest.h"
+
+static void record(enum ProfileSrc src, u16 us)
+{
+    PROFILE_Record(src, CLOCK_getus() - us);
+}
+
+void TestProfileBuckets(CuTest *t)
+{
+    unsigned last = 0;
+    for (u32 us = 0; us <= 0xffff; us++) {
+        unsigned idx = bucket(us);
+        CuAssertTrue(t, idx < PROFILE_BUCKETS);
+        CuAssertTrue(t, idx == last || idx == last + 1);
+        CuAssertTrue(t, us <= bucket_max(idx));
+        CuAssertTrue(t, idx == 0 || us > bucket_max(idx - 1));
+        last = idx;
+    }
+}
+
+void TestProfileStats(CuTest *t)
+{
+    PROFILE_Reset();
+    for (int i = 1; i <= 100; i++) {
+        PROFILE_SetState(i % 2);
+        record(PROFILE_PROTOCOL, i);
+        if (i % 10 == 0)
+            PROFILE_Update();
+    }
+    PROFILE_SetState(0);
+    const struct ProfileStats *s = PROFILE_GetStats(PROFILE_PROTOCOL);
+    CuAssertIntEquals(t, 100, s->count);
+    CuAssertIntEquals(t, 1, s->min);
+    CuAssertIntEquals(t, 100, s->max);
+    CuAssertIntEquals(t, 5050, s->total);
+    unsigned p99 = PROFILE_Percentile(s, 99);
+    CuAssertTrue(t, p99 >= 99 && p99 <= 100);
+    unsigned p50 = PROFILE_Percentile(s, 50);
+    CuAssertTrue(t, p50 >= 50 && p50 <= 50 * 5 / 4);
+    CuAssertIntEquals(t, 50, PROFILE_GetStateStats(0)->count);
+    CuAssertIntEquals(t, 50, PROFILE_GetStateStats(1)->count);
+    CuAssertIntEquals(t, 0, PROFILE_GetStats(PROFILE_MIXER)->count);
+
+    //Samples are dropped when the ring is not drained
+    for (int i = 0; i < 2 * RING_SIZE; i++)
+        record(PROFILE_MIXER, 10);
+    PROFILE_Update();
+    CuAssertIntEquals(t, RING_SIZE - 1, PROFILE_GetStats(PROFILE_MIXER)->count);
+    CuAssertIntEquals(t, RING_SIZE + 1, PROFILE_Dropped());
+
+    //The drop counter wraps without losing counts
+    PROFILE_Reset();
+    rings[PROFILE_MIXER].dropped.count = rings[PROFILE_MIXER].dropped.seen = 0xfff0;
+    for (int i = 0; i < 2 * RING_SIZE; i++)
+        record(PROFILE_MIXER, 10);
+    PROFILE_Update();
+    CuAssertIntEquals(t, RING_SIZE + 1, PROFILE_Dropped());
+
+    PROFILE_Reset();
+    CuAssertIntEquals(t, 0, PROFILE_GetStats(PROFILE_PROTOCOL)->count);
+    CuAssertIntEquals(t, 0, PROFILE_Dropped());
+}
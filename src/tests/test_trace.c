@@ -0,0 +1,128 @@
+#include "CuTest.h"
+
+static FILE *create_trace(int blocks)
+{
+    FILE *f = fopen("trace.bin", "w");
+    for (int i = 0; i < blocks * TRACE_BLOCK_SIZE; i++)
+        fputc(0, f);
+    fclose(f);
+    fh = NULL;
+    TRACE_Init();
+    return fh;
+}
+
+static void close_trace()
+{
+    fclose(fh);
+    fh = NULL;
+    enabled = 0;
+    remove("trace.bin");
+}
+
+static void read_block(int idx, u8 *data)
+{
+    FILE *f = fopen("trace.bin", "rb");
+    fseek(f, idx * TRACE_BLOCK_SIZE, SEEK_SET);
+    fread(data, TRACE_BLOCK_SIZE, 1, f);
+    fclose(f);
+}
+
+void TestTraceEntries(CuTest *t)
+{
+    u8 data[TRACE_BLOCK_SIZE];
+    u8 pkt[16] = {0x10, 0x20, 0x30};
+    Model.num_channels = 4;
+    CuAssertPtrNotNull(t, create_trace(4));
+    CuAssertIntEquals(t, 1, session);
+
+    Channels[0] = -10000;
+    Channels[3] = 5000;
+    TRACE_Channels();
+    TRACE_Packet(TRACE_TX, CYRF6936, pkt, sizeof(pkt));
+    TRACE_Packet(TRACE_RX, CC2500, pkt, 3);
+    next_flush = CLOCK_getms();
+    TRACE_Update();
+
+    read_block(0, data);
+    CuAssertIntEquals(t, 1, data[0] | (data[1] << 8));
+    unsigned pos = 4;
+    CuAssertIntEquals(t, TRACE_START, data[pos]);
+    CuAssertIntEquals(t, 4, data[pos + 1]);
+    CuAssertIntEquals(t, TRACE_VERSION, data[pos + TRACE_ENTRY_HEADER]);
+    CuAssertIntEquals(t, 4, data[pos + TRACE_ENTRY_HEADER + 3]);
+    pos += TRACE_ENTRY_HEADER + 4;
+    //Mixer ring is drained first
+    CuAssertIntEquals(t, TRACE_CHANNELS, data[pos]);
+    CuAssertIntEquals(t, 9, data[pos + 1]);
+    CuAssertIntEquals(t, 4, data[pos + TRACE_ENTRY_HEADER]);
+    CuAssertIntEquals(t, -10000, (s16)(data[pos + 9] | (data[pos + 10] << 8)));
+    CuAssertIntEquals(t, 5000, (s16)(data[pos + 15] | (data[pos + 16] << 8)));
+    pos += TRACE_ENTRY_HEADER + 9;
+    CuAssertIntEquals(t, TRACE_TX, data[pos]);
+    CuAssertIntEquals(t, 17, data[pos + 1]);
+    CuAssertIntEquals(t, CYRF6936, data[pos + TRACE_ENTRY_HEADER]);
+    CuAssertIntEquals(t, 0x20, data[pos + TRACE_ENTRY_HEADER + 2]);
+    pos += TRACE_ENTRY_HEADER + 17;
+    CuAssertIntEquals(t, TRACE_RX, data[pos]);
+    CuAssertIntEquals(t, 4, data[pos + 1]);
+    CuAssertIntEquals(t, CC2500, data[pos + TRACE_ENTRY_HEADER]);
+    pos += TRACE_ENTRY_HEADER + 4;
+    CuAssertIntEquals(t, pos, data[2] | (data[3] << 8));
+
+    //A new session starts on the next power-up
+    TRACE_Init();
+    CuAssertIntEquals(t, 2, session);
+    close_trace();
+}
+
+static int count_entries(const u8 *data, u8 type, unsigned *value)
+{
+    unsigned pos = 4;
+    int count = 0;
+    while (pos < (unsigned)(data[2] | (data[3] << 8))) {
+        if (data[pos] == type) {
+            count++;
+            *value = data[pos + TRACE_ENTRY_HEADER] | (data[pos + TRACE_ENTRY_HEADER + 1] << 8);
+        }
+        pos += TRACE_ENTRY_HEADER + data[pos + 1];
+    }
+    return count;
+}
+
+void TestTraceOverflow(CuTest *t)
+{
+    u8 data[TRACE_BLOCK_SIZE];
+    u8 pkt[32] = {0};
+    unsigned value = 0;
+    Model.num_channels = 8;
+    CuAssertPtrNotNull(t, create_trace(2));
+
+    //Entries are dropped when the ring is full and reported when drained
+    int size = TRACE_ENTRY_HEADER + 1 + sizeof(pkt);
+    int entries = TRACE_RING_SIZE / size;
+    for (int i = 0; i < entries + 5; i++)
+        TRACE_Packet(TRACE_TX, NRF24L01, pkt, sizeof(pkt));
+    TRACE_Update();
+    CuAssertIntEquals(t, 1, enabled);
+    int per_block = (TRACE_BLOCK_SIZE - 4) / size;
+    int first = (TRACE_BLOCK_SIZE - 4 - TRACE_ENTRY_HEADER - 4) / size;  //After TRACE_START
+    read_block(0, data);
+    CuAssertIntEquals(t, first, count_entries(data, TRACE_TX, &value));
+    CuAssertIntEquals(t, 0, count_entries(data, TRACE_DROPPED, &value));
+    next_flush = CLOCK_getms();
+    TRACE_Update();
+    read_block(1, data);
+    CuAssertIntEquals(t, 1, data[0] | (data[1] << 8));
+    CuAssertIntEquals(t, entries - first, count_entries(data, TRACE_TX, &value));
+    CuAssertIntEquals(t, 1, count_entries(data, TRACE_DROPPED, &value));
+    CuAssertIntEquals(t, 5, value);
+
+    //Recording stops when the last block is full
+    for (int i = 0; i < per_block; i++)
+        TRACE_Packet(TRACE_TX, NRF24L01, pkt, sizeof(pkt));
+    TRACE_Update();
+    CuAssertIntEquals(t, 0, enabled);
+    TRACE_Channels();
+    CuAssertIntEquals(t, rings[TRACE_SRC_MIXER].head, rings[TRACE_SRC_MIXER].tail);
+    close_trace();
+}
@@ -0,0 +1,52 @@
+#include "CuTest.h"
+
+// Previous divide based ADC_NormalizeChannel
+static s32 ref_normalize(const struct StickCalibration *cal, int sign, s32 value)
+{
+    s32 max = cal->max;
+    s32 min = cal->min;
+    s32 zero = cal->zero;
+    if (!zero)
+        zero = ((u32)max + min) / 2;
+    max = (max - zero) * 99 / 100;
+    min = (min - zero) * 99 / 100;
+    if (value >= zero)
+        value = (value - zero) * CHAN_MAX_VALUE / max;
+    else
+        value = (value - zero) * CHAN_MIN_VALUE / min;
+    if (value > CHAN_MAX_VALUE)
+        value = CHAN_MAX_VALUE;
+    if (value < CHAN_MIN_VALUE)
+        value = CHAN_MIN_VALUE;
+    return value * sign;
+}
+
+void TestTxCalibration(CuTest *t)
+{
+    const struct StickCalibration cals[] = {
+        {4095, 0, 2048},
+        {3600, 500, 2000},
+        {3000, 1000, 0},     // zero from max/min
+        {2100, 2000, 2050},  // very small range
+        {65535, 0, 32768},
+    };
+    for (unsigned i = 0; i < sizeof(cals) / sizeof(cals[0]); i++) {
+        for (int sign = -1; sign <= 1; sign += 2) {
+            struct CalibCoef coef;
+            CALIB_Build(&coef, &cals[i], sign);
+            for (s32 v = cals[i].min; v <= cals[i].max; v += 7) {
+                s32 diff = CALIB_Apply(&coef, v) - ref_normalize(&cals[i], sign, v);
+                if (diff < -1 || diff > 1)
+                    CuFail(t, "Calibrated value differs by more than 1");
+            }
+            // Ends of the range reach 100%
+            CuAssertIntEquals(t, sign * CHAN_MAX_VALUE, CALIB_Apply(&coef, cals[i].max));
+            CuAssertIntEquals(t, sign * CHAN_MIN_VALUE, CALIB_Apply(&coef, cals[i].min));
+        }
+    }
+    // Uncalibrated input does not divide by zero
+    struct StickCalibration none = {0, 0, 0};
+    struct CalibCoef coef;
+    CALIB_Build(&coef, &none, 1);
+    CuAssertIntEquals(t, 0, CALIB_Apply(&coef, 1234));
+}
@@ -0,0 +1,208 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "config/model.h"
+#include "trace.h"
+
+#include <stdio.h>
+
+#if SUPPORT_TRACE
+#define RING_MASK (TRACE_RING_SIZE - 1)
+#define MAX_PACKET 64       // Longer packets are truncated
+#define FLUSH_MS 1000       // Rewrite a partially filled block this often
+ctassert(((TRACE_RING_SIZE & RING_MASK) == 0), trace_ring_size_not_power_of_2);
+ctassert((TRACE_ENTRY_HEADER + 1 + MAX_PACKET <= TRACE_RING_SIZE / 2), trace_ring_too_small);
+ctassert((2 * NUM_OUT_CHANNELS <= MAX_PACKET), trace_too_many_channels);
+
+/* Like the profiler, each ring has a single producer (its interrupt) and a
+ * single consumer (TRACE_Update), so head is only written by the producer
+ * and tail only by the consumer.  Channels are only recorded when the mixer
+ * runs from its interrupt, not from MIXER_RecalcChannels.  Entries are
+ * stored as in the file */
+struct TraceRing {
+    volatile u16 head;
+    volatile u16 tail;
+    struct IsrCounter dropped;
+    u8 data[TRACE_RING_SIZE];
+};
+
+static struct TraceRing rings[TRACE_SRC_LAST];
+static FSHANDLE TraceFAT;
+static FILE *fh;
+static volatile u8 enabled;
+static u16 session;
+static u32 block_pos;
+static u32 file_size;
+static u32 next_flush;
+static u16 used;
+static u8 block[TRACE_BLOCK_SIZE];
+
+static void ring_put(struct TraceRing *r, u16 pos, const u8 *data, unsigned len)
+{
+    for (unsigned i = 0; i < len; i++)
+        r->data[(pos + i) & RING_MASK] = data[i];
+}
+
+static void record(enum TraceSrc src, enum TraceType type, u8 prefix, const u8 *data, u8 len)
+{
+    struct TraceRing *r = &rings[src];
+    u16 head = r->head;
+    unsigned size = TRACE_ENTRY_HEADER + 1 + len;
+    if (size > RING_MASK - ((head - r->tail) & RING_MASK)) {
+        r->dropped.count++;
+        return;
+    }
+    u16 us = CLOCK_getus();
+    u32 ms = CLOCK_getms();
+    u8 hdr[TRACE_ENTRY_HEADER + 1] = {type, len + 1, us & 0xff, us >> 8,
+                                      ms & 0xff, (ms >> 8) & 0xff, (ms >> 16) & 0xff, ms >> 24,
+                                      prefix};
+    ring_put(r, head, hdr, sizeof(hdr));
+    ring_put(r, head + sizeof(hdr), data, len);
+    COMPILER_BARRIER();  // The entry must be complete before it is published
+    r->head = (head + size) & RING_MASK;
+}
+
+void TRACE_Channels()
+{
+    if (! enabled)
+        return;
+    u8 data[2 * NUM_OUT_CHANNELS];
+    unsigned num_channels = Model.num_channels;
+    for (unsigned i = 0; i < num_channels; i++) {
+        data[2 * i] = Channels[i] & 0xff;
+        data[2 * i + 1] = (Channels[i] >> 8) & 0xff;
+    }
+    record(TRACE_SRC_MIXER, TRACE_CHANNELS, num_channels, data, 2 * num_channels);
+}
+
+void TRACE_Packet(enum TraceType type, u8 module, const u8 *data, u8 len)
+{
+    if (! enabled)
+        return;
+    record(TRACE_SRC_PROTOCOL, type, module, data, len > MAX_PACKET ? MAX_PACKET : len);
+}
+
+static void write_block()
+{
+    block[2] = used & 0xff;
+    block[3] = used >> 8;
+    fseek(fh, block_pos, SEEK_SET);
+    fwrite(block, TRACE_BLOCK_SIZE, 1, fh);
+}
+
+static void next_block()
+{
+    write_block();
+    block_pos += TRACE_BLOCK_SIZE;
+    memset(block + 4, 0, TRACE_BLOCK_SIZE - 4);
+    used = 4;
+    if (block_pos + TRACE_BLOCK_SIZE > file_size) {
+        //The file is full
+        enabled = 0;
+    }
+}
+
+static void add_entry(const u8 *hdr, const u8 *payload, unsigned len)
+{
+    if (used + TRACE_ENTRY_HEADER + len > TRACE_BLOCK_SIZE)
+        next_block();
+    memcpy(block + used, hdr, TRACE_ENTRY_HEADER);
+    memcpy(block + used + TRACE_ENTRY_HEADER, payload, len);
+    used += TRACE_ENTRY_HEADER + len;
+}
+
+static void add_local_entry(enum TraceType type, const u8 *payload, unsigned len)
+{
+    u16 us = CLOCK_getus();
+    u32 ms = CLOCK_getms();
+    u8 hdr[TRACE_ENTRY_HEADER] = {type, len, us & 0xff, us >> 8,
+                                  ms & 0xff, (ms >> 8) & 0xff, (ms >> 16) & 0xff, ms >> 24};
+    add_entry(hdr, payload, len);
+}
+
+static void drain(struct TraceRing *r)
+{
+    u8 entry[TRACE_ENTRY_HEADER + 1 + MAX_PACKET];
+    u16 tail = r->tail;
+    u16 head = r->head;
+    COMPILER_BARRIER();  // Read the entries only after head
+    while (tail != head && enabled) {
+        unsigned size = TRACE_ENTRY_HEADER + r->data[(tail + 1) & RING_MASK];
+        for (unsigned i = 0; i < size; i++)
+            entry[i] = r->data[(tail + i) & RING_MASK];
+        add_entry(entry, entry + TRACE_ENTRY_HEADER, size - TRACE_ENTRY_HEADER);
+        tail = (tail + size) & RING_MASK;
+    }
+    COMPILER_BARRIER();  // Finish reading before the space is released
+    r->tail = enabled ? tail : head;
+    u16 dropped = enabled ? ISR_CounterTake(&r->dropped) : 0;
+    if (dropped) {
+        u8 data[2] = {dropped & 0xff, dropped >> 8};
+        add_local_entry(TRACE_DROPPED, data, sizeof(data));
+    }
+}
+
+void TRACE_Update()
+{
+    if (! enabled)
+        return;
+    for (int i = 0; i < TRACE_SRC_LAST; i++)
+        drain(&rings[i]);
+    u32 now = CLOCK_getms();
+    if (enabled && (s32)(now - next_flush) >= 0) {
+        next_flush = now + FLUSH_MS;
+        write_block();
+    }
+}
+
+void TRACE_Init()
+{
+    enabled = 0;
+    memset(rings, 0, sizeof(rings));
+    if (! fh) {
+        finit(&TraceFAT, "");
+        fh = fopen2(&TraceFAT, "trace.bin", "r+");
+        if (! fh)
+            return;
+        setbuf(fh, 0);
+    }
+    fseek(fh, 0, SEEK_END);
+    file_size = ftell(fh);
+    if (file_size < TRACE_BLOCK_SIZE)
+        return;
+    //Start a new session so the decoder ignores blocks left from the last one
+    fseek(fh, 0, SEEK_SET);
+    u8 last[2] = {0, 0};
+    fread(last, 2, 1, fh);
+    session = (last[0] | (last[1] << 8)) + 1;
+    if (session == 0)
+        session = 1;
+    block_pos = 0;
+    memset(block, 0, sizeof(block));
+    block[0] = session & 0xff;
+    block[1] = session >> 8;
+    used = 4;
+    u8 start[4] = {TRACE_VERSION, TXID, Model.protocol, Model.num_channels};
+    add_local_entry(TRACE_START, start, sizeof(start));
+    write_block();
+    next_flush = CLOCK_getms() + FLUSH_MS;
+    enabled = 1;
+}
+
+#define TESTNAME trace
+#include <tests.h>
+#endif //SUPPORT_TRACE
@@ -0,0 +1,48 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+/* High-rate binary trace
+ * Every channel update from MIXER_CalcChannels and every RF packet sent or
+ * read by the radio drivers is time-stamped and queued into a per-interrupt
+ * ring buffer.  The main loop (TRACE_Update) packs the entries into blocks
+ * which are written sequentially to trace.bin.  The file must already exist
+ * and is filled from the start on every power-up.  Use utils/trace2csv.py to
+ * decode it.
+ *
+ * File layout (little-endian):
+ *   Every block is TRACE_BLOCK_SIZE bytes and starts with
+ *     u16 session, u16 used bytes
+ *   The first entry of a session is TRACE_START.  Each entry is
+ *     u8 type, u8 length, u16 us (free running), u32 ms, <length> bytes
+ *   The decoder stops at the first block from a different session.
+ */
+#define TRACE_VERSION    0x01
+#define TRACE_BLOCK_SIZE 512
+#define TRACE_ENTRY_HEADER 8
+
+enum TraceType {
+    TRACE_START = 1,    // u8 version, u8 txid, u8 protocol, u8 num_channels
+    TRACE_CHANNELS,     // u8 num_channels, s16 per channel
+    TRACE_TX,           // u8 module, packet
+    TRACE_RX,           // u8 module, packet
+    TRACE_DROPPED,      // u16 entries lost because a ring was full
+};
+
+enum TraceSrc {
+    TRACE_SRC_MIXER,    // medium priority mixer calculation
+    TRACE_SRC_PROTOCOL, // SYSCLK timer callback
+    TRACE_SRC_LAST,
+};
+
+#if SUPPORT_TRACE
+void TRACE_Channels();
+void TRACE_Packet(enum TraceType type, u8 module, const u8 *data, u8 len);
+#else
+#define TRACE_Channels()
+#define TRACE_Packet(type, module, data, len)
+#endif
+
+void TRACE_Init();
+void TRACE_Update();
+
+#endif //_TRACE_H_
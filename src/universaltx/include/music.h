@@ -1,4 +1,5 @@
 #include "../../music.h"
 #define MUSIC_Play(x)
 #define MUSIC_Beep(w,x,y,z)
+#define MUSIC_ReloadSounds()
 
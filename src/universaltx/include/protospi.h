@@ -7,6 +7,8 @@
 
 u8 PROTOSPI_read3wire();
 uint8_t spi_xfer8(uint32_t spi, uint8_t data);
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void));
+#define PROTOSPI_wait() if (0) {}
 
 #define spi_xfer             DO_NOT_USE
 #define PROTOSPI_pin_set     PORT_pin_set
@@ -61,6 +61,17 @@ u8 PROTOSPI_read3wire(){
     return data;
 }
 
+void PROTOSPI_xfer_block(const u8 *tx, u8 *rx, unsigned len, void (*done_cb)(void))
+{
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = PROTOSPI_xfer(tx ? tx[i] : 0);
+        if (rx)
+            rx[i] = data;
+    }
+    if (done_cb)
+        done_cb();
+}
+
 void exti4_15_isr(void)
 {
     if (exti_get_flag_status(PASSTHRU_CSN.pin)) {
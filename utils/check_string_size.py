@@ -7,6 +7,7 @@ import sys
 import subprocess
 import glob
 import re
+import struct
 from functools import total_ordering
 
 
@@ -98,9 +99,13 @@ def read_target(target_dir, objdir):
     target_max_line_length = MaxVal()
     log("Directory: " + target_dir)
     for filename in sorted(langfiles):
-        lines = open(filename, "r", encoding='utf-8').read().splitlines()
-        lines.pop(0)
-        _bytes, line_count, max_line_length = parse_v1_file(lines)
+        data = open(filename, "rb").read()
+        data = data[data.find(b'\n') + 1:]
+        if data[:1] == b'\0':
+            _bytes, line_count, max_line_length = parse_v3_file(data)
+        else:
+            _bytes, line_count, max_line_length = parse_v1_file(
+                data.decode('utf-8').splitlines())
         log("{:35}: {:5d} lines, {:5d} bytes, {:4d} bytes/line"
             .format(filename, line_count, _bytes, max_line_length))
         target_bytes.update(_bytes)
@@ -144,6 +149,21 @@ def parse_v1_file(lines):
     return (_bytes, line_count, max_line_length)
 
 
+def parse_v3_file(data):
+    """Parse packed language file (after the language name)"""
+    count = struct.unpack_from("<H", data, 2)[0]
+    table = [struct.unpack_from("<HH", data, 4 + 4 * i) for i in range(count)]
+    hashes = [_h for _h, _pos in table]
+    if len(set(hashes)) != len(hashes):
+        print("Found hash collision in packed language file")
+        set_error()
+    strings = data[4 + 4 * count:]
+    max_line_length = MaxVal()
+    for string in strings.split(b'\0')[:-1]:
+        max_line_length.update(len(string) + 1)    # Include the NULL terminator
+    return (len(strings), count, max_line_length)
+
+
 def get_language(target):
     """Get language values from Makefile"""
     path = glob.glob(os.path.join("target", "tx", "*", target, "Makefile.inc"))[0]
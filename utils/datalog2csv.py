@@ -1,7 +1,9 @@
 #!/usr/bin/env python3
 
 import os
+import struct
 import sys
+import zlib
 from optparse import OptionParser
 
 class Capture(object):
@@ -116,6 +118,12 @@ class Capture(object):
             self.rate = "30 sec"
         elif value == 4:
             self.rate = "1 min"
+        elif value == 5:
+            self.rate = "100 msec"
+        elif value == 6:
+            self.rate = "250 msec"
+        elif value == 7:
+            self.rate = "500 msec"
     def get_size(self, idx):
         if idx < self.INPUT:
             return 2
@@ -268,8 +276,34 @@ def main():
     else:
         for o in out:
             printf("%s", o)
+# Version 6 files end with two copies of an index holding the end of the data
+# and the start of the latest sessions.  Returns (end, sessions) from the newest
+# valid copy, or None for older files
+INDEX_MAGIC = 0x49474c44
+INDEX_SESSIONS = 11
+INDEX_FORMAT = "<IIIHBB%dII" % INDEX_SESSIONS
+INDEX_LEN = struct.calcsize(INDEX_FORMAT)
+def read_index(data):
+    best = None
+    for i in range(2):
+        pos = len(data) - 2 * INDEX_LEN + i * INDEX_LEN
+        if pos < 0:
+            return None
+        fields = struct.unpack_from(INDEX_FORMAT, data, pos)
+        if fields[0] != INDEX_MAGIC or fields[-1] != zlib.crc32(data[pos:pos+INDEX_LEN-4]) & 0xffffffff:
+            continue
+        if best is None or ((fields[1] - best[1]) & 0xffffffff) < 0x80000000:
+            best = fields
+    if best is None:
+        return None
+    count = min(best[3], INDEX_SESSIONS)
+    return (best[2], list(best[6:6+count]))
+
 def parse_file(bin):
     data = open(bin,'rb').read()
+    index = read_index(data)
+    if index:
+        data = data[:index[0]]
     idx = 0
     size = 1
     info = []
@@ -280,7 +314,7 @@ def parse_file(bin):
             info[-1].add_elem(data[idx+1:])
             idx += info[-1].capture_size+1
             continue
-        if data[idx] != 0x03:
+        if data[idx] < 0x03 or data[idx] > 0x06:
             printf("Cannot handle API version 0x%02x\n", data[idx])
             return info
         info.append(Capture(data[idx:]))
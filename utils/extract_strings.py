@@ -10,6 +10,7 @@ import re
 import subprocess
 import logging
 import glob
+import struct
 
 PO_LANGUAGE_STRING = "->Translated Language Name<-"
 TARGETS = ["devo8", "devo10", "devo12"]
@@ -31,6 +32,8 @@ def main():
                         help="Generate count of unique srings")
     parser.add_argument("-po", action="store_true",
                         help="Read po files rather than devo-formatted files")
+    parser.add_argument("-packed", action="store_true",
+                        help="Write packed (version 3) language files")
     parser.add_argument("-objdir",
                         help="Directory containing .o files to extract strings from")
     args = parser.parse_args()
@@ -56,7 +59,7 @@ def main():
     for filename in files:
         (ext, language, translation) = parse_po_file(filename, uniq)
         if not write_lang_file("{}/lang.{}".format(args.fs, ext),
-                               args.targets, language, translation):
+                               args.targets, language, translation, args.packed):
             return False
     return True
 
@@ -168,7 +171,34 @@ def fnv_16(data, init_value=0x811c9dc5):
     return (hval >> 16) ^ (hval & 0xffff)
 
 
-def write_lang_file(outf, targets, language, translation):
+def unescape(string):
+    """Decode '\\n' and '\\t' the same way the firmware does for text files"""
+    return re.sub(r'\\([nt])', lambda _m: '\n' if _m.group(1) == 'n' else '\t', string)
+
+
+def pack_lang(language, strings):
+    """Build a version 3 language file:
+         <language name>\n
+         u8 0, u8 3, u16 count
+         count * {u16 hash, u16 offset}, sorted by hash
+         NUL terminated strings
+    """
+    entries = sorted((fnv_16(unescape(key)), unescape(value).encode('utf-8') + b'\0')
+                     for key, value in strings.items() if key != value)
+    header = language.rstrip('\n').encode('utf-8') + b'\n'
+    offset = len(header) + 4 + 4 * len(entries)
+    table = b''
+    data = b''
+    for hval, value in entries:
+        if offset + len(data) > 0xffff:
+            logging.error("Language file is too large to pack")
+            return None
+        table += struct.pack("<HH", hval, offset + len(data))
+        data += value
+    return header + struct.pack("<BBH", 0, 3, len(entries)) + table + data
+
+
+def write_lang_file(outf, targets, language, translation, packed=False):
     """Write Deviation lang file for selected language"""
     strings = {}
     hashvalues = {}
@@ -187,6 +217,17 @@ def write_lang_file(outf, targets, language, translation):
                           hashvalues[hval], value)
             return False
         hashvalues[hval] = value
+    if packed:
+        data = pack_lang(language, strings)
+        if data is None:
+            return False
+        try:
+            with open(outf, "wb") as _fh:
+                _fh.write(data)
+        except OSError:
+            logging.error("Can't write %s", outf)
+            return False
+        return True
     try:
         with open(outf, "wb") as _fh:
             _fh.write(language.encode('utf-8'))
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+# Decode trace.bin written by src/trace.c
+# Each output line holds the time in us, the entry type and its data:
+#   <us>,CHANNELS,<ch1>,<ch2>,...
+#   <us>,TX,<module>,<hex bytes>
+#   <us>,RX,<module>,<hex bytes>
+#   <us>,DROPPED,<count>
+# --stats prints the TX packet interval and the latency from each channel
+# update to the next TX packet instead
+
+import struct
+import sys
+from optparse import OptionParser
+
+TRACE_VERSION = 0x01
+BLOCK_SIZE = 512
+ENTRY_HEADER = 8
+
+TRACE_START, TRACE_CHANNELS, TRACE_TX, TRACE_RX, TRACE_DROPPED = range(1, 6)
+MODULES = ["CYRF6936", "A7105", "CC2500", "NRF24L01", "MultiMod", "R9M"]
+
+def printf(format, *args):
+    sys.stdout.write(format % args)
+
+class Timebase(object):
+    # Entries hold the 16bit free-running us timer and the ms tick, which are
+    # not synchronized.  The us timer is unwrapped to the value nearest to the
+    # ms tick, after removing the offset seen on the first entry
+    def __init__(self):
+        self.offset = None
+    def us(self, us16, ms):
+        if self.offset is None:
+            self.offset = (us16 - ms * 1000) & 0xffff
+        diff = (us16 - self.offset - ms * 1000) & 0xffff
+        if diff >= 0x8000:
+            diff -= 0x10000
+        return ms * 1000 + diff
+
+def parse_file(bin):
+    data = open(bin, 'rb').read()
+    entries = []
+    session = None
+    timebase = Timebase()
+    for pos in range(0, len(data) - BLOCK_SIZE + 1, BLOCK_SIZE):
+        (block_session, used) = struct.unpack_from("<HH", data, pos)
+        if session is None:
+            session = block_session
+        elif block_session != session or used == 0:
+            break
+        idx = pos + 4
+        while idx + ENTRY_HEADER <= pos + used:
+            (type, length, us16, ms) = struct.unpack_from("<BBHI", data, idx)
+            payload = data[idx + ENTRY_HEADER:idx + ENTRY_HEADER + length]
+            idx += ENTRY_HEADER + length
+            if type == TRACE_START:
+                if payload[0] != TRACE_VERSION:
+                    printf("Cannot handle trace version 0x%02x\n", payload[0])
+                    return []
+                continue
+            entries.append((timebase.us(us16, ms), type, payload))
+    # Each interrupt has its own ring, so entries are only ordered per source
+    entries.sort(key=lambda e: e[0])
+    return entries
+
+def format_entry(entry):
+    (us, type, payload) = entry
+    if type == TRACE_CHANNELS:
+        values = struct.unpack_from("<%dh" % payload[0], payload, 1)
+        return "%d,CHANNELS,%s\n" % (us, ",".join(str(x) for x in values))
+    if type in (TRACE_TX, TRACE_RX):
+        module = MODULES[payload[0]] if payload[0] < len(MODULES) else str(payload[0])
+        return "%d,%s,%s,%s\n" % (us, "TX" if type == TRACE_TX else "RX", module,
+                                  " ".join("%02x" % x for x in payload[1:]))
+    if type == TRACE_DROPPED:
+        return "%d,DROPPED,%d\n" % (us, struct.unpack_from("<H", payload)[0])
+    return "%d,UNKNOWN%d\n" % (us, type)
+
+def summary(name, values):
+    if not values:
+        printf("%-16s no samples\n", name)
+        return
+    values = sorted(values)
+    avg = sum(values) / len(values)
+    p99 = values[min(len(values) - 1, len(values) * 99 // 100)]
+    printf("%-16s count=%d min=%d avg=%.1f max=%d p99=%d (us)\n",
+           name, len(values), values[0], avg, values[-1], p99)
+
+def print_stats(entries):
+    interval = []
+    latency = []
+    last_tx = None
+    pending = None
+    for (us, type, payload) in entries:
+        if type == TRACE_CHANNELS and pending is None:
+            pending = us
+        elif type == TRACE_TX:
+            if last_tx is not None:
+                interval.append(us - last_tx)
+            last_tx = us
+            if pending is not None:
+                latency.append(us - pending)
+                pending = None
+    summary("TX interval", interval)
+    summary("Mixer to TX", latency)
+
+def main():
+    usage = """
+%prog [-b|--bin <bin-file>] [opts]
+"""
+    parser = OptionParser(usage=usage)
+    parser.add_option("-b", "--bin", action="store", dest="bin",
+                      help="input file to read")
+    parser.add_option("-o", "--out", action="store", dest="out",
+                      help="output file")
+    parser.add_option("-s", "--stats", action="store_true", dest="stats", default=False,
+                      help="print packet interval and latency statistics")
+    (opt, args) = parser.parse_args()
+    if not opt.bin:
+        print("Must specify --bin")
+        return
+    entries = parse_file(opt.bin)
+    if opt.stats:
+        print_stats(entries)
+        return
+    out = [format_entry(e) for e in entries]
+    if opt.out:
+        with open(opt.out, 'w') as of:
+            for o in out:
+                of.write(o)
+        return
+    for o in out:
+        printf("%s", o)
+
+main()